@@ -0,0 +1,63 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_ASSETID_HPP
+#define OUZEL_ASSETS_ASSETID_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include "../hash/Fnv1.hpp"
+
+namespace ouzel::assets
+{
+    // Hashed asset name, can be computed at compile time for names used in hot code
+    class AssetId final
+    {
+    public:
+        constexpr AssetId(const std::string_view name) noexcept:
+            value{hash::fnv1::hashString<std::uint64_t>(name)}
+        {
+        }
+
+        constexpr AssetId(const char* name) noexcept:
+            AssetId{std::string_view{name}}
+        {
+        }
+
+        AssetId(const std::string& name) noexcept:
+            AssetId{std::string_view{name}}
+        {
+        }
+
+        constexpr auto getValue() const noexcept { return value; }
+
+        constexpr bool operator==(const AssetId& other) const noexcept
+        {
+            return value == other.value;
+        }
+
+        constexpr bool operator!=(const AssetId& other) const noexcept
+        {
+            return value != other.value;
+        }
+
+    private:
+        std::uint64_t value;
+    };
+}
+
+namespace std
+{
+    template <>
+    struct hash<ouzel::assets::AssetId> final
+    {
+        std::size_t operator()(const ouzel::assets::AssetId& id) const noexcept
+        {
+            // the value is already a hash
+            return static_cast<std::size_t>(id.getValue());
+        }
+    };
+}
+
+#endif // OUZEL_ASSETS_ASSETID_HPP
@@ -11,7 +11,7 @@ namespace ouzel::assets
     inline bool loadBmf(Cache&,
                         Bundle& bundle,
                         const std::string& name,
-                        const std::vector<std::byte>& data,
+                        Span<const std::byte> data,
                         const Asset::Options&)
     {
         try
@@ -1,13 +1,101 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
 #include <cctype>
+#include <deque>
+#include <exception>
+#include <optional>
 #include <stdexcept>
 #include "Bundle.hpp"
 #include "Cache.hpp"
+#include "../core/Engine.hpp"
 #include "../formats/Json.hpp"
+#include "../utils/Log.hpp"
 
 namespace ouzel::assets
 {
+    class Bundle::AsyncLoad final
+    {
+    public:
+        struct Item final
+        {
+            explicit Item(const Asset& initAsset):
+                asset{initAsset}
+            {
+            }
+
+            Asset asset;
+            std::vector<Decoder> decoders;
+            std::shared_ptr<const storage::MappedFile> file;
+            AssetPublisher publisher;
+            std::exception_ptr exception;
+            std::atomic_bool ready{false};
+        };
+
+        AsyncLoad(Bundle& initBundle,
+                  const std::vector<Asset>& assets,
+                  const std::function<void()>& initCallback):
+            bundle{&initBundle},
+            progress{std::make_shared<LoadProgress::State>(assets.size())},
+            callback{initCallback}
+        {
+            for (const auto& asset : assets)
+                items.emplace_back(asset);
+        }
+
+        Bundle* bundle; // null after the bundle is destroyed
+        std::shared_ptr<LoadProgress::State> progress;
+        std::function<void()> callback;
+        std::deque<Item> items; // the items are never moved, because the workers hold references to them
+        std::size_t nextItem = 0; // index of the next item to publish
+    };
+
+    namespace
+    {
+        std::vector<Asset> parseAssets(const std::vector<std::byte>& manifest)
+        {
+            // the manifest is streamed straight into the asset list
+            json::Reader reader{manifest};
+
+            std::vector<Asset> assets;
+            bool hasAssets = false;
+
+            reader.readObject([&reader, &assets, &hasAssets](std::string_view key) {
+                if (key != "assets") return reader.skip();
+
+                hasAssets = true;
+
+                reader.readArray([&reader, &assets]() {
+                    std::string file;
+                    std::optional<std::string> name;
+                    std::optional<std::uint32_t> type;
+                    Asset::Options options;
+                    options.mipmaps = true;
+
+                    reader.readObject([&](std::string_view member) {
+                        if (member == "filename") file = reader.readString();
+                        else if (member == "name") name = reader.readString();
+                        else if (member == "type") type = reader.readNumber<std::uint32_t>();
+                        else if (member == "mipmaps") options.mipmaps = reader.readBoolean();
+                        else reader.skip();
+                    });
+
+                    if (file.empty() || !type)
+                        throw std::runtime_error{"Asset must have a filename and a type"};
+
+                    assets.emplace_back(static_cast<Asset::Type>(*type), name ? *name : file, file, options);
+                });
+            });
+
+            reader.readEnd();
+
+            if (!hasAssets)
+                throw std::runtime_error{"Manifest has no assets"};
+
+            return assets;
+        }
+    }
+
     Bundle::Bundle(Cache& initCache, storage::FileSystem& initFileSystem):
         cache{initCache}, fileSystem{initFileSystem}
     {
@@ -16,6 +104,10 @@ namespace ouzel::assets
 
     Bundle::~Bundle()
     {
+        // the workers may still be decoding, but nothing is published to this bundle anymore
+        for (const auto& asyncLoad : asyncLoads)
+            asyncLoad->bundle = nullptr;
+
         cache.removeBundle(this);
     }
 
@@ -23,8 +115,35 @@ namespace ouzel::assets
                            const std::string& filename,
                            const Asset::Options& options)
     {
-        const auto data = fileSystem.readFile(filename);
+        // the loaders read the mapped file directly, so the file is not copied to the memory
+        const auto file = std::make_shared<const storage::MappedFile>(fileSystem.mapFile(filename));
+        loadAssetFile(assetType, name, filename, file, options);
+    }
+
+    void Bundle::loadAssetFile(Asset::Type assetType, const std::string& name,
+                               const std::string& filename,
+                               const std::shared_ptr<const storage::MappedFile>& file,
+                               const Asset::Options& options)
+    {
+        loadingFiles.push_back({filename, file});
+
+        try
+        {
+            loadAssetData(assetType, name, filename, Span<const std::byte>{file->getData(), file->getSize()}, options);
+        }
+        catch (...)
+        {
+            loadingFiles.pop_back();
+            throw;
+        }
 
+        loadingFiles.pop_back();
+    }
+
+    void Bundle::loadAssetData(Asset::Type assetType, const std::string& name,
+                               const std::string& filename, Span<const std::byte> data,
+                               const Asset::Options& options)
+    {
         const auto& loaders = cache.getLoaders();
 
         for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
@@ -37,23 +156,140 @@ namespace ouzel::assets
 
     void Bundle::loadAssets(const std::string& filename)
     {
-        const auto data = json::parse(fileSystem.readFile(filename));
+        loadAssets(parseAssets(fileSystem.readFile(filename)));
+    }
+
+    void Bundle::loadAssets(const std::vector<Asset>& assets)
+    {
+        for (const auto& asset : assets)
+            loadAsset(asset.type, asset.name, asset.filename, asset.options);
+    }
+
+    LoadProgress Bundle::loadAssetsAsync(const std::string& filename,
+                                         const std::function<void()>& callback)
+    {
+        return loadAssetsAsync(parseAssets(fileSystem.readFile(filename)), callback);
+    }
+
+    LoadProgress Bundle::loadAssetsAsync(const std::vector<Asset>& assets,
+                                         const std::function<void()>& callback)
+    {
+        const auto asyncLoad = std::make_shared<AsyncLoad>(*this, assets, callback);
+        LoadProgress result{asyncLoad->progress};
 
-        for (const auto& asset : data["assets"])
+        if (assets.empty())
         {
-            const auto& file = asset["filename"].as<std::string>();
-            const auto& name = asset.hasMember("name") ? asset["name"].as<std::string>() : file;
+            if (callback) callback();
+            return result;
+        }
+
+        asyncLoads.push_back(asyncLoad);
+
+        const auto& loaders = cache.getLoaders();
+        core::TaskGroup taskGroup;
 
-            Asset::Options options;
-            options.mipmaps = asset.hasMember("mipmaps") ? asset["mipmaps"].as<bool>() : true;
-            loadAsset(static_cast<Asset::Type>(asset["type"].as<std::uint32_t>()), name, file, options);
+        for (auto& item : asyncLoad->items)
+        {
+            // the decoders are looked up here, because the cache must not be accessed from the workers,
+            // the loaders are tried in the same order as on the update thread, so the first loader
+            // without a decoder leaves the asset to the loaders
+            for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+                if (i->first == item.asset.type)
+                {
+                    const auto decoder = cache.getDecoder(i->second);
+                    if (!decoder) break;
+                    item.decoders.push_back(decoder);
+                }
+
+            taskGroup.add([asyncLoad, &item, &itemFileSystem = fileSystem]() {
+                try
+                {
+                    item.file = std::make_shared<const storage::MappedFile>(itemFileSystem.mapFile(item.asset.filename));
+                    const Span<const std::byte> data{item.file->getData(), item.file->getSize()};
+
+                    for (const auto decoder : item.decoders)
+                    {
+                        item.publisher = decoder(item.asset.name, data, item.asset.options);
+                        if (item.publisher)
+                        {
+                            item.file = nullptr; // not needed anymore
+                            break;
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    item.exception = std::current_exception();
+                }
+
+                item.ready.store(true, std::memory_order_release);
+
+                engine->executeOnUpdateThread([asyncLoad]() {
+                    if (asyncLoad->bundle) asyncLoad->bundle->publishAssets(*asyncLoad);
+                });
+            });
         }
+
+        engine->getWorkerPool().run(std::move(taskGroup));
+
+        return result;
     }
 
-    void Bundle::loadAssets(const std::vector<Asset>& assets)
+    void Bundle::publishAssets(AsyncLoad& asyncLoad)
     {
-        for (const auto& asset : assets)
-            loadAsset(asset.type, asset.name, asset.filename, asset.options);
+        // the assets are published in order, so that the assets can depend on the previous ones
+        while (asyncLoad.nextItem < asyncLoad.items.size())
+        {
+            auto& item = asyncLoad.items[asyncLoad.nextItem];
+            if (!item.ready.load(std::memory_order_acquire)) return;
+
+            try
+            {
+                if (item.exception)
+                    std::rethrow_exception(item.exception);
+                else if (item.publisher)
+                    item.publisher(cache, *this);
+                else
+                    loadAssetFile(item.asset.type, item.asset.name, item.asset.filename,
+                                  item.file, item.asset.options);
+            }
+            catch (const std::exception& e)
+            {
+                log(Log::Level::error) << "Failed to load asset " << item.asset.filename << ": " << e.what();
+                ++asyncLoad.progress->failedCount;
+            }
+
+            item.file = nullptr;
+            item.publisher = nullptr;
+            ++asyncLoad.nextItem;
+            ++asyncLoad.progress->loadedCount;
+        }
+
+        const auto i = std::find_if(asyncLoads.begin(), asyncLoads.end(),
+                                    [&asyncLoad](const auto& load) noexcept { return load.get() == &asyncLoad; });
+        if (i == asyncLoads.end()) return;
+
+        const auto callback = std::move(asyncLoad.callback);
+        asyncLoads.erase(i); // may destroy the async load
+        if (callback) callback();
+    }
+
+    std::shared_ptr<const storage::MappedFile> Bundle::retainData(Span<const std::byte> data) const
+    {
+        for (const auto& loadingFile : loadingFiles)
+            if (const auto& file = loadingFile.file;
+                data.data() >= file->getData() &&
+                data.data() + data.size() <= file->getData() + file->getSize())
+                return std::make_shared<const storage::MappedFile>(file,
+                                                                    static_cast<std::size_t>(data.data() - file->getData()),
+                                                                    data.size());
+
+        return std::make_shared<const storage::MappedFile>(std::vector<std::byte>(data.begin(), data.end()));
+    }
+
+    std::string Bundle::getLoadingFilename() const
+    {
+        return loadingFiles.empty() ? std::string{} : loadingFiles.back().filename;
     }
 
     std::shared_ptr<graphics::Texture> Bundle::getTexture(std::string_view name) const
@@ -71,11 +307,14 @@ namespace ouzel::assets
             textures.insert(std::make_pair(name, texture));
         else
             i->second = texture;
+
+        cache.textures.update(name, cache.bundles);
     }
 
     void Bundle::releaseTextures()
     {
         textures.clear();
+        cache.textures.invalidate();
     }
 
     const graphics::Shader* Bundle::getShader(std::string_view name) const
@@ -93,11 +332,14 @@ namespace ouzel::assets
             shaders.insert(std::make_pair(name, std::move(shader)));
         else
             i->second = std::move(shader);
+
+        cache.shaders.update(name, cache.bundles);
     }
 
     void Bundle::releaseShaders()
     {
         shaders.clear();
+        cache.shaders.invalidate();
     }
 
     const graphics::BlendState* Bundle::getBlendState(std::string_view name) const
@@ -115,11 +357,14 @@ namespace ouzel::assets
             blendStates.insert(std::make_pair(name, std::move(blendState)));
         else
             i->second = std::move(blendState);
+
+        cache.blendStates.update(name, cache.bundles);
     }
 
     void Bundle::releaseBlendStates()
     {
         blendStates.clear();
+        cache.blendStates.invalidate();
     }
 
     const graphics::DepthStencilState* Bundle::getDepthStencilState(std::string_view name) const
@@ -137,11 +382,14 @@ namespace ouzel::assets
             depthStencilStates.insert(std::make_pair(name, std::move(depthStencilState)));
         else
             i->second = std::move(depthStencilState);
+
+        cache.depthStencilStates.update(name, cache.bundles);
     }
 
     void Bundle::releaseDepthStencilStates()
     {
         depthStencilStates.clear();
+        cache.depthStencilStates.invalidate();
     }
 
     const scene::SpriteData* Bundle::getSpriteData(std::string_view name) const
@@ -159,11 +407,14 @@ namespace ouzel::assets
             spriteData.insert(std::make_pair(name, newSpriteData));
         else
             i->second = newSpriteData;
+
+        cache.spriteData.update(name, cache.bundles);
     }
 
     void Bundle::releaseSpriteData()
     {
         spriteData.clear();
+        cache.spriteData.invalidate();
     }
 
     const scene::ParticleSystemData* Bundle::getParticleSystemData(std::string_view name) const
@@ -181,11 +432,14 @@ namespace ouzel::assets
             particleSystemData.insert(std::make_pair(name, newParticleSystemData));
         else
             i->second = newParticleSystemData;
+
+        cache.particleSystemData.update(name, cache.bundles);
     }
 
     void Bundle::releaseParticleSystemData()
     {
         particleSystemData.clear();
+        cache.particleSystemData.invalidate();
     }
 
     const gui::Font* Bundle::getFont(std::string_view name) const
@@ -203,11 +457,14 @@ namespace ouzel::assets
             fonts.insert(std::make_pair(name, std::move(font)));
         else
             i->second = std::move(font);
+
+        cache.fonts.update(name, cache.bundles);
     }
 
     void Bundle::releaseFonts()
     {
         fonts.clear();
+        cache.fonts.invalidate();
     }
 
     const audio::Cue* Bundle::getCue(std::string_view name) const
@@ -225,11 +482,14 @@ namespace ouzel::assets
             cues.insert(std::make_pair(name, std::move(cue)));
         else
             i->second = std::move(cue);
+
+        cache.cues.update(name, cache.bundles);
     }
 
     void Bundle::releaseCues()
     {
         cues.clear();
+        cache.cues.invalidate();
     }
 
     const audio::Sound* Bundle::getSound(std::string_view name) const
@@ -247,11 +507,14 @@ namespace ouzel::assets
             sounds.insert(std::make_pair(name, std::move(sound)));
         else
             i->second = std::move(sound);
+
+        cache.sounds.update(name, cache.bundles);
     }
 
     void Bundle::releaseSounds()
     {
         sounds.clear();
+        cache.sounds.invalidate();
     }
 
     const graphics::Material* Bundle::getMaterial(std::string_view name) const
@@ -269,11 +532,14 @@ namespace ouzel::assets
             materials.insert(std::make_pair(name, std::move(material)));
         else
             i->second = std::move(material);
+
+        cache.materials.update(name, cache.bundles);
     }
 
     void Bundle::releaseMaterials()
     {
         materials.clear();
+        cache.materials.invalidate();
     }
 
     const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(std::string_view name) const
@@ -291,11 +557,14 @@ namespace ouzel::assets
             skinnedMeshData.insert(std::make_pair(name, std::move(newSkinnedMeshData)));
         else
             i->second = std::move(newSkinnedMeshData);
+
+        cache.skinnedMeshData.update(name, cache.bundles);
     }
 
     void Bundle::releaseSkinnedMeshData()
     {
         skinnedMeshData.clear();
+        cache.skinnedMeshData.invalidate();
     }
 
     const scene::StaticMeshData* Bundle::getStaticMeshData(std::string_view name) const
@@ -313,10 +582,13 @@ namespace ouzel::assets
             staticMeshData.insert(std::make_pair(name, std::move(newStaticMeshData)));
         else
             i->second = std::move(newStaticMeshData);
+
+        cache.staticMeshData.update(name, cache.bundles);
     }
 
     void Bundle::releaseStaticMeshData()
     {
         staticMeshData.clear();
+        cache.staticMeshData.invalidate();
     }
 }
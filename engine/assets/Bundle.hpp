@@ -3,11 +3,13 @@
 #ifndef OUZEL_ASSETS_BUNDLE_HPP
 #define OUZEL_ASSETS_BUNDLE_HPP
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 #include "Asset.hpp"
 #include "../audio/Cue.hpp"
 #include "../audio/Sound.hpp"
@@ -22,11 +24,44 @@
 #include "../scene/SpriteRenderer.hpp"
 #include "../scene/ParticleSystem.hpp"
 #include "../storage/FileSystem.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::assets
 {
+    class Bundle;
     class Cache;
 
+    // Progress of an asynchronous asset load, updated on the update thread
+    class LoadProgress final
+    {
+        friend Bundle;
+    public:
+        auto getAssetCount() const noexcept { return state->assetCount; }
+        auto getLoadedCount() const noexcept { return state->loadedCount.load(std::memory_order_acquire); }
+        auto getFailedCount() const noexcept { return state->failedCount.load(std::memory_order_acquire); }
+        bool isFinished() const noexcept { return getLoadedCount() == getAssetCount(); }
+
+    private:
+        struct State final
+        {
+            explicit State(std::size_t initAssetCount) noexcept:
+                assetCount{initAssetCount}
+            {
+            }
+
+            const std::size_t assetCount;
+            std::atomic<std::size_t> loadedCount{0};
+            std::atomic<std::size_t> failedCount{0};
+        };
+
+        explicit LoadProgress(std::shared_ptr<const State> initState) noexcept:
+            state{std::move(initState)}
+        {
+        }
+
+        std::shared_ptr<const State> state;
+    };
+
     class Bundle final
     {
         friend Cache;
@@ -45,6 +80,20 @@ namespace ouzel::assets
         void loadAssets(const std::string& filename);
         void loadAssets(const std::vector<Asset>& assets);
 
+        // reads and decodes the assets on the worker pool and adds them to the bundle on the update thread
+        // in the given order, the callback is called on the update thread after the last asset is added
+        LoadProgress loadAssetsAsync(const std::string& filename,
+                                     const std::function<void()>& callback = nullptr);
+        LoadProgress loadAssetsAsync(const std::vector<Asset>& assets,
+                                     const std::function<void()>& callback = nullptr);
+
+        // returns an owner that keeps the data passed to a loader alive after the loader returns,
+        // the data of the file that is being loaded is shared instead of copied
+        std::shared_ptr<const storage::MappedFile> retainData(Span<const std::byte> data) const;
+
+        // filename of the asset that is being loaded, so that the loaders can resolve paths relative to it
+        std::string getLoadingFilename() const;
+
         std::shared_ptr<graphics::Texture> getTexture(std::string_view name) const;
         void setTexture(std::string_view name, const std::shared_ptr<graphics::Texture>& texture);
         void releaseTextures();
@@ -94,8 +143,27 @@ namespace ouzel::assets
         void releaseStaticMeshData();
 
     private:
+        class AsyncLoad;
+
+        struct LoadingFile final
+        {
+            std::string filename;
+            std::shared_ptr<const storage::MappedFile> file;
+        };
+
+        void loadAssetData(Asset::Type assetType, const std::string& name,
+                           const std::string& filename, Span<const std::byte> data,
+                           const Asset::Options& options);
+        void loadAssetFile(Asset::Type assetType, const std::string& name,
+                           const std::string& filename,
+                           const std::shared_ptr<const storage::MappedFile>& file,
+                           const Asset::Options& options);
+        void publishAssets(AsyncLoad& asyncLoad);
+
         Cache& cache;
         storage::FileSystem& fileSystem;
+        std::vector<std::shared_ptr<AsyncLoad>> asyncLoads;
+        std::vector<LoadingFile> loadingFiles; // loaders can load other assets
 
         std::map<std::string, std::shared_ptr<graphics::Texture>, std::less<>> textures;
         std::map<std::string, std::unique_ptr<graphics::Shader>, std::less<>> shaders;
@@ -12,6 +12,8 @@
 #include "ParticleSystemLoader.hpp"
 #include "SpriteLoader.hpp"
 #include "SpriteSheetLoader.hpp"
+#include "StaticMeshLoader.hpp"
+#include "TextureLoader.hpp"
 #include "TtfLoader.hpp"
 #include "VorbisLoader.hpp"
 #include "WaveLoader.hpp"
@@ -33,21 +35,32 @@ namespace ouzel::assets
         addLoader(Asset::Type::particleSystem, loadParticleSystem);
         addLoader(Asset::Type::sprite, loadSprite);
         addLoader(Asset::Type::sprite, loadSpriteSheet);
+        addLoader(Asset::Type::staticMesh, loadStaticMesh);
+        addLoader(Asset::Type::image, loadTexture);
         addLoader(Asset::Type::font, loadTtf);
         addLoader(Asset::Type::sound, loadVorbis);
         addLoader(Asset::Type::sound, loadWave);
+
+        addDecoder(loadImage, decodeImage);
+        addDecoder(loadTexture, decodeTexture);
     }
 
     void Cache::addBundle(const Bundle* bundle)
     {
         if (std::find(bundles.begin(), bundles.end(), bundle) == bundles.end())
+        {
             bundles.push_back(bundle);
+            invalidateIndices();
+        }
     }
 
     void Cache::removeBundle(const Bundle* bundle)
     {
         if (const auto i = std::find(bundles.begin(), bundles.end(), bundle); i != bundles.end())
+        {
             bundles.erase(i);
+            invalidateIndices();
+        }
     }
 
     void Cache::addLoader(const Asset::Type assetType, const Loader loader)
@@ -62,113 +75,110 @@ namespace ouzel::assets
                 i = loaders.erase(i);
             else
                 ++i;
+
+        for (auto i = decoders.begin(); i != decoders.end();)
+            if (i->first == loader)
+                i = decoders.erase(i);
+            else
+                ++i;
     }
 
-    std::shared_ptr<graphics::Texture> Cache::getTexture(std::string_view name) const
+    void Cache::addDecoder(const Loader loader, const Decoder decoder)
     {
-        for (const auto bundle : bundles)
-            if (const auto texture = bundle->getTexture(name))
-                return texture;
-
-        return nullptr;
+        decoders.push_back(std::make_pair(loader, decoder));
     }
 
-    const graphics::Shader* Cache::getShader(std::string_view name) const
+    void Cache::removeDecoder(const Decoder decoder)
     {
-        for (const auto bundle : bundles)
-            if (const auto shader = bundle->getShader(name))
-                return shader;
-
-        return nullptr;
+        for (auto i = decoders.begin(); i != decoders.end();)
+            if (i->second == decoder)
+                i = decoders.erase(i);
+            else
+                ++i;
     }
 
-    const graphics::BlendState* Cache::getBlendState(std::string_view name) const
+    Decoder Cache::getDecoder(const Loader loader) const noexcept
     {
-        for (const auto bundle : bundles)
-            if (const auto blendState = bundle->getBlendState(name))
-                return blendState;
+        for (const auto& [decoderLoader, decoder] : decoders)
+            if (decoderLoader == loader)
+                return decoder;
 
         return nullptr;
     }
 
-    const graphics::DepthStencilState* Cache::getDepthStencilState(std::string_view name) const
+    std::shared_ptr<graphics::Texture> Cache::getTexture(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto depthStencilState = bundle->getDepthStencilState(name))
-                return depthStencilState;
-
-        return nullptr;
+        return textures.find(id, bundles);
     }
 
-    const scene::SpriteData* Cache::getSpriteData(std::string_view name) const
+    const graphics::Shader* Cache::getShader(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto spriteData = bundle->getSpriteData(name))
-                return spriteData;
-
-        return nullptr;
+        return shaders.find(id, bundles);
     }
 
-    const scene::ParticleSystemData* Cache::getParticleSystemData(std::string_view name) const
+    const graphics::BlendState* Cache::getBlendState(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto particleSystemData = bundle->getParticleSystemData(name))
-                return particleSystemData;
-
-        return nullptr;
+        return blendStates.find(id, bundles);
     }
 
-    const gui::Font* Cache::getFont(std::string_view name) const
+    const graphics::DepthStencilState* Cache::getDepthStencilState(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto font = bundle->getFont(name))
-                return font;
-
-        return nullptr;
+        return depthStencilStates.find(id, bundles);
     }
 
-    const audio::Cue* Cache::getCue(std::string_view name) const
+    const scene::SpriteData* Cache::getSpriteData(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto cue = bundle->getCue(name))
-                return cue;
-
-        return nullptr;
+        return spriteData.find(id, bundles);
     }
 
-    const audio::Sound* Cache::getSound(std::string_view name) const
+    const scene::ParticleSystemData* Cache::getParticleSystemData(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto sound = bundle->getSound(name))
-                return sound;
+        return particleSystemData.find(id, bundles);
+    }
 
-        return nullptr;
+    const gui::Font* Cache::getFont(AssetId id) const
+    {
+        return fonts.find(id, bundles);
     }
 
-    const graphics::Material* Cache::getMaterial(std::string_view name) const
+    const audio::Cue* Cache::getCue(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto material = bundle->getMaterial(name))
-                return material;
+        return cues.find(id, bundles);
+    }
 
-        return nullptr;
+    const audio::Sound* Cache::getSound(AssetId id) const
+    {
+        return sounds.find(id, bundles);
     }
 
-    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(std::string_view name) const
+    const graphics::Material* Cache::getMaterial(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto meshData = bundle->getSkinnedMeshData(name))
-                return meshData;
+        return materials.find(id, bundles);
+    }
 
-        return nullptr;
+    const scene::SkinnedMeshData* Cache::getSkinnedMeshData(AssetId id) const
+    {
+        return skinnedMeshData.find(id, bundles);
     }
 
-    const scene::StaticMeshData* Cache::getStaticMeshData(std::string_view name) const
+    const scene::StaticMeshData* Cache::getStaticMeshData(AssetId id) const
     {
-        for (const auto bundle : bundles)
-            if (const auto meshData = bundle->getStaticMeshData(name))
-                return meshData;
+        return staticMeshData.find(id, bundles);
+    }
 
-        return nullptr;
+    void Cache::invalidateIndices() noexcept
+    {
+        textures.invalidate();
+        shaders.invalidate();
+        blendStates.invalidate();
+        depthStencilStates.invalidate();
+        spriteData.invalidate();
+        particleSystemData.invalidate();
+        fonts.invalidate();
+        cues.invalidate();
+        sounds.invalidate();
+        materials.invalidate();
+        skinnedMeshData.invalidate();
+        staticMeshData.invalidate();
     }
 }
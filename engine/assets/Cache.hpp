@@ -3,12 +3,17 @@
 #ifndef OUZEL_ASSETS_CACHE_HPP
 #define OUZEL_ASSETS_CACHE_HPP
 
+#include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "Asset.hpp"
+#include "AssetId.hpp"
 #include "Bundle.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::assets
 {
@@ -17,9 +22,18 @@ namespace ouzel::assets
     using Loader = bool(*)(Cache& cache,
                            Bundle& bundle,
                            const std::string& name,
-                           const std::vector<std::byte>& data,
+                           Span<const std::byte> data,
                            const Asset::Options& options);
 
+    // finishes loading of an asset that was decoded on a worker thread, called on the update thread
+    using AssetPublisher = std::function<void(Cache& cache, Bundle& bundle)>;
+
+    // decodes the asset without touching the bundle, so that it can run on a worker thread instead of its loader,
+    // returns an empty publisher if the data is not in the decoder's format
+    using Decoder = AssetPublisher(*)(const std::string& name,
+                                      Span<const std::byte> data,
+                                      const Asset::Options& options);
+
     class Cache final
     {
         friend Bundle;
@@ -35,28 +49,130 @@ namespace ouzel::assets
         auto& getBundles() const noexcept { return bundles; }
         auto& getLoaders() const noexcept { return loaders; }
 
-        std::shared_ptr<graphics::Texture> getTexture(std::string_view name) const;
-        const graphics::Shader* getShader(std::string_view name) const;
-        const graphics::BlendState* getBlendState(std::string_view name) const;
-        const graphics::DepthStencilState* getDepthStencilState(std::string_view name) const;
-        const scene::SpriteData* getSpriteData(std::string_view name) const;
-        const scene::ParticleSystemData* getParticleSystemData(std::string_view name) const;
-        const gui::Font* getFont(std::string_view name) const;
-        const audio::Cue* getCue(std::string_view name) const;
-        const audio::Sound* getSound(std::string_view name) const;
-        const graphics::Material* getMaterial(std::string_view name) const;
-        const scene::SkinnedMeshData* getSkinnedMeshData(std::string_view name) const;
-        const scene::StaticMeshData* getStaticMeshData(std::string_view name) const;
+        // the assets are looked up by the hash of the name in an index of all the bundles
+        std::shared_ptr<graphics::Texture> getTexture(AssetId id) const;
+        const graphics::Shader* getShader(AssetId id) const;
+        const graphics::BlendState* getBlendState(AssetId id) const;
+        const graphics::DepthStencilState* getDepthStencilState(AssetId id) const;
+        const scene::SpriteData* getSpriteData(AssetId id) const;
+        const scene::ParticleSystemData* getParticleSystemData(AssetId id) const;
+        const gui::Font* getFont(AssetId id) const;
+        const audio::Cue* getCue(AssetId id) const;
+        const audio::Sound* getSound(AssetId id) const;
+        const graphics::Material* getMaterial(AssetId id) const;
+        const scene::SkinnedMeshData* getSkinnedMeshData(AssetId id) const;
+        const scene::StaticMeshData* getStaticMeshData(AssetId id) const;
 
     private:
+        // assets of one type in all the bundles, the first bundle that has the asset wins
+        // the index is rebuilt on the first lookup after the bundles have changed and
+        // updated in place when a bundle sets a single asset
+        template <typename Map>
+        class Index final
+        {
+        public:
+            explicit Index(Map Bundle::* initMap) noexcept: map{initMap} {}
+
+            auto find(const AssetId id, const std::vector<const Bundle*>& bundles) const
+            {
+                if (!valid) rebuild(bundles);
+
+                if (const auto i = entries.find(id); i != entries.end())
+                    return i->second.asset;
+
+                return decltype(Entry::asset){};
+            }
+
+            void update(const std::string_view name, const std::vector<const Bundle*>& bundles)
+            {
+                if (!valid) return;
+
+                const AssetId id{name};
+                entries.erase(id);
+
+                for (const auto bundle : bundles)
+                    if (const auto i = (bundle->*map).find(name); i != (bundle->*map).end())
+                    {
+                        add(id, i->first, i->second);
+                        break;
+                    }
+            }
+
+            void invalidate() noexcept
+            {
+                entries.clear(); // must not keep the released assets alive
+                valid = false;
+            }
+
+        private:
+            template <typename T>
+            static auto getAsset(const std::shared_ptr<T>& asset) noexcept { return asset; }
+
+            template <typename T>
+            static const T* getAsset(const std::unique_ptr<T>& asset) noexcept { return asset.get(); }
+
+            template <typename T>
+            static const T* getAsset(const T& asset) noexcept { return &asset; }
+
+            struct Entry final
+            {
+                std::string_view name; // key of the bundle's map, used to detect hash collisions
+                decltype(getAsset(std::declval<const typename Map::mapped_type&>())) asset;
+            };
+
+            void add(const AssetId id, const std::string_view name, const typename Map::mapped_type& asset) const
+            {
+                if (const auto [i, inserted] = entries.try_emplace(id, Entry{name, getAsset(asset)});
+                    !inserted && i->second.name != name)
+                    throw std::runtime_error{"Asset name " + std::string{name} + " collides with " + std::string{i->second.name}};
+            }
+
+            void rebuild(const std::vector<const Bundle*>& bundles) const
+            {
+                entries.clear();
+
+                for (const auto bundle : bundles)
+                    for (const auto& [name, asset] : bundle->*map)
+                        add(AssetId{name}, name, asset);
+
+                valid = true;
+            }
+
+            Map Bundle::* map;
+            mutable std::unordered_map<AssetId, Entry> entries;
+            mutable bool valid = false;
+        };
+
+        void invalidateIndices() noexcept;
+
         void addBundle(const Bundle* bundle);
         void removeBundle(const Bundle* bundle);
 
         void addLoader(const Asset::Type assetType, const Loader loader);
         void removeLoader(const Loader loader);
 
+        // the assets of the loader are decoded with the decoder when they are loaded asynchronously
+        void addDecoder(const Loader loader, const Decoder decoder);
+        void removeDecoder(const Decoder decoder);
+
+        Decoder getDecoder(const Loader loader) const noexcept;
+
         std::vector<const Bundle*> bundles;
         std::vector<std::pair<Asset::Type, Loader>> loaders;
+        std::vector<std::pair<Loader, Decoder>> decoders;
+
+        Index<decltype(Bundle::textures)> textures{&Bundle::textures};
+        Index<decltype(Bundle::shaders)> shaders{&Bundle::shaders};
+        Index<decltype(Bundle::blendStates)> blendStates{&Bundle::blendStates};
+        Index<decltype(Bundle::depthStencilStates)> depthStencilStates{&Bundle::depthStencilStates};
+        Index<decltype(Bundle::spriteData)> spriteData{&Bundle::spriteData};
+        Index<decltype(Bundle::particleSystemData)> particleSystemData{&Bundle::particleSystemData};
+        Index<decltype(Bundle::fonts)> fonts{&Bundle::fonts};
+        Index<decltype(Bundle::cues)> cues{&Bundle::cues};
+        Index<decltype(Bundle::sounds)> sounds{&Bundle::sounds};
+        Index<decltype(Bundle::materials)> materials{&Bundle::materials};
+        Index<decltype(Bundle::skinnedMeshData)> skinnedMeshData{&Bundle::skinnedMeshData};
+        Index<decltype(Bundle::staticMeshData)> staticMeshData{&Bundle::staticMeshData};
     };
 }
 
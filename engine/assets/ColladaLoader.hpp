@@ -12,17 +12,12 @@ namespace ouzel::assets
     inline bool loadCollada(Cache&,
                             Bundle& bundle,
                             const std::string& name,
-                            const std::vector<std::byte>& data,
+                            Span<const std::byte> data,
                             const Asset::Options&)
     {
-        const auto colladaData = xml::parse(data);
+        const xml::Document colladaData{data};
 
-        if (colladaData.getChildren().empty())
-            throw std::runtime_error{"Invalid Collada file"};
-
-        const auto rootNode = colladaData.getChildren().front();
-
-        if (rootNode.getValue() != "COLLADA")
+        if (colladaData.getRoot().name != "COLLADA")
             throw std::runtime_error{"Invalid Collada file"};
 
         scene::SkinnedMeshData meshData;
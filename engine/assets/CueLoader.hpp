@@ -85,6 +85,8 @@ namespace ouzel::assets
                     if (effectValue.hasMember("scale")) effectDefinition.scale = effectValue["scale"].as<float>();
                     if (effectValue.hasMember("shift")) effectDefinition.shift = effectValue["shift"].as<float>();
                     if (effectValue.hasMember("decay")) effectDefinition.decay = effectValue["decay"].as<float>();
+                    if (effectValue.hasMember("cutoffFrequency")) effectDefinition.cutoffFrequency = effectValue["cutoffFrequency"].as<float>();
+                    if (effectValue.hasMember("resonance")) effectDefinition.resonance = effectValue["resonance"].as<float>();
 
                     sourceDefinition.effectDefinitions.push_back(effectDefinition);
                 }
@@ -100,7 +102,7 @@ namespace ouzel::assets
     inline bool loadCue(Cache&,
                         Bundle& bundle,
                         const std::string& name,
-                        const std::vector<std::byte>& data,
+                        Span<const std::byte> data,
                         const Asset::Options&)
     {
         audio::SourceDefinition sourceDefinition;
@@ -111,6 +113,9 @@ namespace ouzel::assets
 
         auto cue = std::make_unique<audio::Cue>(sourceDefinition);
 
+        if (d.hasMember("priority"))
+            cue->setPriority(d["priority"].as<std::int32_t>());
+
         bundle.setCue(name, std::move(cue));
 
         return true;
@@ -0,0 +1,874 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "GltfLoader.hpp"
+#include "ImageLoader.hpp"
+#include "../core/Engine.hpp"
+#include "../formats/Json.hpp"
+#include "../scene/SkinnedMeshRenderer.hpp"
+#include "../storage/MappedFile.hpp"
+#include "../utils/Utils.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        constexpr std::uint32_t glbMagic = 0x46546C67U; // "glTF"
+        constexpr std::uint32_t glbVersion = 2;
+        constexpr std::uint32_t jsonChunkType = 0x4E4F534AU; // "JSON"
+        constexpr std::uint32_t binaryChunkType = 0x004E4942U; // "BIN\0"
+        constexpr std::size_t glbHeaderSize = 12;
+        constexpr std::size_t chunkHeaderSize = 8;
+        constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+        enum class ComponentType: std::uint32_t
+        {
+            byte = 5120,
+            unsignedByte = 5121,
+            shortInteger = 5122,
+            unsignedShort = 5123,
+            unsignedInteger = 5125,
+            floatingPoint = 5126
+        };
+
+        constexpr std::uint32_t triangles = 4;
+
+        struct Container final
+        {
+            Span<const std::byte> json;
+            Span<const std::byte> binary;
+        };
+
+        bool isGlb(Span<const std::byte> data) noexcept
+        {
+            return data.size() >= glbHeaderSize &&
+                decodeLittleEndian<std::uint32_t>(data.data()) == glbMagic;
+        }
+
+        // the JSON format is recognized by the object at the beginning of the file
+        bool isGltf(Span<const std::byte> data) noexcept
+        {
+            auto iterator = data.begin();
+
+            if (data.size() >= 3 &&
+                static_cast<std::uint8_t>(data[0]) == 0xEF &&
+                static_cast<std::uint8_t>(data[1]) == 0xBB &&
+                static_cast<std::uint8_t>(data[2]) == 0xBF)
+                iterator += 3;
+
+            while (iterator != data.end() &&
+                   (static_cast<char>(*iterator) == ' ' || static_cast<char>(*iterator) == '\t' ||
+                    static_cast<char>(*iterator) == '\r' || static_cast<char>(*iterator) == '\n'))
+                ++iterator;
+
+            return iterator != data.end() && static_cast<char>(*iterator) == '{';
+        }
+
+        Container readGlb(Span<const std::byte> data)
+        {
+            if (decodeLittleEndian<std::uint32_t>(data.data() + 4) != glbVersion)
+                throw std::runtime_error{"Unsupported GLB version"};
+
+            const std::size_t length = decodeLittleEndian<std::uint32_t>(data.data() + 8);
+            // the chunks are read up to the declared length, which must cover the header
+            if (length < glbHeaderSize || length > data.size())
+                throw std::runtime_error{"Invalid GLB length"};
+
+            Container container;
+
+            for (std::size_t offset = glbHeaderSize; length - offset >= chunkHeaderSize;)
+            {
+                const std::size_t chunkLength = decodeLittleEndian<std::uint32_t>(data.data() + offset);
+                const auto chunkType = decodeLittleEndian<std::uint32_t>(data.data() + offset + 4);
+                offset += chunkHeaderSize;
+
+                if (chunkLength > length - offset)
+                    throw std::runtime_error{"GLB chunk out of bounds"};
+
+                if (chunkType == jsonChunkType && container.json.empty())
+                    container.json = data.subspan(offset, chunkLength);
+                else if (chunkType == binaryChunkType && container.binary.empty())
+                    container.binary = data.subspan(offset, chunkLength);
+
+                // unknown chunks are skipped
+                offset += chunkLength;
+            }
+
+            if (container.json.empty())
+                throw std::runtime_error{"GLB JSON chunk not found"};
+
+            return container;
+        }
+
+        std::vector<std::byte> decodeBase64(std::string_view encoded)
+        {
+            static const auto table = []() noexcept {
+                std::array<std::uint8_t, 256> result{};
+                result.fill(0xFF);
+
+                constexpr std::string_view characters = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                for (std::size_t i = 0; i < characters.size(); ++i)
+                    result[static_cast<std::uint8_t>(characters[i])] = static_cast<std::uint8_t>(i);
+
+                return result;
+            }();
+
+            std::vector<std::byte> result;
+            result.reserve(encoded.size() / 4 * 3);
+
+            std::uint32_t buffer = 0;
+            std::uint32_t bitCount = 0;
+
+            for (const auto c : encoded)
+            {
+                if (c == '=') break;
+
+                const auto value = table[static_cast<std::uint8_t>(c)];
+                if (value == 0xFF)
+                    throw std::runtime_error{"Invalid base64 data"};
+
+                buffer = (buffer << 6) | value;
+                bitCount += 6;
+
+                if (bitCount >= 8)
+                {
+                    bitCount -= 8;
+                    result.push_back(static_cast<std::byte>((buffer >> bitCount) & 0xFFU));
+                }
+            }
+
+            return result;
+        }
+
+        bool isDataUri(std::string_view uri) noexcept
+        {
+            return uri.substr(0, 5) == "data:";
+        }
+
+        std::vector<std::byte> decodeDataUri(std::string_view uri)
+        {
+            constexpr std::string_view base64Marker = ";base64,";
+
+            const auto position = uri.find(base64Marker);
+            if (position == std::string_view::npos)
+                throw std::runtime_error{"Only base64 data URIs are supported"};
+
+            return decodeBase64(uri.substr(position + base64Marker.size()));
+        }
+
+        std::uint8_t decodeHexDigit(char c)
+        {
+            if (c >= '0' && c <= '9') return static_cast<std::uint8_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') return static_cast<std::uint8_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') return static_cast<std::uint8_t>(c - 'A' + 10);
+            else throw std::runtime_error{"Invalid percent-encoding"};
+        }
+
+        // the URIs are percent-encoded and relative to the glTF file
+        std::string resolveUri(const std::string& baseFilename, std::string_view uri)
+        {
+            std::string path;
+            path.reserve(uri.size());
+
+            for (std::size_t i = 0; i < uri.size(); ++i)
+                if (uri[i] == '%')
+                {
+                    if (uri.size() - i < 3)
+                        throw std::runtime_error{"Invalid percent-encoding"};
+
+                    path.push_back(static_cast<char>((decodeHexDigit(uri[i + 1]) << 4) | decodeHexDigit(uri[i + 2])));
+                    i += 2;
+                }
+                else
+                    path.push_back(uri[i]);
+
+            const storage::Path filePath{path};
+            if (filePath.isAbsolute()) return path;
+
+            return (storage::Path{baseFilename}.getDirectory() / filePath).getNormal().getGeneric();
+        }
+
+        std::size_t getSize(const json::Value& object, std::string_view member, std::size_t defaultValue = 0)
+        {
+            return object.hasMember(member) ? object[member].as<std::size_t>() : defaultValue;
+        }
+
+        // the buffers of the GLB binary chunk and the mapped files are used without copying
+        class Buffers final
+        {
+        public:
+            Buffers(const json::Value& document, Span<const std::byte> binary, const std::string& baseFilename)
+            {
+                if (!document.hasMember("buffers")) return;
+
+                const auto& buffersValue = document["buffers"];
+                decoded.reserve(buffersValue.getSize());
+                files.reserve(buffersValue.getSize());
+
+                for (const auto& bufferValue : buffersValue)
+                {
+                    const auto byteLength = getSize(bufferValue, "byteLength");
+                    Span<const std::byte> buffer;
+
+                    if (!bufferValue.hasMember("uri"))
+                        buffer = binary;
+                    else if (const auto& uri = bufferValue["uri"].as<std::string>(); isDataUri(uri))
+                    {
+                        decoded.push_back(decodeDataUri(uri));
+                        buffer = Span<const std::byte>{decoded.back()};
+                    }
+                    else
+                    {
+                        files.push_back(engine->getFileSystem().mapFile(resolveUri(baseFilename, uri)));
+                        buffer = Span<const std::byte>{files.back().getData(), files.back().getSize()};
+                    }
+
+                    // the binary chunk can be padded
+                    if (buffer.size() < byteLength)
+                        throw std::runtime_error{"Buffer is too short"};
+
+                    buffers.push_back(buffer.subspan(0, byteLength));
+                }
+            }
+
+            Span<const std::byte> getBufferView(const json::Value& document, std::size_t index) const
+            {
+                const auto& bufferView = document["bufferViews"][index];
+                const auto bufferIndex = bufferView["buffer"].as<std::size_t>();
+
+                if (bufferIndex >= buffers.size())
+                    throw std::runtime_error{"Invalid buffer index"};
+
+                const auto& buffer = buffers[bufferIndex];
+                const auto offset = getSize(bufferView, "byteOffset");
+                const auto length = bufferView["byteLength"].as<std::size_t>();
+
+                if (offset > buffer.size() || length > buffer.size() - offset)
+                    throw std::runtime_error{"Buffer view out of bounds"};
+
+                return buffer.subspan(offset, length);
+            }
+
+        private:
+            std::vector<Span<const std::byte>> buffers;
+            std::vector<std::vector<std::byte>> decoded;
+            std::vector<storage::MappedFile> files;
+        };
+
+        struct Accessor final
+        {
+            const std::byte* data = nullptr;
+            std::size_t count = 0;
+            std::size_t stride = 0;
+            ComponentType componentType = ComponentType::floatingPoint;
+            std::size_t componentCount = 0;
+            bool normalized = false;
+        };
+
+        std::size_t getComponentSize(const ComponentType componentType)
+        {
+            switch (componentType)
+            {
+                case ComponentType::byte:
+                case ComponentType::unsignedByte: return 1;
+                case ComponentType::shortInteger:
+                case ComponentType::unsignedShort: return 2;
+                case ComponentType::unsignedInteger:
+                case ComponentType::floatingPoint: return 4;
+                default: throw std::runtime_error{"Invalid component type"};
+            }
+        }
+
+        std::size_t getComponentCount(std::string_view type)
+        {
+            if (type == "SCALAR") return 1;
+            else if (type == "VEC2") return 2;
+            else if (type == "VEC3") return 3;
+            else if (type == "VEC4") return 4;
+            else if (type == "MAT2") return 4;
+            else if (type == "MAT3") return 9;
+            else if (type == "MAT4") return 16;
+            else throw std::runtime_error{"Invalid accessor type"};
+        }
+
+        Accessor getAccessor(const json::Value& document, const Buffers& buffers, std::size_t index)
+        {
+            const auto& accessorValue = document["accessors"][index];
+
+            if (accessorValue.hasMember("sparse"))
+                throw std::runtime_error{"Sparse accessors are not supported"};
+
+            if (!accessorValue.hasMember("bufferView"))
+                throw std::runtime_error{"Accessors without buffer views are not supported"};
+
+            Accessor accessor;
+            accessor.componentType = static_cast<ComponentType>(accessorValue["componentType"].as<std::uint32_t>());
+            accessor.componentCount = getComponentCount(accessorValue["type"].as<std::string>());
+            accessor.count = accessorValue["count"].as<std::size_t>();
+            accessor.normalized = accessorValue.hasMember("normalized") && accessorValue["normalized"].as<bool>();
+
+            const auto bufferViewIndex = accessorValue["bufferView"].as<std::size_t>();
+            const auto bufferView = buffers.getBufferView(document, bufferViewIndex);
+            const auto elementSize = getComponentSize(accessor.componentType) * accessor.componentCount;
+            accessor.stride = getSize(document["bufferViews"][bufferViewIndex], "byteStride", elementSize);
+
+            if (accessor.stride < elementSize)
+                throw std::runtime_error{"Invalid byte stride"};
+
+            const auto offset = getSize(accessorValue, "byteOffset");
+
+            if (accessor.count > 0 &&
+                (offset > bufferView.size() ||
+                 elementSize > bufferView.size() - offset ||
+                 accessor.count - 1 > (bufferView.size() - offset - elementSize) / accessor.stride))
+                throw std::runtime_error{"Accessor out of bounds"};
+
+            accessor.data = bufferView.data() + offset;
+
+            return accessor;
+        }
+
+        template <typename T>
+        float toFloat(const T value, const bool normalized) noexcept
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                return value;
+            else if (!normalized)
+                return static_cast<float>(value);
+            else if constexpr (std::is_signed_v<T>)
+                return std::max(static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max()), -1.0F);
+            else
+                return static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max());
+        }
+
+        template <typename T, std::size_t n, class Function>
+        void readFloats(const Accessor& accessor, Function function)
+        {
+            for (std::size_t i = 0; i < accessor.count; ++i)
+            {
+                const auto element = accessor.data + i * accessor.stride;
+
+                std::array<float, n> values;
+                for (std::size_t c = 0; c < n; ++c)
+                {
+                    T value;
+                    std::memcpy(&value, element + c * sizeof(T), sizeof(T));
+                    values[c] = toFloat(value, accessor.normalized);
+                }
+
+                function(i, values);
+            }
+        }
+
+        // the component type is resolved once per accessor, so that every loop is specialized
+        // for its source type and can be vectorized by the compiler
+        template <std::size_t n, class Function>
+        void readFloats(const Accessor& accessor, Function function)
+        {
+            if (accessor.componentCount != n)
+                throw std::runtime_error{"Invalid accessor type"};
+
+            switch (accessor.componentType)
+            {
+                case ComponentType::byte: readFloats<std::int8_t, n>(accessor, function); break;
+                case ComponentType::unsignedByte: readFloats<std::uint8_t, n>(accessor, function); break;
+                case ComponentType::shortInteger: readFloats<std::int16_t, n>(accessor, function); break;
+                case ComponentType::unsignedShort: readFloats<std::uint16_t, n>(accessor, function); break;
+                case ComponentType::floatingPoint: readFloats<float, n>(accessor, function); break;
+                default: throw std::runtime_error{"Invalid component type"};
+            }
+        }
+
+        template <typename T, typename Result>
+        void readIntegers(const Accessor& accessor, Result* result)
+        {
+            for (std::size_t i = 0; i < accessor.count; ++i)
+                for (std::size_t c = 0; c < accessor.componentCount; ++c)
+                {
+                    T value;
+                    std::memcpy(&value, accessor.data + i * accessor.stride + c * sizeof(T), sizeof(T));
+                    *result++ = static_cast<Result>(value);
+                }
+        }
+
+        template <typename Result>
+        std::vector<Result> readIntegers(const Accessor& accessor)
+        {
+            std::vector<Result> result(accessor.count * accessor.componentCount);
+
+            switch (accessor.componentType)
+            {
+                case ComponentType::unsignedByte: readIntegers<std::uint8_t>(accessor, result.data()); break;
+                case ComponentType::unsignedShort: readIntegers<std::uint16_t>(accessor, result.data()); break;
+                case ComponentType::unsignedInteger: readIntegers<std::uint32_t>(accessor, result.data()); break;
+                default: throw std::runtime_error{"Invalid component type"};
+            }
+
+            return result;
+        }
+
+        std::vector<float> readValues(const Accessor& accessor)
+        {
+            std::vector<float> result;
+            result.reserve(accessor.count * accessor.componentCount);
+
+            const auto append = [&result](std::size_t, const auto& values) {
+                result.insert(result.end(), values.begin(), values.end());
+            };
+
+            switch (accessor.componentCount)
+            {
+                case 1: readFloats<1>(accessor, append); break;
+                case 3: readFloats<3>(accessor, append); break;
+                case 4: readFloats<4>(accessor, append); break;
+                default: throw std::runtime_error{"Invalid accessor type"};
+            }
+
+            return result;
+        }
+
+        void readTransform(const json::Value& node, scene::SkinnedMeshData::Bone& bone)
+        {
+            if (node.hasMember("matrix"))
+            {
+                math::Matrix<float, 4> matrix;
+                for (std::size_t i = 0; i < 16; ++i)
+                    matrix.m.v[i] = node["matrix"][i].as<float>(); // column-major like glTF
+
+                bone.position = getTranslation(matrix);
+                bone.scale = getScale(matrix);
+                bone.rotation = getRotation(matrix);
+                return;
+            }
+
+            if (node.hasMember("translation"))
+                for (std::size_t i = 0; i < 3; ++i)
+                    bone.position.v[i] = node["translation"][i].as<float>();
+
+            if (node.hasMember("rotation"))
+                for (std::size_t i = 0; i < 4; ++i)
+                    bone.rotation.v[i] = node["rotation"][i].as<float>();
+
+            if (node.hasMember("scale"))
+                for (std::size_t i = 0; i < 3; ++i)
+                    bone.scale.v[i] = node["scale"][i].as<float>();
+        }
+
+        class GltfLoader final
+        {
+        public:
+            GltfLoader(Cache& initCache,
+                   Bundle& initBundle,
+                   const std::string& initName,
+                   const json::Value& initDocument,
+                   Span<const std::byte> binary,
+                   const Asset::Options& initOptions):
+                cache{initCache},
+                bundle{initBundle},
+                name{initName},
+                document{initDocument},
+                baseFilename{bundle.getLoadingFilename()},
+                buffers{initDocument, binary, baseFilename},
+                options{initOptions}
+            {
+                if (document.hasMember("nodes"))
+                {
+                    const auto& nodes = document["nodes"];
+                    nodeParents.resize(nodes.getSize(), none);
+
+                    for (std::size_t i = 0; i < nodes.getSize(); ++i)
+                        if (nodes[i].hasMember("children"))
+                            for (const auto& child : nodes[i]["children"])
+                                if (const auto childIndex = child.as<std::size_t>(); childIndex < nodeParents.size())
+                                    nodeParents[childIndex] = i;
+                }
+
+                if (document.hasMember("materials"))
+                    materials.resize(document["materials"].getSize());
+            }
+
+            void load()
+            {
+                if (!document.hasMember("meshes")) return;
+
+                const auto& meshes = document["meshes"];
+
+                for (std::size_t meshIndex = 0; meshIndex < meshes.getSize(); ++meshIndex)
+                {
+                    const auto& mesh = meshes[meshIndex];
+
+                    // the meshes of a file with several meshes are stored under their own names
+                    const auto meshName = mesh.hasMember("name") && meshes.getSize() > 1 ?
+                        mesh["name"].as<std::string>() :
+                        meshIndex == 0 ? name : name + '.' + std::to_string(meshIndex);
+
+                    const auto skinIndex = findSkin(meshIndex);
+                    const auto& primitives = mesh["primitives"];
+
+                    for (std::size_t primitiveIndex = 0; primitiveIndex < primitives.getSize(); ++primitiveIndex)
+                    {
+                        auto meshData = loadPrimitive(primitives[primitiveIndex]);
+
+                        if (skinIndex != none)
+                            loadSkin(skinIndex, meshData);
+
+                        bundle.setSkinnedMeshData(primitiveIndex == 0 ? meshName : meshName + '.' + std::to_string(primitiveIndex),
+                                                  std::move(meshData));
+                    }
+                }
+            }
+
+        private:
+            std::size_t findSkin(std::size_t meshIndex) const
+            {
+                if (document.hasMember("nodes"))
+                    for (const auto& node : document["nodes"])
+                        if (node.hasMember("mesh") && node.hasMember("skin") &&
+                            node["mesh"].as<std::size_t>() == meshIndex)
+                            return node["skin"].as<std::size_t>();
+
+                return none;
+            }
+
+            scene::SkinnedMeshData loadPrimitive(const json::Value& primitive)
+            {
+                if (primitive.hasMember("mode") && primitive["mode"].as<std::uint32_t>() != triangles)
+                    throw std::runtime_error{"Only triangle primitives are supported"};
+
+                const auto& attributes = primitive["attributes"];
+
+                const auto positions = getAccessor(document, buffers, attributes["POSITION"].as<std::size_t>());
+                const auto vertexCount = positions.count;
+
+                std::vector<graphics::Vertex> vertices(vertexCount);
+                math::Box<float, 3> boundingBox;
+
+                readFloats<3>(positions, [&vertices, &boundingBox](std::size_t i, const std::array<float, 3>& values) {
+                    vertices[i].position = math::Vector<float, 3>{values[0], values[1], values[2]};
+                    vertices[i].color = math::whiteColor;
+                    insertPoint(boundingBox, vertices[i].position);
+                });
+
+                const auto getAttribute = [this, &attributes, vertexCount](std::string_view attribute) {
+                    auto accessor = getAccessor(document, buffers, attributes[attribute].as<std::size_t>());
+                    if (accessor.count != vertexCount)
+                        throw std::runtime_error{"Invalid attribute count"};
+                    return accessor;
+                };
+
+                if (attributes.hasMember("NORMAL"))
+                    readFloats<3>(getAttribute("NORMAL"), [&vertices](std::size_t i, const std::array<float, 3>& values) {
+                        vertices[i].normal = math::Vector<float, 3>{values[0], values[1], values[2]};
+                    });
+
+                for (std::size_t layer = 0; layer < 2; ++layer)
+                    if (const auto attribute = "TEXCOORD_" + std::to_string(layer); attributes.hasMember(attribute))
+                        readFloats<2>(getAttribute(attribute), [&vertices, layer](std::size_t i, const std::array<float, 2>& values) {
+                            vertices[i].texCoords[layer] = math::Vector<float, 2>{values[0], values[1]};
+                        });
+
+                if (attributes.hasMember("COLOR_0"))
+                {
+                    const auto colors = getAttribute("COLOR_0");
+
+                    if (colors.componentCount == 3)
+                        readFloats<3>(colors, [&vertices](std::size_t i, const std::array<float, 3>& values) {
+                            vertices[i].color = math::Color{values[0], values[1], values[2]};
+                        });
+                    else
+                        readFloats<4>(colors, [&vertices](std::size_t i, const std::array<float, 4>& values) {
+                            vertices[i].color = math::Color{values[0], values[1], values[2], values[3]};
+                        });
+                }
+
+                std::vector<std::uint32_t> indices;
+
+                if (primitive.hasMember("indices"))
+                {
+                    const auto indexAccessor = getAccessor(document, buffers, primitive["indices"].as<std::size_t>());
+                    if (indexAccessor.componentCount != 1)
+                        throw std::runtime_error{"Invalid index accessor type"};
+
+                    indices = readIntegers<std::uint32_t>(indexAccessor);
+
+                    for (const auto index : indices)
+                        if (index >= vertexCount)
+                            throw std::runtime_error{"Invalid index"};
+                }
+                else
+                {
+                    indices.resize(vertexCount);
+                    std::iota(indices.begin(), indices.end(), 0U);
+                }
+
+                scene::SkinnedMeshData meshData{
+                    boundingBox,
+                    indices,
+                    vertices,
+                    primitive.hasMember("material") ? getMaterial(primitive["material"].as<std::size_t>()) : getDefaultMaterial()
+                };
+
+                if (attributes.hasMember("JOINTS_0") && attributes.hasMember("WEIGHTS_0"))
+                {
+                    const auto joints = getAttribute("JOINTS_0");
+                    if (joints.componentCount != 4)
+                        throw std::runtime_error{"Invalid joint accessor type"};
+
+                    const auto jointIndices = readIntegers<std::uint16_t>(joints);
+
+                    meshData.boneWeights.resize(vertexCount);
+                    for (std::size_t i = 0; i < vertexCount; ++i)
+                        std::copy(jointIndices.begin() + static_cast<std::ptrdiff_t>(i * 4),
+                                  jointIndices.begin() + static_cast<std::ptrdiff_t>(i * 4 + 4),
+                                  meshData.boneWeights[i].bones.begin());
+
+                    readFloats<4>(getAttribute("WEIGHTS_0"), [&meshData](std::size_t i, const std::array<float, 4>& values) {
+                        meshData.boneWeights[i].weights = values;
+                    });
+
+                    // the renderers skin the bind pose vertices on the CPU
+                    meshData.bindPoseVertices = std::move(vertices);
+                }
+
+                return meshData;
+            }
+
+            void loadSkin(std::size_t skinIndex, scene::SkinnedMeshData& meshData) const
+            {
+                const auto& skin = document["skins"][skinIndex];
+                const auto& joints = skin["joints"];
+                const auto& nodes = document["nodes"];
+
+                std::vector<std::size_t> nodeBones(nodes.getSize(), none);
+                meshData.bones.resize(joints.getSize());
+
+                for (std::size_t i = 0; i < joints.getSize(); ++i)
+                {
+                    const auto node = joints[i].as<std::size_t>();
+                    if (node >= nodes.getSize())
+                        throw std::runtime_error{"Invalid joint"};
+
+                    nodeBones[node] = i;
+                    readTransform(nodes[node], meshData.bones[i]);
+                }
+
+                // the parent of a bone is its closest ancestor that is also a joint
+                for (std::size_t i = 0; i < joints.getSize(); ++i)
+                    for (auto parent = nodeParents[joints[i].as<std::size_t>()]; parent != none; parent = nodeParents[parent])
+                        if (nodeBones[parent] != none)
+                        {
+                            meshData.bones[i].parent = &meshData.bones[nodeBones[parent]];
+                            break;
+                        }
+
+                if (skin.hasMember("inverseBindMatrices"))
+                {
+                    const auto matrices = getAccessor(document, buffers, skin["inverseBindMatrices"].as<std::size_t>());
+                    if (matrices.componentCount != 16 || matrices.componentType != ComponentType::floatingPoint)
+                        throw std::runtime_error{"Invalid inverse bind matrix accessor"};
+
+                    if (matrices.count < joints.getSize())
+                        throw std::runtime_error{"Not enough inverse bind matrices"};
+
+                    for (std::size_t i = 0; i < joints.getSize(); ++i)
+                        std::memcpy(meshData.bones[i].inverseBindMatrix.m.v,
+                                    matrices.data + i * matrices.stride,
+                                    sizeof(meshData.bones[i].inverseBindMatrix.m.v));
+                }
+
+                if (document.hasMember("animations"))
+                    for (const auto& animationValue : document["animations"])
+                    {
+                        scene::SkinnedMeshData::Animation animation;
+                        if (animationValue.hasMember("name"))
+                            animation.name = animationValue["name"].as<std::string>();
+
+                        for (const auto& channelValue : animationValue["channels"])
+                        {
+                            const auto& target = channelValue["target"];
+
+                            // only the bones of this skin are animated
+                            if (!target.hasMember("node")) continue;
+                            const auto node = target["node"].as<std::size_t>();
+                            if (node >= nodeBones.size() || nodeBones[node] == none) continue;
+
+                            using Channel = scene::SkinnedMeshData::Animation::Channel;
+                            Channel channel;
+                            channel.bone = nodeBones[node];
+
+                            if (const auto& path = target["path"].as<std::string>(); path == "translation")
+                                channel.path = Channel::Path::translation;
+                            else if (path == "rotation")
+                                channel.path = Channel::Path::rotation;
+                            else if (path == "scale")
+                                channel.path = Channel::Path::scale;
+                            else
+                                continue; // morph target weights are not supported
+
+                            const auto& sampler = animationValue["samplers"][channelValue["sampler"].as<std::size_t>()];
+
+                            if (sampler.hasMember("interpolation"))
+                            {
+                                if (const auto& interpolation = sampler["interpolation"].as<std::string>(); interpolation == "STEP")
+                                    channel.interpolation = Channel::Interpolation::step;
+                                else if (interpolation == "CUBICSPLINE")
+                                    channel.interpolation = Channel::Interpolation::cubicSpline;
+                            }
+
+                            channel.times = readValues(getAccessor(document, buffers, sampler["input"].as<std::size_t>()));
+                            channel.values = readValues(getAccessor(document, buffers, sampler["output"].as<std::size_t>()));
+
+                            animation.channels.push_back(std::move(channel));
+                        }
+
+                        if (!animation.channels.empty())
+                            meshData.animations.push_back(std::move(animation));
+                    }
+            }
+
+            std::shared_ptr<graphics::Material> getMaterial(std::size_t index)
+            {
+                if (index >= materials.size())
+                    throw std::runtime_error{"Invalid material index"};
+
+                if (materials[index]) return materials[index];
+
+                const auto& materialValue = document["materials"][index];
+
+                auto material = std::make_shared<graphics::Material>();
+                material->cullMode = materialValue.hasMember("doubleSided") && materialValue["doubleSided"].as<bool>() ?
+                    graphics::CullMode::none : graphics::CullMode::back;
+
+                const auto blend = materialValue.hasMember("alphaMode") &&
+                    materialValue["alphaMode"].as<std::string>() == "BLEND";
+                material->blendState = cache.getBlendState(blend ? blendAlpha : blendNoBlend);
+
+                if (materialValue.hasMember("pbrMetallicRoughness"))
+                {
+                    const auto& pbr = materialValue["pbrMetallicRoughness"];
+
+                    if (pbr.hasMember("baseColorFactor"))
+                    {
+                        const auto& factor = pbr["baseColorFactor"];
+                        material->diffuseColor = math::Color{
+                            factor[0].as<float>(),
+                            factor[1].as<float>(),
+                            factor[2].as<float>()
+                        };
+                        material->opacity = factor[3].as<float>();
+                    }
+
+                    if (pbr.hasMember("baseColorTexture"))
+                        material->textures[0] = getTexture(pbr["baseColorTexture"]["index"].as<std::size_t>());
+                }
+
+                material->shader = material->textures[0] ? cache.getShader(shaderTexture) : cache.getShader(shaderColor);
+
+                materials[index] = material;
+                return material;
+            }
+
+            std::shared_ptr<graphics::Material> getDefaultMaterial()
+            {
+                if (!defaultMaterial)
+                {
+                    defaultMaterial = std::make_shared<graphics::Material>();
+                    defaultMaterial->blendState = cache.getBlendState(blendNoBlend);
+                    defaultMaterial->shader = cache.getShader(shaderColor);
+                    defaultMaterial->cullMode = graphics::CullMode::back;
+                }
+
+                return defaultMaterial;
+            }
+
+            std::shared_ptr<graphics::Texture> getTexture(std::size_t index)
+            {
+                const auto& texture = document["textures"][index];
+                if (!texture.hasMember("source")) return nullptr;
+
+                const auto imageIndex = texture["source"].as<std::size_t>();
+                const auto& image = document["images"][imageIndex];
+
+                if (image.hasMember("uri") && !isDataUri(image["uri"].as<std::string>()))
+                {
+                    const auto filename = resolveUri(baseFilename, image["uri"].as<std::string>());
+
+                    auto result = bundle.getTexture(filename);
+                    if (!result)
+                    {
+                        bundle.loadAsset(Asset::Type::image, filename, filename, options);
+                        result = bundle.getTexture(filename);
+                    }
+
+                    return result;
+                }
+
+                // the embedded images are named after the model
+                const auto imageName = name + "#image" + std::to_string(imageIndex);
+
+                if (auto result = bundle.getTexture(imageName))
+                    return result;
+
+                bool loaded = false;
+                if (image.hasMember("uri"))
+                {
+                    const auto imageData = decodeDataUri(image["uri"].as<std::string>());
+                    loaded = loadImage(cache, bundle, imageName, Span<const std::byte>{imageData}, options);
+                }
+                else
+                    loaded = loadImage(cache, bundle, imageName,
+                                       buffers.getBufferView(document, image["bufferView"].as<std::size_t>()),
+                                       options);
+
+                if (!loaded)
+                    throw std::runtime_error{"Failed to load image " + imageName};
+
+                return bundle.getTexture(imageName);
+            }
+
+            Cache& cache;
+            Bundle& bundle;
+            const std::string& name;
+            const json::Value& document;
+            std::string baseFilename;
+            Buffers buffers;
+            const Asset::Options& options;
+            std::vector<std::size_t> nodeParents;
+            std::vector<std::shared_ptr<graphics::Material>> materials;
+            std::shared_ptr<graphics::Material> defaultMaterial;
+        };
+    }
+
+    bool loadGltf(Cache& cache,
+                  Bundle& bundle,
+                  const std::string& name,
+                  Span<const std::byte> data,
+                  const Asset::Options& options)
+    {
+        Container container;
+
+        if (isGlb(data))
+            container = readGlb(data);
+        else if (isGltf(data))
+            container.json = data;
+        else
+            return false;
+
+        const auto document = json::parse(container.json);
+
+        if (const auto& version = document["asset"]["version"].as<std::string>(); version.substr(0, 2) != "2.")
+            throw std::runtime_error{"Unsupported glTF version " + version};
+
+        GltfLoader loader{cache, bundle, name, document, container.binary, options};
+        loader.load();
+
+        return true;
+    }
+}
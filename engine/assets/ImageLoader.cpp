@@ -5,6 +5,7 @@
 #include "ImageLoader.hpp"
 #include "../core/Engine.hpp"
 #include "../graphics/Image.hpp"
+#include "../graphics/Mipmaps.hpp"
 #include "../graphics/Texture.hpp"
 
 #ifdef _MSC_VER
@@ -43,106 +44,114 @@
 
 namespace ouzel::assets
 {
-    bool loadImage(Cache&,
-                   Bundle& bundle,
-                   const std::string& name,
-                   const std::vector<std::byte>& data,
-                   const Asset::Options& options)
+    namespace
     {
-        int width;
-        int height;
-        int comp;
-
-        using ImageFreeFunction = void(*)(void*);
-        std::unique_ptr<stbi_uc, ImageFreeFunction> tempData{
-            stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
-                                  static_cast<int>(data.size()),
-                                  &width, &height,
-                                  &comp, STBI_default),
-            &stbi_image_free
-        };
-
-        if (!tempData)
-            throw std::runtime_error{"Failed to load texture, reason: " + std::string(stbi_failure_reason())};
-
-        graphics::PixelFormat pixelFormat;
-        std::vector<std::uint8_t> imageData;
-
-        switch (comp)
+        graphics::Image readImage(Span<const std::byte> data)
         {
-            case STBI_grey:
+            int width;
+            int height;
+            int comp;
+
+            using ImageFreeFunction = void(*)(void*);
+            std::unique_ptr<stbi_uc, ImageFreeFunction> tempData{
+                stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
+                                      static_cast<int>(data.size()),
+                                      &width, &height,
+                                      &comp, STBI_default),
+                &stbi_image_free
+            };
+
+            if (!tempData)
+                throw std::runtime_error{"Failed to load texture, reason: " + std::string(stbi_failure_reason())};
+
+            graphics::PixelFormat pixelFormat;
+            std::vector<std::uint8_t> imageData;
+
+            switch (comp)
             {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-
-                imageData.resize(static_cast<std::size_t>(width * height * 4));
-
-                for (int y = 0; y < height; ++y)
-                    for (int x = 0; x < width; ++x)
-                    {
-                        const auto sourceOffset = static_cast<std::size_t>(y * width + x);
-                        const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
-                        imageData[destinationOffset + 0] = tempData.get()[sourceOffset];
-                        imageData[destinationOffset + 1] = tempData.get()[sourceOffset];
-                        imageData[destinationOffset + 2] = tempData.get()[sourceOffset];
-                        imageData[destinationOffset + 3] = 255;
-                    }
-                break;
+                case STBI_grey:
+                {
+                    pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
+
+                    imageData.resize(static_cast<std::size_t>(width * height * 4));
+
+                    for (int y = 0; y < height; ++y)
+                        for (int x = 0; x < width; ++x)
+                        {
+                            const auto sourceOffset = static_cast<std::size_t>(y * width + x);
+                            const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
+                            imageData[destinationOffset + 0] = tempData.get()[sourceOffset];
+                            imageData[destinationOffset + 1] = tempData.get()[sourceOffset];
+                            imageData[destinationOffset + 2] = tempData.get()[sourceOffset];
+                            imageData[destinationOffset + 3] = 255;
+                        }
+                    break;
+                }
+                case STBI_grey_alpha:
+                {
+                    pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
+
+                    imageData.resize(static_cast<std::size_t>(width * height * 4));
+
+                    for (int y = 0; y < height; ++y)
+                        for (int x = 0; x < width; ++x)
+                        {
+                            const auto sourceOffset = static_cast<std::size_t>((y * width + x) * 2);
+                            const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
+                            imageData[destinationOffset + 0] = tempData.get()[sourceOffset + 0];
+                            imageData[destinationOffset + 1] = tempData.get()[sourceOffset + 0];
+                            imageData[destinationOffset + 2] = tempData.get()[sourceOffset + 0];
+                            imageData[destinationOffset + 3] = tempData.get()[sourceOffset + 1];
+                        }
+                    break;
+                }
+                case STBI_rgb:
+                {
+                    pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
+
+                    imageData.resize(static_cast<std::size_t>(width * height * 4));
+
+                    for (int y = 0; y < height; ++y)
+                        for (int x = 0; x < width; ++x)
+                        {
+                            const auto sourceOffset = static_cast<std::size_t>((y * width + x) * 3);
+                            const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
+                            imageData[destinationOffset + 0] = tempData.get()[sourceOffset + 0];
+                            imageData[destinationOffset + 1] = tempData.get()[sourceOffset + 1];
+                            imageData[destinationOffset + 2] = tempData.get()[sourceOffset + 2];
+                            imageData[destinationOffset + 3] = 255;
+                        }
+                    break;
+                }
+                case STBI_rgb_alpha:
+                {
+                    pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
+                    imageData.assign(tempData.get(),
+                                     tempData.get() + static_cast<std::size_t>(width * height) * 4);
+                    break;
+                }
+                default:
+                    throw std::runtime_error{"Unsupported pixel format"};
             }
-            case STBI_grey_alpha:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-
-                imageData.resize(static_cast<std::size_t>(width * height * 4));
-
-                for (int y = 0; y < height; ++y)
-                    for (int x = 0; x < width; ++x)
-                    {
-                        const auto sourceOffset = static_cast<std::size_t>((y * width + x) * 2);
-                        const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
-                        imageData[destinationOffset + 0] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 1] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 2] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 3] = tempData.get()[sourceOffset + 1];
-                    }
-                break;
-            }
-            case STBI_rgb:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-
-                imageData.resize(static_cast<std::size_t>(width * height * 4));
-
-                for (int y = 0; y < height; ++y)
-                    for (int x = 0; x < width; ++x)
-                    {
-                        const auto sourceOffset = static_cast<std::size_t>((y * width + x) * 3);
-                        const auto destinationOffset = static_cast<std::size_t>((y * width + x) * 4);
-                        imageData[destinationOffset + 0] = tempData.get()[sourceOffset + 0];
-                        imageData[destinationOffset + 1] = tempData.get()[sourceOffset + 1];
-                        imageData[destinationOffset + 2] = tempData.get()[sourceOffset + 2];
-                        imageData[destinationOffset + 3] = 255;
-                    }
-                break;
-            }
-            case STBI_rgb_alpha:
-            {
-                pixelFormat = graphics::PixelFormat::rgba8UnsignedNorm;
-                imageData.assign(tempData.get(),
-                                 tempData.get() + static_cast<std::size_t>(width * height) * 4);
-                break;
-            }
-            default:
-                throw std::runtime_error{"Unsupported pixel format"};
+
+            return graphics::Image{
+                pixelFormat,
+                math::Size<std::uint32_t, 2>{
+                    static_cast<std::uint32_t>(width),
+                    static_cast<std::uint32_t>(height)
+                },
+                imageData
+            };
         }
+    }
 
-        const graphics::Image image{
-            pixelFormat,
-            math::Size<std::uint32_t, 2>{
-                static_cast<std::uint32_t>(width),
-                static_cast<std::uint32_t>(height)
-            },
-            imageData
-        };
+    bool loadImage(Cache&,
+                   Bundle& bundle,
+                   const std::string& name,
+                   Span<const std::byte> data,
+                   const Asset::Options& options)
+    {
+        const auto image = readImage(data);
 
         auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
                                                            image.getData(),
@@ -155,4 +164,25 @@ namespace ouzel::assets
 
         return true;
     }
+
+    AssetPublisher decodeImage(const std::string& name,
+                               Span<const std::byte> data,
+                               const Asset::Options& options)
+    {
+        const auto image = readImage(data);
+
+        // the mip levels are generated on the calling thread, only the texture is created when publishing
+        auto levels = std::make_shared<const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>>(
+            graphics::generateMipmaps(image.getSize(), image.getData(), options.mipmaps ? 0 : 1, image.getPixelFormat()));
+
+        return [name, levels, size = image.getSize(), pixelFormat = image.getPixelFormat()](Cache&, Bundle& bundle) {
+            auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                               *levels,
+                                                               size,
+                                                               graphics::Flags::none,
+                                                               pixelFormat);
+
+            bundle.setTexture(name, texture);
+        };
+    }
 }
@@ -3,15 +3,19 @@
 #ifndef OUZEL_ASSETS_IMAGELOADER_HPP
 #define OUZEL_ASSETS_IMAGELOADER_HPP
 
-#include "Bundle.hpp"
+#include "Cache.hpp"
 
 namespace ouzel::assets
 {
     bool loadImage(Cache& cache,
                    Bundle& bundle,
                    const std::string& name,
-                   const std::vector<std::byte>& data,
+                   Span<const std::byte> data,
                    const Asset::Options& options);
+
+    AssetPublisher decodeImage(const std::string& name,
+                               Span<const std::byte> data,
+                               const Asset::Options& options);
 }
 
 #endif // OUZEL_ASSETS_IMAGELOADER_HPP
@@ -28,8 +28,8 @@ namespace ouzel::assets
             return static_cast<std::uint8_t>(c) <= 0x1F;
         }
 
-        void skipWhiteSpaces(std::vector<std::byte>::const_iterator& iterator,
-                             const std::vector<std::byte>::const_iterator end) noexcept
+        void skipWhiteSpaces(const std::byte*& iterator,
+                             const std::byte* const end) noexcept
         {
             while (iterator != end)
                 if (isWhiteSpace(*iterator))
@@ -38,16 +38,16 @@ namespace ouzel::assets
                     break;
         }
 
-        void skipLine(std::vector<std::byte>::const_iterator& iterator,
-                      const std::vector<std::byte>::const_iterator end) noexcept
+        void skipLine(const std::byte*& iterator,
+                      const std::byte* const end) noexcept
         {
             while (iterator != end)
                 if (isNewline(*iterator++))
                     break;
         }
 
-        void skipString(std::vector<std::byte>::const_iterator& iterator,
-                        const std::vector<std::byte>::const_iterator end)
+        void skipString(const std::byte*& iterator,
+                        const std::byte* const end)
         {
             std::size_t length = 0;
 
@@ -61,8 +61,8 @@ namespace ouzel::assets
                 throw std::runtime_error{"Invalid string"};
         }
 
-        [[nodiscard]] std::string parseString(std::vector<std::byte>::const_iterator& iterator,
-                                              const std::vector<std::byte>::const_iterator end)
+        [[nodiscard]] std::string parseString(const std::byte*& iterator,
+                                              const std::byte* const end)
         {
             std::string result;
 
@@ -78,8 +78,8 @@ namespace ouzel::assets
             return result;
         }
 
-        [[nodiscard]] float parseFloat(std::vector<std::byte>::const_iterator& iterator,
-                                       const std::vector<std::byte>::const_iterator end)
+        [[nodiscard]] float parseFloat(const std::byte*& iterator,
+                                       const std::byte* const end)
         {
             std::string value;
             std::uint32_t length = 1;
@@ -150,8 +150,8 @@ namespace ouzel::assets
             return std::stof(value);
         }
 
-        void skipTextureMapOptions(std::vector<std::byte>::const_iterator& iterator,
-                                   const std::vector<std::byte>::const_iterator end)
+        void skipTextureMapOptions(const std::byte*& iterator,
+                                   const std::byte* const end)
         {
             while (iterator != end)
             {
@@ -212,7 +212,7 @@ namespace ouzel::assets
     bool loadMtl(Cache& cache,
                  Bundle& bundle,
                  const std::string& name,
-                 const std::vector<std::byte>& data,
+                 Span<const std::byte> data,
                  const Asset::Options& options)
     {
         std::string materialName = name;
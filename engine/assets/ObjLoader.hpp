@@ -10,7 +10,7 @@ namespace ouzel::assets
     bool loadObj(Cache& cache,
                  Bundle& bundle,
                  const std::string& name,
-                 const std::vector<std::byte>& data,
+                 Span<const std::byte> data,
                  const Asset::Options& options);
 }
 
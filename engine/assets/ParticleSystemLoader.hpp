@@ -3,6 +3,8 @@
 #ifndef OUZEL_ASSETS_PARTICLESYSTEMLOADER_HPP
 #define OUZEL_ASSETS_PARTICLESYSTEMLOADER_HPP
 
+#include <optional>
+#include <string>
 #include "Bundle.hpp"
 #include "../scene/ParticleSystem.hpp"
 #include "../formats/Json.hpp"
@@ -12,107 +14,101 @@ namespace ouzel::assets
     inline bool loadParticleSystem(Cache&,
                                    Bundle& bundle,
                                    const std::string& name,
-                                   const std::vector<std::byte>& data,
+                                   Span<const std::byte> data,
                                    const Asset::Options& options)
     {
-        scene::ParticleSystemData particleSystemData;
-
-        const auto d = json::parse(data);
-
-        if (!d.hasMember("textureFileName") ||
-            !d.hasMember("configName"))
-            return false;
+        // the members are streamed into the particle system data without building a document
+        json::Reader reader{data};
 
-        particleSystemData.name = d["configName"].as<std::string>();
-
-        if (d.hasMember("blendFuncSource")) particleSystemData.blendFuncSource = d["blendFuncSource"].as<std::uint32_t>();
-        if (d.hasMember("blendFuncDestination")) particleSystemData.blendFuncDestination = d["blendFuncDestination"].as<std::uint32_t>();
-
-        if (d.hasMember("emitterType"))
-        {
-            switch (d["emitterType"].as<std::uint32_t>())
+        scene::ParticleSystemData particleSystemData;
+        std::optional<std::string> configName;
+        std::optional<std::string> textureFileName;
+
+        // flags can also be stored as numbers
+        const auto readFlag = [&reader]() {
+            return reader.peek() == json::Reader::Type::number ? reader.readNumber<std::uint32_t>() != 0 : reader.readBoolean();
+        };
+
+        reader.readObject([&reader, &readFlag, &particleSystemData, &configName, &textureFileName](std::string_view key) {
+            if (key == "configName") configName = reader.readString();
+            else if (key == "textureFileName") textureFileName = reader.readString();
+            else if (key == "blendFuncSource") particleSystemData.blendFuncSource = reader.readNumber<std::uint32_t>();
+            else if (key == "blendFuncDestination") particleSystemData.blendFuncDestination = reader.readNumber<std::uint32_t>();
+            else if (key == "emitterType")
             {
-                case 0: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::gravity; break;
-                case 1: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::radius; break;
-                default: throw std::runtime_error{"Unsupported emitter type"};
+                switch (reader.readNumber<std::uint32_t>())
+                {
+                    case 0: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::gravity; break;
+                    case 1: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::radius; break;
+                    default: throw std::runtime_error{"Unsupported emitter type"};
+                }
             }
-        }
-
-        if (d.hasMember("maxParticles")) particleSystemData.maxParticles = d["maxParticles"].as<std::uint32_t>();
-
-        if (d.hasMember("duration")) particleSystemData.duration = d["duration"].as<float>();
-        if (d.hasMember("particleLifespan")) particleSystemData.particleLifespan = d["particleLifespan"].as<float>();
-        if (d.hasMember("particleLifespanVariance")) particleSystemData.particleLifespanVariance = d["particleLifespanVariance"].as<float>();
-
-        if (d.hasMember("speed")) particleSystemData.speed = d["speed"].as<float>();
-        if (d.hasMember("speedVariance")) particleSystemData.speedVariance = d["speedVariance"].as<float>();
-
-        if (d.hasMember("absolutePosition")) particleSystemData.absolutePosition = d["absolutePosition"].as<bool>();
-
-        if (d.hasMember("yCoordFlipped")) particleSystemData.yCoordFlipped = (d["yCoordFlipped"].as<std::uint32_t>() == 1);
-
-        if (d.hasMember("sourcePositionx")) particleSystemData.sourcePosition.v[0] = d["sourcePositionx"].as<float>();
-        if (d.hasMember("sourcePositiony")) particleSystemData.sourcePosition.v[1] = d["sourcePositiony"].as<float>();
-        if (d.hasMember("sourcePositionVariancex")) particleSystemData.sourcePositionVariance.v[0] = d["sourcePositionVariancex"].as<float>();
-        if (d.hasMember("sourcePositionVariancey")) particleSystemData.sourcePositionVariance.v[1] = d["sourcePositionVariancey"].as<float>();
-
-        if (d.hasMember("startParticleSize")) particleSystemData.startParticleSize = d["startParticleSize"].as<float>();
-        if (d.hasMember("startParticleSizeVariance")) particleSystemData.startParticleSizeVariance = d["startParticleSizeVariance"].as<float>();
-        if (d.hasMember("finishParticleSize")) particleSystemData.finishParticleSize = d["finishParticleSize"].as<float>();
-        if (d.hasMember("finishParticleSizeVariance")) particleSystemData.finishParticleSizeVariance = d["finishParticleSizeVariance"].as<float>();
-        if (d.hasMember("angle")) particleSystemData.angle = d["angle"].as<float>();
-        if (d.hasMember("angleVariance")) particleSystemData.angleVariance = d["angleVariance"].as<float>();
-        if (d.hasMember("rotationStart")) particleSystemData.startRotation = d["rotationStart"].as<float>();
-        if (d.hasMember("rotationStartVariance")) particleSystemData.startRotationVariance = d["rotationStartVariance"].as<float>();
-        if (d.hasMember("rotationEnd")) particleSystemData.finishRotation = d["rotationEnd"].as<float>();
-        if (d.hasMember("rotationEndVariance")) particleSystemData.finishRotationVariance = d["rotationEndVariance"].as<float>();
-        if (d.hasMember("rotatePerSecond")) particleSystemData.rotatePerSecond = d["rotatePerSecond"].as<float>();
-        if (d.hasMember("rotatePerSecondVariance")) particleSystemData.rotatePerSecondVariance = d["rotatePerSecondVariance"].as<float>();
-        if (d.hasMember("minRadius")) particleSystemData.minRadius = d["minRadius"].as<float>();
-        if (d.hasMember("minRadiusVariance")) particleSystemData.minRadiusVariance = d["minRadiusVariance"].as<float>();
-        if (d.hasMember("maxRadius")) particleSystemData.maxRadius = d["maxRadius"].as<float>();
-        if (d.hasMember("maxRadiusVariance")) particleSystemData.maxRadiusVariance = d["maxRadiusVariance"].as<float>();
-
-        if (d.hasMember("radialAcceleration")) particleSystemData.radialAcceleration = d["radialAcceleration"].as<float>();
-        if (d.hasMember("radialAccelVariance")) particleSystemData.radialAccelVariance = d["radialAccelVariance"].as<float>();
-        if (d.hasMember("tangentialAcceleration")) particleSystemData.tangentialAcceleration = d["tangentialAcceleration"].as<float>();
-        if (d.hasMember("tangentialAccelVariance")) particleSystemData.tangentialAccelVariance = d["tangentialAccelVariance"].as<float>();
-
-        if (d.hasMember("rotationIsDir")) particleSystemData.rotationIsDir = d["rotationIsDir"].as<bool>();
-
-        if (d.hasMember("gravityx")) particleSystemData.gravity.v[0] = d["gravityx"].as<float>();
-        if (d.hasMember("gravityy")) particleSystemData.gravity.v[1] = d["gravityy"].as<float>();
-
-        if (d.hasMember("startColorRed")) particleSystemData.startColorRed = d["startColorRed"].as<float>();
-        if (d.hasMember("startColorGreen")) particleSystemData.startColorGreen = d["startColorGreen"].as<float>();
-        if (d.hasMember("startColorBlue")) particleSystemData.startColorBlue = d["startColorBlue"].as<float>();
-        if (d.hasMember("startColorAlpha")) particleSystemData.startColorAlpha = d["startColorAlpha"].as<float>();
-
-        if (d.hasMember("startColorVarianceRed")) particleSystemData.startColorRedVariance = d["startColorVarianceRed"].as<float>();
-        if (d.hasMember("startColorVarianceGreen")) particleSystemData.startColorGreenVariance = d["startColorVarianceGreen"].as<float>();
-        if (d.hasMember("startColorVarianceBlue")) particleSystemData.startColorBlueVariance = d["startColorVarianceBlue"].as<float>();
-        if (d.hasMember("startColorVarianceAlpha")) particleSystemData.startColorAlphaVariance = d["startColorVarianceAlpha"].as<float>();
-
-        if (d.hasMember("finishColorRed")) particleSystemData.finishColorRed = d["finishColorRed"].as<float>();
-        if (d.hasMember("finishColorGreen")) particleSystemData.finishColorGreen = d["finishColorGreen"].as<float>();
-        if (d.hasMember("finishColorBlue")) particleSystemData.finishColorBlue = d["finishColorBlue"].as<float>();
-        if (d.hasMember("finishColorAlpha")) particleSystemData.finishColorAlpha = d["finishColorAlpha"].as<float>();
+            else if (key == "maxParticles") particleSystemData.maxParticles = reader.readNumber<std::uint32_t>();
+            else if (key == "absolutePosition") particleSystemData.absolutePosition = readFlag();
+            else if (key == "yCoordFlipped") particleSystemData.yCoordFlipped = (reader.readNumber<std::uint32_t>() == 1);
+            else if (key == "rotationIsDir") particleSystemData.rotationIsDir = readFlag();
+            else if (key == "duration") particleSystemData.duration = reader.readNumber<float>();
+            else if (key == "particleLifespan") particleSystemData.particleLifespan = reader.readNumber<float>();
+            else if (key == "particleLifespanVariance") particleSystemData.particleLifespanVariance = reader.readNumber<float>();
+            else if (key == "speed") particleSystemData.speed = reader.readNumber<float>();
+            else if (key == "speedVariance") particleSystemData.speedVariance = reader.readNumber<float>();
+            else if (key == "sourcePositionx") particleSystemData.sourcePosition.v[0] = reader.readNumber<float>();
+            else if (key == "sourcePositiony") particleSystemData.sourcePosition.v[1] = reader.readNumber<float>();
+            else if (key == "sourcePositionVariancex") particleSystemData.sourcePositionVariance.v[0] = reader.readNumber<float>();
+            else if (key == "sourcePositionVariancey") particleSystemData.sourcePositionVariance.v[1] = reader.readNumber<float>();
+            else if (key == "startParticleSize") particleSystemData.startParticleSize = reader.readNumber<float>();
+            else if (key == "startParticleSizeVariance") particleSystemData.startParticleSizeVariance = reader.readNumber<float>();
+            else if (key == "finishParticleSize") particleSystemData.finishParticleSize = reader.readNumber<float>();
+            else if (key == "finishParticleSizeVariance") particleSystemData.finishParticleSizeVariance = reader.readNumber<float>();
+            else if (key == "angle") particleSystemData.angle = reader.readNumber<float>();
+            else if (key == "angleVariance") particleSystemData.angleVariance = reader.readNumber<float>();
+            else if (key == "rotationStart") particleSystemData.startRotation = reader.readNumber<float>();
+            else if (key == "rotationStartVariance") particleSystemData.startRotationVariance = reader.readNumber<float>();
+            else if (key == "rotationEnd") particleSystemData.finishRotation = reader.readNumber<float>();
+            else if (key == "rotationEndVariance") particleSystemData.finishRotationVariance = reader.readNumber<float>();
+            else if (key == "rotatePerSecond") particleSystemData.rotatePerSecond = reader.readNumber<float>();
+            else if (key == "rotatePerSecondVariance") particleSystemData.rotatePerSecondVariance = reader.readNumber<float>();
+            else if (key == "minRadius") particleSystemData.minRadius = reader.readNumber<float>();
+            else if (key == "minRadiusVariance") particleSystemData.minRadiusVariance = reader.readNumber<float>();
+            else if (key == "maxRadius") particleSystemData.maxRadius = reader.readNumber<float>();
+            else if (key == "maxRadiusVariance") particleSystemData.maxRadiusVariance = reader.readNumber<float>();
+            else if (key == "radialAcceleration") particleSystemData.radialAcceleration = reader.readNumber<float>();
+            else if (key == "radialAccelVariance") particleSystemData.radialAccelVariance = reader.readNumber<float>();
+            else if (key == "tangentialAcceleration") particleSystemData.tangentialAcceleration = reader.readNumber<float>();
+            else if (key == "tangentialAccelVariance") particleSystemData.tangentialAccelVariance = reader.readNumber<float>();
+            else if (key == "gravityx") particleSystemData.gravity.v[0] = reader.readNumber<float>();
+            else if (key == "gravityy") particleSystemData.gravity.v[1] = reader.readNumber<float>();
+            else if (key == "startColorRed") particleSystemData.startColorRed = reader.readNumber<float>();
+            else if (key == "startColorGreen") particleSystemData.startColorGreen = reader.readNumber<float>();
+            else if (key == "startColorBlue") particleSystemData.startColorBlue = reader.readNumber<float>();
+            else if (key == "startColorAlpha") particleSystemData.startColorAlpha = reader.readNumber<float>();
+            else if (key == "startColorVarianceRed") particleSystemData.startColorRedVariance = reader.readNumber<float>();
+            else if (key == "startColorVarianceGreen") particleSystemData.startColorGreenVariance = reader.readNumber<float>();
+            else if (key == "startColorVarianceBlue") particleSystemData.startColorBlueVariance = reader.readNumber<float>();
+            else if (key == "startColorVarianceAlpha") particleSystemData.startColorAlphaVariance = reader.readNumber<float>();
+            else if (key == "finishColorRed") particleSystemData.finishColorRed = reader.readNumber<float>();
+            else if (key == "finishColorGreen") particleSystemData.finishColorGreen = reader.readNumber<float>();
+            else if (key == "finishColorBlue") particleSystemData.finishColorBlue = reader.readNumber<float>();
+            else if (key == "finishColorAlpha") particleSystemData.finishColorAlpha = reader.readNumber<float>();
+            else if (key == "finishColorVarianceRed") particleSystemData.finishColorRedVariance = reader.readNumber<float>();
+            else if (key == "finishColorVarianceGreen") particleSystemData.finishColorGreenVariance = reader.readNumber<float>();
+            else if (key == "finishColorVarianceBlue") particleSystemData.finishColorBlueVariance = reader.readNumber<float>();
+            else if (key == "finishColorVarianceAlpha") particleSystemData.finishColorAlphaVariance = reader.readNumber<float>();
+            else reader.skip();
+        });
+
+        reader.readEnd();
+
+        if (!textureFileName || !configName)
+            return false;
 
-        if (d.hasMember("finishColorVarianceRed")) particleSystemData.finishColorRedVariance = d["finishColorVarianceRed"].as<float>();
-        if (d.hasMember("finishColorVarianceGreen")) particleSystemData.finishColorGreenVariance = d["finishColorVarianceGreen"].as<float>();
-        if (d.hasMember("finishColorVarianceBlue")) particleSystemData.finishColorBlueVariance = d["finishColorVarianceBlue"].as<float>();
-        if (d.hasMember("finishColorVarianceAlpha")) particleSystemData.finishColorAlphaVariance = d["finishColorVarianceAlpha"].as<float>();
+        particleSystemData.name = *configName;
 
-        if (d.hasMember("textureFileName"))
+        particleSystemData.texture = bundle.getTexture(*textureFileName);
+        if (!particleSystemData.texture)
         {
-            const auto textureFileName = d["textureFileName"].as<std::string>();
-            particleSystemData.texture = bundle.getTexture(textureFileName);
-
-            if (!particleSystemData.texture)
-            {
-                bundle.loadAsset(Asset::Type::image, textureFileName, textureFileName, options);
-                particleSystemData.texture = bundle.getTexture(textureFileName);
-            }
+            bundle.loadAsset(Asset::Type::image, *textureFileName, *textureFileName, options);
+            particleSystemData.texture = bundle.getTexture(*textureFileName);
         }
 
         particleSystemData.emissionRate = static_cast<float>(particleSystemData.maxParticles) / particleSystemData.particleLifespan;
@@ -14,7 +14,7 @@ namespace ouzel::assets
     inline bool loadSpriteSheet(Cache&,
                                 Bundle& bundle,
                                 const std::string& name,
-                                const std::vector<std::byte>& data,
+                                Span<const std::byte> data,
                                 const Asset::Options& options)
     {
         const auto d = json::parse(data);
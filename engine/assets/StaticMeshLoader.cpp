@@ -0,0 +1,36 @@
+// Ouzel by Elviss Strazdins
+
+#include "StaticMeshLoader.hpp"
+#include "../formats/Omesh.hpp"
+#include "../graphics/Material.hpp"
+
+namespace ouzel::assets
+{
+    bool loadStaticMesh(Cache&,
+                        Bundle& bundle,
+                        const std::string& name,
+                        Span<const std::byte> data,
+                        const Asset::Options& options)
+    {
+        if (!omesh::isOmesh(data.data(), data.size()))
+            return false;
+
+        const omesh::Data content{data.data(), data.size()};
+
+        for (const auto materialLibrary : content.getMaterialLibraries())
+            bundle.loadAsset(Asset::Type::material, std::string{materialLibrary}, std::string{materialLibrary}, options);
+
+        // the index and vertex data is passed to the buffers as it is stored in the file
+        for (const auto& mesh : content.getMeshes())
+            bundle.setStaticMeshData(mesh.name.empty() ? std::string_view{name} : mesh.name,
+                                     scene::StaticMeshData{
+                                         mesh.boundingBox,
+                                         mesh.indexSize,
+                                         mesh.indexData,
+                                         mesh.vertexData,
+                                         mesh.material.empty() ? nullptr : bundle.getMaterial(mesh.material)
+                                     });
+
+        return true;
+    }
+}
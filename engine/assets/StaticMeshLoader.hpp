@@ -0,0 +1,18 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_STATICMESHLOADER_HPP
+#define OUZEL_ASSETS_STATICMESHLOADER_HPP
+
+#include "Bundle.hpp"
+
+namespace ouzel::assets
+{
+    // loads precompiled .omesh meshes, returns false for other data
+    bool loadStaticMesh(Cache& cache,
+                        Bundle& bundle,
+                        const std::string& name,
+                        Span<const std::byte> data,
+                        const Asset::Options& options);
+}
+
+#endif // OUZEL_ASSETS_STATICMESHLOADER_HPP
@@ -0,0 +1,74 @@
+// Ouzel by Elviss Strazdins
+
+#include <memory>
+#include "TextureLoader.hpp"
+#include "../core/Engine.hpp"
+#include "../formats/Otexture.hpp"
+#include "../graphics/Texture.hpp"
+
+namespace ouzel::assets
+{
+    namespace
+    {
+        using Levels = std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>;
+
+        // the levels are copied as they are, without any decoding or conversion
+        Levels readLevels(const otexture::Data& texture, const Asset::Options& options)
+        {
+            const auto& textureLevels = texture.getLevels();
+            const auto levelCount = options.mipmaps ? textureLevels.size() : 1;
+
+            Levels levels;
+            levels.reserve(levelCount);
+
+            for (std::size_t i = 0; i < levelCount; ++i)
+            {
+                const auto& level = textureLevels[i];
+                const auto levelData = reinterpret_cast<const std::uint8_t*>(level.data);
+                levels.emplace_back(level.size, std::vector<std::uint8_t>(levelData, levelData + level.dataSize));
+            }
+
+            return levels;
+        }
+    }
+
+    bool loadTexture(Cache&,
+                     Bundle& bundle,
+                     const std::string& name,
+                     Span<const std::byte> data,
+                     const Asset::Options& options)
+    {
+        if (!otexture::isOtexture(data.data(), data.size()))
+            return false;
+
+        const otexture::Data texture{data.data(), data.size()};
+
+        bundle.setTexture(name, std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                                    readLevels(texture, options),
+                                                                    texture.getSize(),
+                                                                    graphics::Flags::none,
+                                                                    texture.getPixelFormat()));
+
+        return true;
+    }
+
+    AssetPublisher decodeTexture(const std::string& name,
+                                 Span<const std::byte> data,
+                                 const Asset::Options& options)
+    {
+        if (!otexture::isOtexture(data.data(), data.size()))
+            return nullptr;
+
+        const otexture::Data texture{data.data(), data.size()};
+
+        auto levels = std::make_shared<Levels>(readLevels(texture, options));
+
+        return [name, levels, size = texture.getSize(), pixelFormat = texture.getPixelFormat()](Cache&, Bundle& bundle) {
+            bundle.setTexture(name, std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                                        std::move(*levels),
+                                                                        size,
+                                                                        graphics::Flags::none,
+                                                                        pixelFormat));
+        };
+    }
+}
@@ -0,0 +1,22 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_ASSETS_TEXTURELOADER_HPP
+#define OUZEL_ASSETS_TEXTURELOADER_HPP
+
+#include "Cache.hpp"
+
+namespace ouzel::assets
+{
+    // loads a precompiled .otexture, returns false for other data
+    bool loadTexture(Cache& cache,
+                     Bundle& bundle,
+                     const std::string& name,
+                     Span<const std::byte> data,
+                     const Asset::Options& options);
+
+    AssetPublisher decodeTexture(const std::string& name,
+                                 Span<const std::byte> data,
+                                 const Asset::Options& options);
+}
+
+#endif // OUZEL_ASSETS_TEXTURELOADER_HPP
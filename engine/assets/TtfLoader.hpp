@@ -12,7 +12,7 @@ namespace ouzel::assets
     inline bool loadTtf(Cache&,
                         Bundle& bundle,
                         const std::string& name,
-                        const std::vector<std::byte>& data,
+                        Span<const std::byte> data,
                         const Asset::Options& options)
     {
         try
@@ -12,12 +12,13 @@ namespace ouzel::assets
     inline bool loadVorbis(Cache&,
                            Bundle& bundle,
                            const std::string& name,
-                           const std::vector<std::byte>& data,
+                           Span<const std::byte> data,
                            const Asset::Options&)
     {
         try
         {
-            auto sound = std::make_unique<audio::VorbisClip>(engine->getAudio(), data);
+            // the clip decodes from the mapped file instead of a copy
+            auto sound = std::make_unique<audio::VorbisClip>(engine->getAudio(), bundle.retainData(data));
             bundle.setSound(name, std::move(sound));
         }
         catch (const std::exception&)
@@ -29,7 +29,7 @@ namespace ouzel::assets
     bool loadWave(Cache&,
                   Bundle& bundle,
                   const std::string& name,
-                  const std::vector<std::byte>& data,
+                  Span<const std::byte> data,
                   const Asset::Options&)
     {
         try
@@ -143,7 +143,10 @@ namespace ouzel::audio
                                            std::placeholders::_3,
                                            std::placeholders::_4),
                                  settings)},
-        mixer{device->getBufferSize(), device->getChannels()},
+        mixer{device->getBufferSize(), device->getChannels(),
+              settings.pcmCacheSize, settings.pcmCacheFormat},
+        pcmCacheMaxLength{settings.pcmCacheMaxLength},
+        voiceManager{*this, settings.maxVoices},
         masterMix{*this},
         rootNode{*this} // mixer.getRootObjectId()
     {
@@ -173,13 +176,15 @@ namespace ouzel::audio
                     // TODO: send reset event
                     break;
                 case mixer::Mixer::Event::Type::streamStopped:
-                    // TODO: send stopped event
+                    voiceManager.finishStream(event.objectId);
                     break;
                 case mixer::Mixer::Event::Type::starvation:
                     break;
             }
         }
 
+        voiceManager.update();
+
         mixer.submitCommandBuffer(std::move(commandBuffer));
         commandBuffer = mixer::CommandBuffer();
     }
@@ -13,6 +13,7 @@
 #include "Mix.hpp"
 #include "Node.hpp"
 #include "Settings.hpp"
+#include "VoiceManager.hpp"
 #include "mixer/Commands.hpp"
 #include "mixer/Processor.hpp"
 #include "mixer/Mixer.hpp"
@@ -52,6 +53,9 @@ namespace ouzel::audio
                              const std::function<void(mixer::Processor*)>& updateFunction);
 
         auto& getRootNode() { return rootNode; }
+        auto& getVoiceManager() noexcept { return voiceManager; }
+
+        auto getPcmCacheMaxLength() const noexcept { return pcmCacheMaxLength; }
 
     private:
         void getSamples(std::uint32_t frames,
@@ -61,6 +65,8 @@ namespace ouzel::audio
 
         std::unique_ptr<AudioDevice> device;
         mixer::Mixer mixer;
+        float pcmCacheMaxLength;
+        VoiceManager voiceManager;
         mixer::CommandBuffer commandBuffer;
         Mix masterMix;
         Node rootNode;
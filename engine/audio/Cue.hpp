@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_BANK_HPP
 #define OUZEL_AUDIO_BANK_HPP
 
+#include <cstdint>
 #include <queue>
 #include <string>
 #include <vector>
@@ -39,6 +40,8 @@ namespace ouzel::audio
         float scale = 1.0F;
         float shift = 1.0f;
         float decay = 0.0F;
+        float cutoffFrequency = 1000.0F;
+        float resonance = 0.7071F;
         std::pair<float, float> delayRandom{0.0F, 0.0F};
         std::pair<float, float> gainRandom{0.0F, 0.0F};
         std::pair<float, float> scaleRandom{0.0F, 0.0F};
@@ -83,8 +86,13 @@ namespace ouzel::audio
             return sourceDefinition;
         }
 
+        // voices of cues with higher priority are kept real when the voice limit is reached
+        auto getPriority() const noexcept { return priority; }
+        void setPriority(std::int32_t newPriority) noexcept { priority = newPriority; }
+
     private:
         SourceDefinition sourceDefinition;
+        std::int32_t priority = 0;
     };
 }
 
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include "Node.hpp"
+#include "../math/Vector.hpp"
 
 namespace ouzel::audio
 {
@@ -29,6 +30,9 @@ namespace ouzel::audio
         auto isEnabled() const noexcept { return enabled; }
         void setEnabled(bool newEnabled);
 
+        // rough gain of the effect for a listener at the given position, used for voice virtualization
+        virtual float estimateGain(const math::Vector<float, 3>&) const noexcept { return 1.0F; }
+
     protected:
         Audio& audio;
         std::size_t processorId = 0;
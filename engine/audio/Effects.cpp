@@ -1,9 +1,11 @@
 // Ouzel by Elviss Strazdins
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include "Effects.hpp"
 #include "Audio.hpp"
+#include "mixer/DelayLine.hpp"
 #include "../scene/Actor.hpp"
 #include "../math/Scalar.hpp"
 #include "smbPitchShift.hpp"
@@ -21,28 +23,22 @@ namespace ouzel::audio
         void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
                      std::vector<float>& samples) override
         {
-            const auto delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
-            const auto bufferFrames = frames + delayFrames;
+            const auto delayFrames = delay * static_cast<float>(sampleRate);
 
-            buffer.resize(bufferFrames * channels);
+            delayLines.resize(channels);
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
             {
-                const auto bufferChannel = &buffer[channel * bufferFrames];
-                const auto outputChannel = &samples[channel * frames];
+                auto& delayLine = delayLines[channel];
+                delayLine.setMaxDelay(static_cast<std::size_t>(delayFrames) + 1);
 
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    bufferChannel[frame + delayFrames] += outputChannel[frame];
+                const auto outputChannel = &samples[channel * frames];
 
                 for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    outputChannel[frame] = bufferChannel[frame];
-
-                // erase frames from beginning
-                for (std::uint32_t frame = 0; frame < bufferFrames - frames; ++frame)
-                    bufferChannel[frame] = bufferChannel[frame + frames];
-
-                for (std::uint32_t frame = bufferFrames - frames; frame < bufferFrames; ++frame)
-                    bufferChannel[frame] = 0.0F;
+                {
+                    delayLine.write(outputChannel[frame]);
+                    outputChannel[frame] = delayLine.read(delayFrames);
+                }
             }
         }
 
@@ -53,7 +49,7 @@ namespace ouzel::audio
 
     private:
         float delay = 0.0F;
-        std::vector<float> buffer;
+        std::vector<mixer::DelayLine> delayLines;
     };
 
     Delay::Delay(Audio& initAudio, float initDelay):
@@ -133,6 +129,11 @@ namespace ouzel::audio
         // TODO: pass to processor
     }
 
+    float Gain::estimateGain(const math::Vector<float, 3>&) const noexcept
+    {
+        return std::pow(10.0F, gain / 20.0F);
+    }
+
     class PannerProcessor final: public mixer::Processor
     {
     public:
@@ -220,6 +221,16 @@ namespace ouzel::audio
         });
     }
 
+    float Panner::estimateGain(const math::Vector<float, 3>& listenerPosition) const noexcept
+    {
+        // inverse distance clamped attenuation
+        const auto distance = math::distance(position, listenerPosition);
+        if (distance >= maxDistance) return 0.0F;
+        if (distance <= minDistance) return 1.0F;
+
+        return minDistance / (minDistance + rolloffFactor * (distance - minDistance));
+    }
+
     void Panner::updateTransform()
     {
         setPosition(actor->getWorldPosition());
@@ -231,18 +242,21 @@ namespace ouzel::audio
         constexpr float maxPitch = 2.0F;
     }
 
+    // used by both PitchScale and PitchShift
     class PitchScaleProcessor final: public mixer::Processor
     {
     public:
-        explicit PitchScaleProcessor(float initScale):
-            scale{std::clamp(initScale, minPitch, maxPitch)}
+        PitchScaleProcessor(float initScale, std::uint32_t channels):
+            scale{std::clamp(initScale, minPitch, maxPitch)},
+            pitchShift(channels) // the FFT buffers are allocated up front, not on the audio thread
         {
         }
 
         void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
                      std::vector<float>& samples) override
         {
-            pitchShift.resize(channels);
+            if (pitchShift.size() < channels)
+                pitchShift.resize(channels);
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
                 pitchShift[channel].process(scale, frames, sampleRate,
@@ -263,7 +277,8 @@ namespace ouzel::audio
     PitchScale::PitchScale(Audio& initAudio, float initScale):
         Effect{
             initAudio,
-            initAudio.initProcessor(std::make_unique<PitchScaleProcessor>(initScale))
+            initAudio.initProcessor(std::make_unique<PitchScaleProcessor>(initScale,
+                                                                         initAudio.getDevice()->getChannels()))
         },
         scale{initScale}
     {
@@ -285,33 +300,11 @@ namespace ouzel::audio
         // TODO: pass to processor
     }
 
-    class PitchShiftProcessor final: public mixer::Processor
-    {
-    public:
-        explicit PitchShiftProcessor(float initShift) noexcept:
-            shift{initShift}
-        {
-        }
-
-        void process(std::uint32_t, std::uint32_t, std::uint32_t,
-                     std::vector<float>&) override
-        {
-            // TODO: implement
-        }
-
-        void setShift(const float newShift) noexcept
-        {
-            shift = newShift;
-        }
-
-    private:
-        float shift = 1.0f;
-    };
-
     PitchShift::PitchShift(Audio& initAudio, float initShift):
         Effect{
             initAudio,
-            initAudio.initProcessor(std::make_unique<PitchShiftProcessor>(initShift))
+            initAudio.initProcessor(std::make_unique<PitchScaleProcessor>(initShift,
+                                                                         initAudio.getDevice()->getChannels()))
         },
         shift{initShift}
     {
@@ -322,8 +315,8 @@ namespace ouzel::audio
         shift = newShift;
 
         audio.updateProcessor(processorId, [newShift](mixer::Object* node) {
-            const auto pitchShiftProcessor = static_cast<PitchShiftProcessor*>(node);
-            pitchShiftProcessor->setShift(newShift);
+            const auto pitchScaleProcessor = static_cast<PitchScaleProcessor*>(node);
+            pitchScaleProcessor->setScale(newShift);
         });
     }
 
@@ -344,36 +337,57 @@ namespace ouzel::audio
         void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
                      std::vector<float>& samples) override
         {
-            const auto delayFrames = static_cast<std::uint32_t>(delay * sampleRate);
-            const auto bufferFrames = frames + delayFrames;
+            // irregular ratios between the line lengths, so that the echoes of the lines rarely coincide
+            constexpr float lengthRatios[lineCount] = {1.0F, 1.1347F, 1.2681F, 1.3953F};
+
+            std::size_t lengths[lineCount];
+            for (std::size_t line = 0; line < lineCount; ++line)
+                lengths[line] = std::max(static_cast<std::size_t>(delay * lengthRatios[line] * static_cast<float>(sampleRate)),
+                                         std::size_t{1}) - 1; // the write of the current sample adds one sample of delay
 
-            buffers.resize(channels);
+            networks.resize(channels);
 
             for (std::uint32_t channel = 0; channel < channels; ++channel)
             {
-                auto& buffer = buffers[channel];
-                buffer.resize(bufferFrames);
+                auto& delayLines = networks[channel];
 
-                const auto outputChannel = &samples[channel * frames];
-
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    buffer[frame] += outputChannel[frame];
+                for (std::size_t line = 0; line < lineCount; ++line)
+                    delayLines[line].setMaxDelay(lengths[line]);
 
-                for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    buffer[frame + delayFrames] += buffer[frame] * decay;
+                const auto outputChannel = &samples[channel * frames];
 
                 for (std::uint32_t frame = 0; frame < frames; ++frame)
-                    outputChannel[frame] = buffer[frame];
-
-                // erase frames from beginning
-                buffer.erase(buffer.begin(), buffer.begin() + frames);
+                {
+                    const auto input = outputChannel[frame];
+
+                    float lineOutputs[lineCount];
+                    for (std::size_t line = 0; line < lineCount; ++line)
+                        lineOutputs[line] = delayLines[line].read(lengths[line]);
+
+                    // feedback through a normalized 4x4 Hadamard matrix, which is lossless,
+                    // so decay alone controls the reverberation time
+                    const float feedback[lineCount] = {
+                        0.5F * (lineOutputs[0] + lineOutputs[1] + lineOutputs[2] + lineOutputs[3]),
+                        0.5F * (lineOutputs[0] - lineOutputs[1] + lineOutputs[2] - lineOutputs[3]),
+                        0.5F * (lineOutputs[0] + lineOutputs[1] - lineOutputs[2] - lineOutputs[3]),
+                        0.5F * (lineOutputs[0] - lineOutputs[1] - lineOutputs[2] + lineOutputs[3])
+                    };
+
+                    for (std::size_t line = 0; line < lineCount; ++line)
+                        delayLines[line].write(input + feedback[line] * decay);
+
+                    outputChannel[frame] = input + (lineOutputs[0] + lineOutputs[1] +
+                                                    lineOutputs[2] + lineOutputs[3]) * decay * 0.25F;
+                }
             }
         }
 
     private:
+        static constexpr std::size_t lineCount = 4;
+
         float delay = 0.1F;
         float decay = 0.5F;
-        std::vector<std::vector<float>> buffers;
+        std::vector<std::array<mixer::DelayLine, lineCount>> networks; // feedback delay network per channel
     };
 
     Reverb::Reverb(Audio& initAudio, float initDelay, float initDecay):
@@ -386,41 +400,257 @@ namespace ouzel::audio
     {
     }
 
+    namespace
+    {
+        constexpr float minCutoffFrequency = 10.0F;
+        constexpr float smoothingTime = 0.02F; // seconds to reach ~63% of a new cutoff frequency
+
+        // Second order IIR filter (RBJ audio EQ cookbook) in the transposed direct form II
+        class BiquadFilter final
+        {
+        public:
+            enum class Type
+            {
+                lowPass,
+                highPass
+            };
+
+            BiquadFilter(Type initType, float initCutoffFrequency, float initResonance, std::uint32_t initChannels):
+                type{initType},
+                cutoffFrequency{initCutoffFrequency},
+                targetCutoffFrequency{initCutoffFrequency},
+                resonance{initResonance},
+                z1(initChannels),
+                z2(initChannels)
+            {
+            }
+
+            void setCutoffFrequency(float newCutoffFrequency) noexcept
+            {
+                targetCutoffFrequency = newCutoffFrequency;
+            }
+
+            void setResonance(float newResonance) noexcept
+            {
+                resonance = newResonance;
+                coefficientsValid = false;
+            }
+
+            void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                         std::vector<float>& samples)
+            {
+                if (frames == 0) return;
+
+                if (z1.size() < channels)
+                {
+                    z1.resize(channels);
+                    z2.resize(channels);
+                }
+
+                if (!coefficientsValid || sampleRate != currentSampleRate)
+                {
+                    currentSampleRate = sampleRate;
+                    coefficients = calculateCoefficients(cutoffFrequency, sampleRate);
+                    coefficientsValid = true;
+                }
+
+                // exponential smoothing of the cutoff frequency from block to block,
+                // the coefficients are ramped linearly within the block to avoid zipper noise
+                const auto smoothing = std::exp(-static_cast<float>(frames) / (smoothingTime * static_cast<float>(sampleRate)));
+                cutoffFrequency = targetCutoffFrequency + (cutoffFrequency - targetCutoffFrequency) * smoothing;
+
+                const auto startCoefficients = coefficients;
+                coefficients = calculateCoefficients(cutoffFrequency, sampleRate);
+
+                Coefficients step;
+                for (std::size_t i = 0; i < 5; ++i)
+                    step.values[i] = (coefficients.values[i] - startCoefficients.values[i]) / static_cast<float>(frames);
+
+                auto current = startCoefficients;
+                auto s1 = z1.data();
+                auto s2 = z2.data();
+
+                for (std::uint32_t frame = 0; frame < frames; ++frame)
+                {
+                    for (std::size_t i = 0; i < 5; ++i)
+                        current.values[i] += step.values[i];
+
+                    const auto [b0, b1, b2, a1, a2] = current.values;
+
+                    // all channels share the coefficients and have independent state
+                    for (std::uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        auto& sample = samples[channel * frames + frame];
+                        const auto input = sample;
+                        const auto output = b0 * input + s1[channel];
+                        s1[channel] = b1 * input - a1 * output + s2[channel];
+                        s2[channel] = b2 * input - a2 * output;
+                        sample = output;
+                    }
+                }
+            }
+
+        private:
+            struct Coefficients final
+            {
+                float values[5]{}; // b0, b1, b2, a1, a2 normalized by a0
+            };
+
+            Coefficients calculateCoefficients(float frequency, std::uint32_t sampleRate) const noexcept
+            {
+                const auto nyquist = static_cast<float>(sampleRate) * 0.5F;
+                const auto clampedFrequency = std::clamp(frequency, minCutoffFrequency, nyquist * 0.99F);
+                const auto omega = 2.0F * math::pi<float> * clampedFrequency / static_cast<float>(sampleRate);
+                const auto cosOmega = std::cos(omega);
+                const auto alpha = std::sin(omega) / (2.0F * std::max(resonance, 0.01F));
+                const auto a0 = 1.0F + alpha;
+
+                Coefficients result;
+                if (type == Type::lowPass)
+                {
+                    result.values[0] = (1.0F - cosOmega) * 0.5F / a0;
+                    result.values[1] = (1.0F - cosOmega) / a0;
+                }
+                else
+                {
+                    result.values[0] = (1.0F + cosOmega) * 0.5F / a0;
+                    result.values[1] = -(1.0F + cosOmega) / a0;
+                }
+                result.values[2] = result.values[0];
+                result.values[3] = -2.0F * cosOmega / a0;
+                result.values[4] = (1.0F - alpha) / a0;
+                return result;
+            }
+
+            Type type;
+            float cutoffFrequency;
+            float targetCutoffFrequency;
+            float resonance;
+            std::uint32_t currentSampleRate = 0;
+            bool coefficientsValid = false;
+            Coefficients coefficients;
+            std::vector<float> z1;
+            std::vector<float> z2;
+        };
+    }
+
     class LowPassProcessor final: public mixer::Processor
     {
     public:
-        void process([[maybe_unused]] std::uint32_t frames,
-                     [[maybe_unused]] std::uint32_t channels,
-                     [[maybe_unused]] std::uint32_t sampleRate,
-                     [[maybe_unused]] std::vector<float>& samples) override
+        LowPassProcessor(float initCutoffFrequency, float initResonance, std::uint32_t channels):
+            filter{BiquadFilter::Type::lowPass, initCutoffFrequency, initResonance, channels}
+        {
+        }
+
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     std::vector<float>& samples) override
+        {
+            filter.process(frames, channels, sampleRate, samples);
+        }
+
+        void setCutoffFrequency(float newCutoffFrequency) noexcept
+        {
+            filter.setCutoffFrequency(newCutoffFrequency);
+        }
+
+        void setResonance(float newResonance) noexcept
         {
+            filter.setResonance(newResonance);
         }
+
+    private:
+        BiquadFilter filter;
     };
 
-    LowPass::LowPass(Audio& initAudio):
+    LowPass::LowPass(Audio& initAudio, float initCutoffFrequency, float initResonance):
         Effect{
             initAudio,
-            initAudio.initProcessor(std::unique_ptr<LowPassProcessor>())
-        }
+            initAudio.initProcessor(std::make_unique<LowPassProcessor>(initCutoffFrequency,
+                                                                       initResonance,
+                                                                       initAudio.getDevice()->getChannels()))
+        },
+        cutoffFrequency{initCutoffFrequency},
+        resonance{initResonance}
     {
     }
 
+    void LowPass::setCutoffFrequency(float newCutoffFrequency)
+    {
+        cutoffFrequency = newCutoffFrequency;
+
+        audio.updateProcessor(processorId, [newCutoffFrequency](mixer::Object* node) {
+            const auto lowPassProcessor = static_cast<LowPassProcessor*>(node);
+            lowPassProcessor->setCutoffFrequency(newCutoffFrequency);
+        });
+    }
+
+    void LowPass::setResonance(float newResonance)
+    {
+        resonance = newResonance;
+
+        audio.updateProcessor(processorId, [newResonance](mixer::Object* node) {
+            const auto lowPassProcessor = static_cast<LowPassProcessor*>(node);
+            lowPassProcessor->setResonance(newResonance);
+        });
+    }
+
     class HighPassProcessor final: public mixer::Processor
     {
     public:
-        void process([[maybe_unused]] std::uint32_t frames,
-                     [[maybe_unused]] std::uint32_t channels,
-                     [[maybe_unused]] std::uint32_t sampleRate,
-                     [[maybe_unused]] std::vector<float>& samples) override
+        HighPassProcessor(float initCutoffFrequency, float initResonance, std::uint32_t channels):
+            filter{BiquadFilter::Type::highPass, initCutoffFrequency, initResonance, channels}
+        {
+        }
+
+        void process(std::uint32_t frames, std::uint32_t channels, std::uint32_t sampleRate,
+                     std::vector<float>& samples) override
+        {
+            filter.process(frames, channels, sampleRate, samples);
+        }
+
+        void setCutoffFrequency(float newCutoffFrequency) noexcept
+        {
+            filter.setCutoffFrequency(newCutoffFrequency);
+        }
+
+        void setResonance(float newResonance) noexcept
         {
+            filter.setResonance(newResonance);
         }
+
+    private:
+        BiquadFilter filter;
     };
 
-    HighPass::HighPass(Audio& initAudio):
+    HighPass::HighPass(Audio& initAudio, float initCutoffFrequency, float initResonance):
         Effect{
             initAudio,
-            initAudio.initProcessor(std::unique_ptr<HighPassProcessor>())
-        }
+            initAudio.initProcessor(std::make_unique<HighPassProcessor>(initCutoffFrequency,
+                                                                        initResonance,
+                                                                        initAudio.getDevice()->getChannels()))
+        },
+        cutoffFrequency{initCutoffFrequency},
+        resonance{initResonance}
+    {
+    }
+
+    void HighPass::setCutoffFrequency(float newCutoffFrequency)
     {
+        cutoffFrequency = newCutoffFrequency;
+
+        audio.updateProcessor(processorId, [newCutoffFrequency](mixer::Object* node) {
+            const auto highPassProcessor = static_cast<HighPassProcessor*>(node);
+            highPassProcessor->setCutoffFrequency(newCutoffFrequency);
+        });
+    }
+
+    void HighPass::setResonance(float newResonance)
+    {
+        resonance = newResonance;
+
+        audio.updateProcessor(processorId, [newResonance](mixer::Object* node) {
+            const auto highPassProcessor = static_cast<HighPassProcessor*>(node);
+            highPassProcessor->setResonance(newResonance);
+        });
     }
 }
@@ -48,6 +48,8 @@ namespace ouzel::audio
         auto& getGainRandom() const noexcept { return gainRandom; }
         void setGainRandom(const std::pair<float, float>& newGainRandom);
 
+        float estimateGain(const math::Vector<float, 3>& listenerPosition) const noexcept override;
+
     private:
         float gain = 0.0F; // dB
         std::pair<float, float> gainRandom{0.0F, 0.0F};
@@ -75,6 +77,8 @@ namespace ouzel::audio
         auto getMaxDistance() const noexcept { return maxDistance; }
         void setMaxDistance(float newMaxDistance);
 
+        float estimateGain(const math::Vector<float, 3>& listenerPosition) const noexcept override;
+
     private:
         void updateTransform() override;
 
@@ -147,23 +151,47 @@ namespace ouzel::audio
     class LowPass final: public Effect
     {
     public:
-        explicit LowPass(Audio& initAudio);
+        explicit LowPass(Audio& initAudio,
+                         float initCutoffFrequency = 1000.0F,
+                         float initResonance = 0.7071F);
 
         LowPass(const LowPass&) = delete;
         LowPass& operator=(const LowPass&) = delete;
         LowPass(LowPass&&) = delete;
         LowPass& operator=(LowPass&&) = delete;
+
+        auto getCutoffFrequency() const noexcept { return cutoffFrequency; }
+        void setCutoffFrequency(float newCutoffFrequency);
+
+        auto getResonance() const noexcept { return resonance; }
+        void setResonance(float newResonance);
+
+    private:
+        float cutoffFrequency; // Hz
+        float resonance; // Q factor
     };
 
     class HighPass final: public Effect
     {
     public:
-        explicit HighPass(Audio& initAudio);
+        explicit HighPass(Audio& initAudio,
+                          float initCutoffFrequency = 100.0F,
+                          float initResonance = 0.7071F);
 
         HighPass(const HighPass&) = delete;
         HighPass& operator=(const HighPass&) = delete;
         HighPass(HighPass&&) = delete;
         HighPass& operator=(HighPass&&) = delete;
+
+        auto getCutoffFrequency() const noexcept { return cutoffFrequency; }
+        void setCutoffFrequency(float newCutoffFrequency);
+
+        auto getResonance() const noexcept { return resonance; }
+        void setResonance(float newResonance);
+
+    private:
+        float cutoffFrequency; // Hz
+        float resonance; // Q factor
     };
 }
 
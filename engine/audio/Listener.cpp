@@ -28,6 +28,7 @@ namespace ouzel::audio
 
     void Listener::updateTransform()
     {
+        position = actor->getWorldPosition();
         transformDirty = true;
     }
 }
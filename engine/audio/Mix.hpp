@@ -33,6 +33,12 @@ namespace ouzel::audio
         void addEffect(Effect* effect);
         void removeEffect(Effect* effect);
 
+        auto& getEffects() const noexcept { return effects; }
+        auto& getListeners() const noexcept { return listeners; }
+
+        // the mix that this mix is routed to, null for the master mix
+        virtual Mix* getOutput() const noexcept { return nullptr; }
+
     protected:
         void addInput(Submix* submix);
         void removeInput(Submix* submix);
@@ -22,6 +22,7 @@ namespace ouzel::audio
         }
 
         void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void skipSamples(std::uint32_t frames) override;
 
     private:
         std::uint32_t position = 0;
@@ -85,7 +86,21 @@ namespace ouzel::audio
 
         if ((sourceFrames - position) == 0)
         {
-            playing = false; // TODO: fire event
+            finish();
+            reset();
+        }
+    }
+
+    void PcmStream::skipSamples(std::uint32_t frames)
+    {
+        const auto& pcmData = static_cast<PcmData&>(data);
+        const auto sourceFrames = static_cast<std::uint32_t>(pcmData.getData().size() / pcmData.getChannels());
+
+        position = (frames > sourceFrames - position) ? sourceFrames : position + frames;
+
+        if ((sourceFrames - position) == 0)
+        {
+            finish();
             reset();
         }
     }
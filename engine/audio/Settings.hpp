@@ -4,6 +4,7 @@
 #define OUZEL_AUDIO_SETTINGS_HPP
 
 #include <cstdint>
+#include <string>
 #include "SampleFormat.hpp"
 
 namespace ouzel::audio
@@ -16,6 +17,10 @@ namespace ouzel::audio
         std::uint32_t channels = 0;
         SampleFormat sampleFormat = SampleFormat::float32;
         std::string audioDevice;
+        std::size_t pcmCacheSize = 16U * 1024U * 1024U; // memory budget for decoded sounds in bytes
+        float pcmCacheMaxLength = 5.0F; // sounds longer than this (in seconds) are always streamed
+        SampleFormat pcmCacheFormat = SampleFormat::signedInt16;
+        std::uint32_t maxVoices = 64; // voices above this count are virtualized
     };
 }
 
@@ -20,6 +20,7 @@ namespace ouzel::audio
         }
 
         void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void skipSamples(std::uint32_t frames) override;
 
     private:
         std::uint32_t position = 0;
@@ -79,7 +80,7 @@ namespace ouzel::audio
 
             if ((frameCount - position) == 0)
             {
-                playing = false; // TODO: fire event
+                finish();
                 reset();
             }
         }
@@ -98,4 +99,23 @@ namespace ouzel::audio
         length{initLength}
     {
     }
+
+    void SilenceStream::skipSamples(std::uint32_t frames)
+    {
+        const auto length = static_cast<SilenceData&>(data).getLength();
+
+        if (length > 0.0F)
+        {
+            const auto frameCount = static_cast<std::uint32_t>(length * data.getSampleRate());
+            position = (frameCount - position < frames) ? frameCount : position + frames;
+
+            if ((frameCount - position) == 0)
+            {
+                finish();
+                reset();
+            }
+        }
+        else
+            position += frames;
+    }
 }
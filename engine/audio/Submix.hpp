@@ -19,6 +19,7 @@ namespace ouzel::audio
         Submix(Submix&&) = delete;
         Submix& operator=(Submix&&) = delete;
 
+        Mix* getOutput() const noexcept override { return output; }
         void setOutput(Mix* newOutput);
 
     private:
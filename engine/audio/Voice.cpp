@@ -45,7 +45,8 @@ namespace ouzel::audio
 
     Voice::Voice(Audio& initAudio, const Cue& cue):
         Node{initAudio},
-        audio{initAudio}
+        audio{initAudio},
+        priority{cue.getPriority()}
     {
         const auto& sourceDefinition = cue.getSourceDefinition();
 
@@ -111,10 +112,10 @@ namespace ouzel::audio
                     effects.push_back(std::make_unique<Reverb>(initAudio, effectDefinition.delay, effectDefinition.decay));
                     break;
                 case EffectDefinition::Type::lowPass:
-                    effects.push_back(std::make_unique<LowPass>(initAudio));
+                    effects.push_back(std::make_unique<LowPass>(initAudio, effectDefinition.cutoffFrequency, effectDefinition.resonance));
                     break;
                 case EffectDefinition::Type::highPass:
-                    effects.push_back(std::make_unique<HighPass>(initAudio));
+                    effects.push_back(std::make_unique<HighPass>(initAudio, effectDefinition.cutoffFrequency, effectDefinition.resonance));
                     break;
             }
         }
@@ -135,6 +136,8 @@ namespace ouzel::audio
 
     Voice::~Voice()
     {
+        audio.getVoiceManager().removeVoice(this);
+
         if (streamId)
             audio.deleteObject(streamId);
     }
@@ -144,10 +147,11 @@ namespace ouzel::audio
         audio.addCommand(std::make_unique<mixer::PlayStreamCommand>(streamId));
 
         playing = true;
+        audio.getVoiceManager().addVoice(this);
 
-        auto startEvent = std::make_unique<SoundEvent>();
-        startEvent->type = Event::Type::soundStart;
-        startEvent->voice = this;
+        SoundEvent startEvent;
+        startEvent.type = Event::Type::soundStart;
+        startEvent.voice = this;
         engine->getEventDispatcher().postEvent(std::move(startEvent));
 
         // TODO: send PlayCommand
@@ -174,9 +178,9 @@ namespace ouzel::audio
     // executed on audio thread
     /*void Voice::onReset()
     {
-        auto event = std::make_unique<SoundEvent>();
-        event->type = Event::Type::soundReset;
-        event->voice = this;
+        SoundEvent event;
+        event.type = Event::Type::soundReset;
+        event.voice = this;
         engine->getEventDispatcher().postEvent(std::move(event));
     }
 
@@ -185,9 +189,9 @@ namespace ouzel::audio
     {
         playing = false;
 
-        auto event = std::make_unique<SoundEvent>();
-        event->type = Event::Type::soundFinish;
-        event->voice = this;
+        SoundEvent event;
+        event.type = Event::Type::soundFinish;
+        event.voice = this;
         engine->getEventDispatcher().postEvent(std::move(event));
     }*/
 
@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_VOICE_HPP
 #define OUZEL_AUDIO_VOICE_HPP
 
+#include <cstdint>
 #include <memory>
 #include "Cue.hpp"
 #include "Node.hpp"
@@ -14,9 +15,12 @@ namespace ouzel::audio
     class Mix;
     class Sound;
 
+    class VoiceManager;
+
     class Voice final: public Node
     {
         friend Mix;
+        friend VoiceManager;
     public:
         explicit Voice(Audio& initAudio);
         Voice(Audio& initAudio, const Cue& cue);
@@ -52,16 +56,25 @@ namespace ouzel::audio
 
         auto isPlaying() const noexcept { return playing; }
 
+        auto getPriority() const noexcept { return priority; }
+        void setPriority(std::int32_t newPriority) noexcept { priority = newPriority; }
+
+        // virtual voices keep their position but are not decoded or mixed
+        auto isVirtual() const noexcept { return virtualized; }
+
+        auto getOutput() const noexcept { return output; }
         void setOutput(Mix* newOutput);
 
     private:
         Audio& audio;
-        std::size_t streamId;
+        std::size_t streamId = 0;
 
         const Sound* sound = nullptr;
         math::Vector<float, 3> position{};
         math::Vector<float, 3> velocity{};
         bool playing = false;
+        std::int32_t priority = 0;
+        bool virtualized = false;
 
         Mix* output = nullptr;
     };
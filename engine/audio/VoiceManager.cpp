@@ -0,0 +1,110 @@
+// Ouzel by Elviss Strazdins
+
+#include <algorithm>
+#include "VoiceManager.hpp"
+#include "Audio.hpp"
+#include "Effect.hpp"
+#include "Listener.hpp"
+#include "Mix.hpp"
+#include "Voice.hpp"
+#include "../core/Engine.hpp"
+
+namespace ouzel::audio
+{
+    namespace
+    {
+        // estimates the gain of the voice at the closest listener of its mix chain
+        float getAudibility(const Voice& voice)
+        {
+            if (!voice.getOutput()) return 0.0F;
+
+            const Mix* listenerMix = nullptr;
+            for (auto mix = voice.getOutput(); mix; mix = mix->getOutput())
+                if (!mix->getListeners().empty())
+                {
+                    listenerMix = mix;
+                    break;
+                }
+
+            // the mixer uses a listener at the origin if none are attached
+            static const std::vector<Listener*> noListeners;
+            const auto& listeners = listenerMix ? listenerMix->getListeners() : noListeners;
+
+            auto getGain = [&voice](const math::Vector<float, 3>& listenerPosition) noexcept {
+                float gain = 1.0F;
+                for (auto mix = voice.getOutput(); mix; mix = mix->getOutput())
+                    for (const auto effect : mix->getEffects())
+                        if (effect->isEnabled())
+                            gain *= effect->estimateGain(listenerPosition);
+                return gain;
+            };
+
+            if (listeners.empty()) return getGain(math::Vector<float, 3>{});
+
+            float audibility = 0.0F;
+            for (const auto listener : listeners)
+                audibility = std::max(audibility, getGain(listener->getPosition()));
+
+            return audibility;
+        }
+    }
+
+    void VoiceManager::addVoice(Voice* voice)
+    {
+        if (std::find(voices.begin(), voices.end(), voice) == voices.end())
+            voices.push_back(voice);
+    }
+
+    void VoiceManager::removeVoice(Voice* voice)
+    {
+        if (const auto i = std::find(voices.begin(), voices.end(), voice); i != voices.end())
+            voices.erase(i);
+    }
+
+    void VoiceManager::finishStream(std::size_t streamId)
+    {
+        const auto i = std::find_if(voices.begin(), voices.end(),
+                                    [streamId](const Voice* voice) noexcept { return voice->streamId == streamId; });
+        if (i == voices.end()) return;
+
+        const auto voice = *i;
+        voices.erase(i);
+        voice->playing = false;
+
+        SoundEvent finishEvent;
+        finishEvent.type = Event::Type::soundFinish;
+        finishEvent.voice = voice;
+        engine->getEventDispatcher().postEvent(std::move(finishEvent));
+    }
+
+    void VoiceManager::update()
+    {
+        entries.clear();
+
+        for (const auto voice : voices)
+            if (voice->isPlaying() && voice->streamId)
+                entries.push_back({voice, getAudibility(*voice)});
+
+        // the most important voices first
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) noexcept {
+            if (a.voice->getPriority() != b.voice->getPriority())
+                return a.voice->getPriority() > b.voice->getPriority();
+            return a.audibility > b.audibility;
+        });
+
+        std::uint32_t realVoices = 0;
+
+        for (const auto& entry : entries)
+        {
+            const auto virtualize = entry.audibility < minAudibility || realVoices >= maxVoices;
+            if (!virtualize) ++realVoices;
+
+            if (entry.voice->virtualized != virtualize)
+            {
+                entry.voice->virtualized = virtualize;
+                audio.addCommand(std::make_unique<mixer::SetStreamVirtualCommand>(entry.voice->streamId,
+                                                                                  virtualize));
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_VOICEMANAGER_HPP
+#define OUZEL_AUDIO_VOICEMANAGER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::audio
+{
+    class Audio;
+    class Voice;
+
+    // Limits the number of voices that are decoded and mixed, the rest are kept virtual
+    class VoiceManager final
+    {
+    public:
+        VoiceManager(Audio& initAudio, std::uint32_t initMaxVoices) noexcept:
+            audio{initAudio},
+            maxVoices{initMaxVoices}
+        {
+        }
+
+        VoiceManager(const VoiceManager&) = delete;
+        VoiceManager& operator=(const VoiceManager&) = delete;
+        VoiceManager(VoiceManager&&) = delete;
+        VoiceManager& operator=(VoiceManager&&) = delete;
+
+        auto getMaxVoices() const noexcept { return maxVoices; }
+        void setMaxVoices(std::uint32_t newMaxVoices) noexcept { maxVoices = newMaxVoices; }
+
+        // voices quieter than this are virtualized even if the limit is not reached
+        auto getMinAudibility() const noexcept { return minAudibility; }
+        void setMinAudibility(float newMinAudibility) noexcept { minAudibility = newMinAudibility; }
+
+        void addVoice(Voice* voice);
+        void removeVoice(Voice* voice);
+
+        // stops the voice of a stream that reached its end, so that its real voice is freed
+        void finishStream(std::size_t streamId);
+
+        void update();
+
+    private:
+        struct Entry final
+        {
+            Voice* voice;
+            float audibility;
+        };
+
+        Audio& audio;
+        std::uint32_t maxVoices;
+        float minAudibility = 0.001F; // -60 dB
+        std::vector<Voice*> voices;
+        std::vector<Entry> entries;
+    };
+}
+
+#endif // OUZEL_AUDIO_VOICEMANAGER_HPP
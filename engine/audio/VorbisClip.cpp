@@ -1,10 +1,18 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <stdexcept>
 #include "VorbisClip.hpp"
 #include "Audio.hpp"
 #include "mixer/Data.hpp"
+#include "mixer/PcmCache.hpp"
+#include "mixer/RingBuffer.hpp"
 #include "mixer/Stream.hpp"
+#include "../thread/Thread.hpp"
 #include "../utils/Utils.hpp"
 
 #ifdef _MSC_VER
@@ -43,6 +51,286 @@
 
 namespace ouzel::audio
 {
+    namespace
+    {
+        constexpr std::uint32_t decodeChunkFrames = 4096;
+        constexpr std::chrono::milliseconds decoderIdleTimeout{10};
+
+        // maps Vorbis channel order to the mixer channel order
+        constexpr std::uint32_t getChannelIndex(std::uint32_t channels, std::uint32_t channel) noexcept
+        {
+            constexpr std::uint32_t sixChannelMap[] = {0, 2, 1, 4, 5, 3};
+            return channels == 6 ? sixChannelMap[channel] : channel;
+        }
+
+        stb_vorbis* openVorbis(const storage::MappedFile& file)
+        {
+            return stb_vorbis_open_memory(reinterpret_cast<const unsigned char*>(file.getData()),
+                                          static_cast<int>(file.getSize()),
+                                          nullptr, nullptr);
+        }
+
+        class VorbisDecoder final
+        {
+        public:
+            // request to decode a whole clip into the PCM cache
+            struct ClipJob final
+            {
+                std::shared_ptr<const storage::MappedFile> data;
+                std::uint32_t channels;
+                std::size_t frames;
+                mixer::PcmCache::Key key;
+                std::shared_ptr<mixer::PcmCache> cache;
+            };
+
+            class State final
+            {
+            public:
+                State(std::shared_ptr<const storage::MappedFile> initData,
+                      std::uint32_t channels,
+                      std::uint32_t sampleRate):
+                    data{std::move(initData)},
+                    ringBuffer{sampleRate / 2, channels}, // half a second of read-ahead
+                    channelData(channels)
+                {
+                }
+
+                ~State()
+                {
+                    if (vorbisStream)
+                        stb_vorbis_close(vorbisStream);
+                }
+
+                State(const State&) = delete;
+                State& operator=(const State&) = delete;
+                State(State&&) = delete;
+                State& operator=(State&&) = delete;
+
+                // called only on the decoder thread
+                bool decode()
+                {
+                    if (!vorbisStream)
+                    {
+                        if (openFailed || !open())
+                        {
+                            openFailed = true;
+                            finished.store(true, std::memory_order_release);
+                            return false;
+                        }
+                    }
+
+                    if (const auto generation = resetGeneration.load(std::memory_order_acquire);
+                        generation != seekedGeneration.load(std::memory_order_relaxed))
+                    {
+                        if (const auto frame = seekPosition.load(std::memory_order_relaxed); frame > 0)
+                            stb_vorbis_seek(vorbisStream, static_cast<unsigned int>(frame));
+                        else
+                            stb_vorbis_seek_start(vorbisStream);
+                        finished.store(false, std::memory_order_relaxed);
+                        seekedGeneration.store(generation, std::memory_order_release);
+                    }
+
+                    // nothing is decoded until the consumer has dropped the frames decoded before the seek
+                    if (resetRequested.load(std::memory_order_acquire)) return false;
+
+                    if (finished.load(std::memory_order_relaxed)) return false;
+
+                    const auto frames = static_cast<std::uint32_t>(std::min(ringBuffer.getContiguousWritableFrames(),
+                                                                            std::size_t{decodeChunkFrames}));
+                    if (frames == 0) return false;
+
+                    for (std::uint32_t channel = 0; channel < ringBuffer.getChannels(); ++channel)
+                        channelData[channel] = ringBuffer.getWritePointer(getChannelIndex(ringBuffer.getChannels(), channel));
+
+                    const auto resultFrames = stb_vorbis_get_samples_float(vorbisStream,
+                                                                           static_cast<int>(ringBuffer.getChannels()),
+                                                                           channelData.data(),
+                                                                           static_cast<int>(frames));
+
+                    ringBuffer.commitWrite(static_cast<std::size_t>(resultFrames));
+
+                    if (static_cast<std::uint32_t>(resultFrames) < frames)
+                        finished.store(true, std::memory_order_release);
+
+                    return true;
+                }
+
+                mixer::RingBuffer& getRingBuffer() noexcept { return ringBuffer; }
+
+                // the consumer sets resetRequested and then increments resetGeneration, the decoder seeks and
+                // publishes the generation in seekedGeneration, only the consumer clears resetRequested
+                std::atomic<std::size_t> seekPosition{0};
+                std::atomic_bool resetRequested{false};
+                std::atomic<std::uint32_t> resetGeneration{0};
+                std::atomic<std::uint32_t> seekedGeneration{0};
+                std::atomic_bool finished{false};
+                std::atomic_bool closed{false};
+
+            private:
+                bool open()
+                {
+                    vorbisStream = openVorbis(*data);
+                    return vorbisStream != nullptr;
+                }
+
+                std::shared_ptr<const storage::MappedFile> data;
+                stb_vorbis* vorbisStream = nullptr;
+                bool openFailed = false;
+                mixer::RingBuffer ringBuffer;
+                std::vector<float*> channelData;
+            };
+
+            VorbisDecoder():
+                decoderThread{&VorbisDecoder::decoderMain, this}
+            {
+            }
+
+            ~VorbisDecoder()
+            {
+                std::unique_lock lock{stateMutex};
+                running = false;
+                lock.unlock();
+                stateCondition.notify_all();
+
+                if (decoderThread.isJoinable())
+                    decoderThread.join();
+            }
+
+            VorbisDecoder(const VorbisDecoder&) = delete;
+            VorbisDecoder& operator=(const VorbisDecoder&) = delete;
+            VorbisDecoder(VorbisDecoder&&) = delete;
+            VorbisDecoder& operator=(VorbisDecoder&&) = delete;
+
+            void addState(std::shared_ptr<State> state)
+            {
+                std::unique_lock lock{stateMutex};
+                pendingStates.push_back(std::move(state));
+                lock.unlock();
+                stateCondition.notify_all();
+            }
+
+            void addClipJob(ClipJob job)
+            {
+                std::unique_lock lock{stateMutex};
+                clipJobs.push_back(std::move(job));
+                lock.unlock();
+                stateCondition.notify_all();
+            }
+
+            void wake() noexcept
+            {
+                // the mixer thread does not take the lock, a missed wakeup is covered by the idle timeout
+                woken.store(true, std::memory_order_relaxed);
+                stateCondition.notify_all();
+            }
+
+        private:
+            void decoderMain()
+            {
+                std::vector<std::shared_ptr<State>> states;
+
+                for (;;)
+                {
+                    std::unique_lock lock{stateMutex};
+                    if (!running) break;
+                    for (auto& state : pendingStates)
+                        states.push_back(std::move(state));
+                    pendingStates.clear();
+                    auto jobs = std::move(clipJobs);
+                    clipJobs.clear();
+                    lock.unlock();
+
+                    bool decoded = false;
+
+                    for (auto i = states.begin(); i != states.end();)
+                    {
+                        if ((*i)->closed.load(std::memory_order_acquire))
+                            i = states.erase(i);
+                        else
+                        {
+                            if ((*i)->decode()) decoded = true;
+                            ++i;
+                        }
+                    }
+
+                    // streams are refilled first, so that whole clip decoding does not starve them
+                    for (const auto& job : jobs)
+                        decodeClip(job);
+
+                    if (!decoded && jobs.empty())
+                    {
+                        lock.lock();
+                        stateCondition.wait_for(lock, decoderIdleTimeout, [this]() noexcept {
+                            return !running || !pendingStates.empty() || !clipJobs.empty() ||
+                                woken.exchange(false, std::memory_order_relaxed);
+                        });
+                    }
+                }
+            }
+
+            static void decodeClip(const ClipJob& job)
+            {
+                stb_vorbis* vorbisStream = openVorbis(*job.data);
+                if (!vorbisStream)
+                {
+                    job.cache->erase(job.key);
+                    return;
+                }
+
+                const auto clip = std::make_shared<mixer::PcmCache::Clip>(job.cache->getFormat(),
+                                                                          job.channels,
+                                                                          job.frames);
+
+                std::vector<float> decodeBuffer;
+                float* samples;
+                if (clip->getFormat() == SampleFormat::float32)
+                    samples = clip->floatSamples.data();
+                else
+                {
+                    decodeBuffer.resize(job.frames * job.channels);
+                    samples = decodeBuffer.data();
+                }
+
+                std::vector<float*> channelData(job.channels);
+                for (std::uint32_t channel = 0; channel < job.channels; ++channel)
+                    channelData[channel] = &samples[getChannelIndex(job.channels, channel) * job.frames];
+
+                const auto resultFrames = static_cast<std::size_t>(stb_vorbis_get_samples_float(vorbisStream,
+                                                                                                static_cast<int>(job.channels),
+                                                                                                channelData.data(),
+                                                                                                static_cast<int>(job.frames)));
+                stb_vorbis_close(vorbisStream);
+
+                // the stream length is an estimate, silence the frames that could not be decoded
+                for (std::uint32_t channel = 0; channel < job.channels; ++channel)
+                    std::fill(samples + channel * job.frames + resultFrames,
+                              samples + (channel + 1) * job.frames, 0.0F);
+
+                if (clip->getFormat() == SampleFormat::signedInt16)
+                    std::transform(decodeBuffer.begin(), decodeBuffer.end(), clip->int16Samples.begin(),
+                                   [](float sample) noexcept {
+                                       return static_cast<std::int16_t>(std::clamp(sample, -1.0F, 1.0F) * 32767.0F);
+                                   });
+
+                job.cache->insert(job.key, clip);
+            }
+
+            bool running = true;
+            std::atomic_bool woken{false};
+            std::vector<std::shared_ptr<State>> pendingStates;
+            std::vector<ClipJob> clipJobs;
+            std::mutex stateMutex;
+            std::condition_variable stateCondition;
+            thread::Thread decoderThread;
+        };
+
+        VorbisDecoder& getDecoder()
+        {
+            static VorbisDecoder decoder;
+            return decoder;
+        }
+    }
+
     class VorbisData;
 
     class VorbisStream final: public mixer::Stream
@@ -52,43 +340,88 @@ namespace ouzel::audio
 
         ~VorbisStream() override
         {
-            if (vorbisStream)
-                stb_vorbis_close(vorbisStream);
+            if (state) state->closed.store(true, std::memory_order_release);
         }
 
         void reset() override
         {
-            stb_vorbis_seek_start(vorbisStream);
+            position = 0;
+            clip.reset();
+            started = false;
+            seekPending = false;
+
+            if (state) seek(0);
         }
 
         void generateSamples(std::uint32_t frames, std::vector<float>& samples) override;
+        void skipSamples(std::uint32_t frames) override;
 
     private:
-        stb_vorbis* vorbisStream = nullptr;
+        void start();
+        void seek(std::size_t frame)
+        {
+            state->seekPosition.store(frame, std::memory_order_relaxed);
+            state->resetRequested.store(true, std::memory_order_relaxed);
+            state->resetGeneration.fetch_add(1, std::memory_order_release);
+            getDecoder().wake();
+        }
+
+        std::size_t readClip(std::uint32_t frames, std::vector<float>& samples);
+        std::size_t readStream(std::uint32_t frames, std::vector<float>& samples);
+
+        bool started = false;
+
+        std::size_t position = 0;
+
+        // decoded clip from the PCM cache, if the sound is short enough
+        std::shared_ptr<const mixer::PcmCache::Clip> clip;
+
+        // read-ahead decoder state, used if the clip is not cached
+        std::shared_ptr<VorbisDecoder::State> state;
+        bool seekPending = false; // the position was advanced while the stream was virtual
+        std::vector<float*> channelData;
     };
 
     class VorbisData final: public mixer::Data
     {
     public:
-        explicit VorbisData(const std::vector<std::byte>& initData):
-            data{initData}
+        VorbisData(std::shared_ptr<const storage::MappedFile> initData,
+                   std::shared_ptr<mixer::PcmCache> initCache,
+                   float maxCachedLength):
+            data{std::move(initData)},
+            cache{std::move(initCache)}
         {
-            stb_vorbis* vorbisStream = stb_vorbis_open_memory(reinterpret_cast<const unsigned char*>(data.data()),
-                                                              static_cast<int>(data.size()),
-                                                              nullptr, nullptr);
+            stb_vorbis* vorbisStream = openVorbis(*data);
 
             if (!vorbisStream)
                 throw std::runtime_error{"Failed to load Vorbis stream"};
 
-            stb_vorbis_info info = stb_vorbis_get_info(vorbisStream);
-
-            channels = static_cast<std::uint32_t>(info.channels);
-            sampleRate = info.sample_rate;
+            readInfo(vorbisStream, maxCachedLength);
+        }
 
-            stb_vorbis_close(vorbisStream);
+        ~VorbisData() override
+        {
+            if (cacheable) cache->erase(key);
         }
 
+        VorbisData(const VorbisData&) = delete;
+        VorbisData& operator=(const VorbisData&) = delete;
+        VorbisData(VorbisData&&) = delete;
+        VorbisData& operator=(VorbisData&&) = delete;
+
         auto& getData() const noexcept { return data; }
+        auto getFrames() const noexcept { return frames; }
+
+        auto isCacheable() const noexcept { return cacheable; }
+
+        // returns the decoded clip or starts decoding it in the background and returns null
+        std::shared_ptr<const mixer::PcmCache::Clip> getClip() const
+        {
+            if (auto clip = cache->get(key)) return clip;
+            if (cache->beginDecode(key))
+                getDecoder().addClipJob({data, channels, frames, key, cache});
+            return nullptr;
+        }
 
         std::unique_ptr<mixer::Stream> createStream() override
         {
@@ -96,79 +429,196 @@ namespace ouzel::audio
         }
 
     private:
-        std::vector<std::byte> data;
+        void readInfo(stb_vorbis* vorbisStream, float maxCachedLength)
+        {
+            const stb_vorbis_info info = stb_vorbis_get_info(vorbisStream);
+
+            channels = static_cast<std::uint32_t>(info.channels);
+            sampleRate = info.sample_rate;
+            frames = stb_vorbis_stream_length_in_samples(vorbisStream);
+
+            stb_vorbis_close(vorbisStream);
+
+            if (channels != 1 && channels != 2 && channels != 4 && channels != 6)
+                throw std::runtime_error{"Unsupported channel count"};
+
+            const auto clipSize = frames * channels * (cache->getFormat() == SampleFormat::signedInt16 ?
+                                                       sizeof(std::int16_t) : sizeof(float));
+
+            cacheable = frames > 0 &&
+                static_cast<float>(frames) <= maxCachedLength * static_cast<float>(sampleRate) &&
+                cache->canFit(clipSize);
+
+            if (cacheable) getClip(); // start decoding before the first play
+        }
+
+        static mixer::PcmCache::Key getNextKey() noexcept
+        {
+            static std::atomic<mixer::PcmCache::Key> lastKey{0};
+            return ++lastKey;
+        }
+
+        // encoded data is shared with the decoder, so it outlives the data object if needed,
+        // it is not copied, so the pages of a mapped file are read only when they are decoded
+        std::shared_ptr<const storage::MappedFile> data;
+        std::size_t frames = 0;
+
+        std::shared_ptr<mixer::PcmCache> cache;
+        mixer::PcmCache::Key key = getNextKey();
+        bool cacheable = false;
     };
 
     VorbisStream::VorbisStream(VorbisData& vorbisData):
-        Stream{vorbisData}
+        Stream{vorbisData},
+        channelData(vorbisData.getChannels())
     {
-        vorbisStream = stb_vorbis_open_memory(reinterpret_cast<const unsigned char*>(vorbisData.getData().data()),
-                                              static_cast<int>(vorbisData.getData().size()),
-                                              nullptr, nullptr);
+    }
+
+    void VorbisStream::start()
+    {
+        started = true;
+
+        const auto& vorbisData = static_cast<VorbisData&>(data);
+
+        if (vorbisData.isCacheable())
+            clip = vorbisData.getClip();
+
+        if (clip)
+        {
+            // the clip is cached, so the read-ahead decoder is not needed anymore
+            if (state)
+            {
+                state->closed.store(true, std::memory_order_release);
+                state.reset();
+            }
+        }
+        else if (!state)
+        {
+            state = std::make_shared<VorbisDecoder::State>(vorbisData.getData(),
+                                                           vorbisData.getChannels(),
+                                                           vorbisData.getSampleRate());
+            getDecoder().addState(state);
+
+            if (position > 0) seekPending = true;
+        }
     }
 
     void VorbisStream::generateSamples(std::uint32_t frames, std::vector<float>& samples)
     {
-        std::uint32_t neededSize = frames * data.getChannels();
+        const std::uint32_t neededSize = frames * data.getChannels();
         samples.resize(neededSize);
 
-        int resultFrames = 0;
+        if (!started) start();
+
+        const auto resultFrames = clip ? readClip(frames, samples) : readStream(frames, samples);
 
-        if (neededSize > 0)
+        // fill the rest with silence if the sound ended or the decoder could not keep up
+        for (std::uint32_t channel = 0; channel < data.getChannels(); ++channel)
+            for (auto frame = resultFrames; frame < frames; ++frame)
+                samples[channel * frames + frame] = 0.0F;
+    }
+
+    void VorbisStream::skipSamples(std::uint32_t frames)
+    {
+        // the decoder is not touched until the stream becomes real again
+        const auto totalFrames = clip ? clip->getFrames() : static_cast<VorbisData&>(data).getFrames();
+        position += frames;
+
+        if (totalFrames > 0 && position >= totalFrames)
         {
-            if (vorbisStream->eof)
-                reset();
+            finish();
+            reset();
+        }
+        else if (state)
+            seekPending = true;
+    }
+
+    std::size_t VorbisStream::readClip(std::uint32_t frames, std::vector<float>& samples)
+    {
+        const auto clipFrames = clip->getFrames();
+        const auto copyFrames = std::min(std::size_t{frames}, clipFrames - position);
 
-            std::vector<float*> channelData(data.getChannels());
+        for (std::uint32_t channel = 0; channel < data.getChannels(); ++channel)
+        {
+            const auto outputChannel = &samples[channel * frames];
 
-            switch (data.getChannels())
+            if (clip->getFormat() == SampleFormat::float32)
             {
-                case 1:
-                    channelData[0] = &samples[0];
-                    break;
-                case 2:
-                    channelData[0] = &samples[0 * frames];
-                    channelData[1] = &samples[1 * frames];
-                    break;
-                case 4:
-                    channelData[0] = &samples[0 * frames];
-                    channelData[1] = &samples[1 * frames];
-                    channelData[2] = &samples[2 * frames];
-                    channelData[3] = &samples[3 * frames];
-                    break;
-                case 6:
-                    channelData[0] = &samples[0 * frames];
-                    channelData[1] = &samples[2 * frames];
-                    channelData[2] = &samples[1 * frames];
-                    channelData[3] = &samples[4 * frames];
-                    channelData[4] = &samples[5 * frames];
-                    channelData[5] = &samples[3 * frames];
-                    break;
-                default:
-                    throw std::runtime_error{"Unsupported channel count"};
+                const auto sourceChannel = &clip->floatSamples[channel * clipFrames + position];
+                std::copy(sourceChannel, sourceChannel + copyFrames, outputChannel);
+            }
+            else
+            {
+                const auto sourceChannel = &clip->int16Samples[channel * clipFrames + position];
+                for (std::size_t frame = 0; frame < copyFrames; ++frame)
+                    outputChannel[frame] = static_cast<float>(sourceChannel[frame]) / 32767.0F;
             }
-
-            resultFrames = stb_vorbis_get_samples_float(vorbisStream,
-                                                        static_cast<int>(data.getChannels()),
-                                                        channelData.data(),
-                                                        static_cast<int>(frames));
         }
 
-        if (vorbisStream->eof)
+        position += copyFrames;
+
+        if (position == clipFrames)
         {
-            playing = false; // TODO: fire event
+            finish();
             reset();
         }
 
+        return copyFrames;
+    }
+
+    std::size_t VorbisStream::readStream(std::uint32_t frames, std::vector<float>& samples)
+    {
+        auto& ringBuffer = state->getRingBuffer();
+
+        if (seekPending)
+        {
+            seekPending = false;
+            seek(position);
+        }
+
+        if (state->resetRequested.load(std::memory_order_relaxed))
+        {
+            // the decoder does not write to the ring after it has seeked, until the flag is cleared
+            const auto seeked = state->seekedGeneration.load(std::memory_order_acquire) ==
+                state->resetGeneration.load(std::memory_order_relaxed);
+
+            ringBuffer.skip(ringBuffer.getReadableFrames()); // drop frames decoded before the reset
+            if (!seeked) return 0;
+
+            state->resetRequested.store(false, std::memory_order_release);
+            getDecoder().wake();
+            return 0;
+        }
+
+        const auto finished = state->finished.load(std::memory_order_acquire);
+
         for (std::uint32_t channel = 0; channel < data.getChannels(); ++channel)
-            for (auto frame = static_cast<std::uint32_t>(resultFrames); frame < frames; ++frame)
-                samples[channel * frames + frame] = 0.0F;
+            channelData[channel] = &samples[channel * frames];
+
+        const auto resultFrames = ringBuffer.read(frames, channelData.data());
+        position += resultFrames;
+        getDecoder().wake();
+
+        if (finished && ringBuffer.getReadableFrames() == 0)
+        {
+            finish();
+            reset();
+        }
+
+        return resultFrames;
+    }
+
+    VorbisClip::VorbisClip(Audio& initAudio, Span<const std::byte> initData):
+        VorbisClip{initAudio, std::make_shared<const storage::MappedFile>(std::vector<std::byte>(initData.begin(), initData.end()))}
+    {
     }
 
-    VorbisClip::VorbisClip(Audio& initAudio, const std::vector<std::byte>& initData):
+    VorbisClip::VorbisClip(Audio& initAudio, std::shared_ptr<const storage::MappedFile> initData):
         Sound{
             initAudio,
-            initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisData(initData))),
+            initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisData(std::move(initData),
+                                                                                  initAudio.getMixer().getPcmCache(),
+                                                                                  initAudio.getPcmCacheMaxLength()))),
             Sound::Format::vorbis
         }
     {
@@ -4,8 +4,11 @@
 #define OUZEL_AUDIO_VORBISCLIP_HPP
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "Sound.hpp"
+#include "../storage/MappedFile.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::audio
 {
@@ -14,7 +17,9 @@ namespace ouzel::audio
     class VorbisClip final: public Sound
     {
     public:
-        VorbisClip(Audio& initAudio, const std::vector<std::byte>& initData);
+        // the data is copied, because the span does not own it
+        VorbisClip(Audio& initAudio, Span<const std::byte> initData);
+        VorbisClip(Audio& initAudio, std::shared_ptr<const storage::MappedFile> initData);
 
     private:
         VorbisData* data;
@@ -247,6 +247,12 @@ namespace ouzel::audio::mixer
                 const std::uint32_t sourceSampleRate = stream->getData().getSampleRate();
                 const std::uint32_t sourceChannels = stream->getData().getChannels();
 
+                if (stream->isVirtual())
+                {
+                    stream->skipSamples((frames * sourceSampleRate + sampleRate - 1) / sampleRate);
+                    continue;
+                }
+
                 if (sourceSampleRate != sampleRate)
                 {
                     std::uint32_t sourceFrames = (frames * sourceSampleRate + sampleRate - 1) / sampleRate; // round up
@@ -36,6 +36,7 @@ namespace ouzel::audio::mixer
             playStream,
             stopStream,
             setStreamOutput,
+            setStreamVirtual,
             initData,
             initProcessor,
             updateProcessor
@@ -247,6 +248,20 @@ namespace ouzel::audio::mixer
         const ObjectId busId;
     };
 
+    class SetStreamVirtualCommand final: public Command
+    {
+    public:
+        constexpr SetStreamVirtualCommand(ObjectId initStreamId,
+                                          bool initVirtual) noexcept:
+            Command{Command::Type::setStreamVirtual},
+            streamId{initStreamId},
+            virtualized{initVirtual}
+        {}
+
+        const ObjectId streamId;
+        const bool virtualized;
+    };
+
     class InitDataCommand final: public Command
     {
     public:
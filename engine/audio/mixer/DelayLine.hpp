@@ -0,0 +1,73 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_MIXER_DELAYLINE_HPP
+#define OUZEL_AUDIO_MIXER_DELAYLINE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::audio::mixer
+{
+    // Circular buffer of the most recent samples of a single channel
+    class DelayLine final
+    {
+    public:
+        DelayLine() = default;
+
+        explicit DelayLine(std::size_t maxDelay)
+        {
+            setMaxDelay(maxDelay);
+        }
+
+        auto getMaxDelay() const noexcept { return buffer.empty() ? std::size_t{0} : buffer.size() - 2; }
+
+        // reallocates (and clears) the buffer only if it is empty or can not hold the delay
+        void setMaxDelay(std::size_t maxDelay)
+        {
+            if (!buffer.empty() && maxDelay <= getMaxDelay()) return;
+
+            // power of two size, so that the position can be wrapped with a mask;
+            // one extra sample for the current sample and one for the interpolation
+            std::size_t size = 1;
+            while (size < maxDelay + 2) size <<= 1;
+
+            buffer.assign(size, 0.0F);
+            mask = size - 1;
+            writePosition = 0;
+        }
+
+        void clear() noexcept
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0F);
+        }
+
+        void write(float sample) noexcept
+        {
+            buffer[writePosition] = sample;
+            writePosition = (writePosition + 1) & mask;
+        }
+
+        // returns the sample written delay samples before the last one
+        float read(std::size_t delay) const noexcept
+        {
+            return buffer[(writePosition - 1 - delay) & mask];
+        }
+
+        // linearly interpolated read for fractional delays
+        float read(float delay) const noexcept
+        {
+            const auto wholeDelay = static_cast<std::size_t>(delay);
+            const auto fraction = delay - static_cast<float>(wholeDelay);
+            const auto current = read(wholeDelay);
+            return current + (read(wholeDelay + 1) - current) * fraction;
+        }
+
+    private:
+        std::vector<float> buffer;
+        std::size_t mask = 0;
+        std::size_t writePosition = 0;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_DELAYLINE_HPP
@@ -10,9 +10,12 @@
 namespace ouzel::audio::mixer
 {
     Mixer::Mixer(std::uint32_t initBufferSize,
-                 std::uint32_t initChannels):
+                 std::uint32_t initChannels,
+                 std::size_t pcmCacheSize,
+                 SampleFormat pcmCacheFormat):
         bufferSize{initBufferSize},
         channels{initChannels},
+        pcmCache{std::make_shared<PcmCache>(pcmCacheSize, pcmCacheFormat)},
         mixerThread{&Mixer::mixerMain, this},
         buffer{initBufferSize * 3, initChannels}
     {
@@ -143,7 +146,13 @@ namespace ouzel::audio::mixer
                             objects.resize(initStreamCommand->streamId);
 
                         const auto data = static_cast<Data*>(objects[initStreamCommand->dataId - 1].get());
-                        objects[initStreamCommand->streamId - 1] = data->createStream();
+                        auto stream = data->createStream();
+                        stream->setFinishCallback([this, streamId = initStreamCommand->streamId]() {
+                            Event event{Event::Type::streamStopped};
+                            event.objectId = streamId;
+                            sendEvent(event);
+                        });
+                        objects[initStreamCommand->streamId - 1] = std::move(stream);
                         break;
                     }
                     case Command::Type::playStream:
@@ -170,6 +179,14 @@ namespace ouzel::audio::mixer
                         stream->setOutput(setStreamOutputCommand->busId ? static_cast<Bus*>(objects[setStreamOutputCommand->busId - 1].get()) : nullptr);
                         break;
                     }
+                    case Command::Type::setStreamVirtual:
+                    {
+                        const auto setStreamVirtualCommand = static_cast<const SetStreamVirtualCommand*>(command.get());
+
+                        const auto stream = static_cast<Stream*>(objects[setStreamVirtualCommand->streamId - 1].get());
+                        stream->setVirtual(setStreamVirtualCommand->virtualized);
+                        break;
+                    }
                     case Command::Type::initData:
                     {
                         const auto initDataCommand = static_cast<InitDataCommand*>(command.get());
@@ -13,6 +13,7 @@
 #include <vector>
 #include "Commands.hpp"
 #include "Object.hpp"
+#include "PcmCache.hpp"
 #include "Processor.hpp"
 #include "../../thread/Thread.hpp"
 
@@ -62,7 +63,9 @@ namespace ouzel::audio::mixer
         };
 
         Mixer(std::uint32_t initBufferSize,
-              std::uint32_t initChannels);
+              std::uint32_t initChannels,
+              std::size_t pcmCacheSize = 0,
+              SampleFormat pcmCacheFormat = SampleFormat::float32);
 
         ~Mixer();
 
@@ -106,6 +109,8 @@ namespace ouzel::audio::mixer
 
         std::queue<Event> getEvents();
 
+        auto& getPcmCache() const noexcept { return pcmCache; }
+
     protected:
         void sendEvent(const Event& event);
 
@@ -126,6 +131,8 @@ namespace ouzel::audio::mixer
 
         Bus* masterBus = nullptr;
 
+        std::shared_ptr<PcmCache> pcmCache;
+
         class Buffer final
         {
         public:
@@ -0,0 +1,147 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_MIXER_PCMCACHE_HPP
+#define OUZEL_AUDIO_MIXER_PCMCACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "../SampleFormat.hpp"
+
+namespace ouzel::audio::mixer
+{
+    // Decoded samples of short compressed sounds, shared by all of their streams
+    class PcmCache final
+    {
+    public:
+        using Key = std::uint64_t;
+
+        class Clip final
+        {
+        public:
+            Clip(SampleFormat initFormat, std::uint32_t initChannels, std::size_t initFrames):
+                format{initFormat},
+                channels{initChannels},
+                frames{initFrames}
+            {
+                if (format == SampleFormat::signedInt16)
+                    int16Samples.resize(frames * channels);
+                else
+                    floatSamples.resize(frames * channels);
+            }
+
+            auto getFormat() const noexcept { return format; }
+            auto getChannels() const noexcept { return channels; }
+            auto getFrames() const noexcept { return frames; }
+
+            std::size_t getSize() const noexcept
+            {
+                return frames * channels * (format == SampleFormat::signedInt16 ?
+                                            sizeof(std::int16_t) : sizeof(float));
+            }
+
+            // planar samples, channel by channel
+            std::vector<float> floatSamples;
+            std::vector<std::int16_t> int16Samples;
+
+        private:
+            SampleFormat format;
+            std::uint32_t channels;
+            std::size_t frames;
+        };
+
+        PcmCache(std::size_t initMaxSize, SampleFormat initFormat) noexcept:
+            maxSize{initMaxSize}, format{initFormat}
+        {
+        }
+
+        auto getMaxSize() const noexcept { return maxSize; }
+        auto getFormat() const noexcept { return format; }
+
+        std::size_t getSize() const
+        {
+            std::scoped_lock lock{mutex};
+            return size;
+        }
+
+        bool canFit(std::size_t clipSize) const noexcept
+        {
+            return clipSize <= maxSize;
+        }
+
+        std::shared_ptr<const Clip> get(Key key)
+        {
+            std::scoped_lock lock{mutex};
+
+            if (const auto i = index.find(key); i != index.end())
+            {
+                // move the entry to the front of the LRU list
+                entries.splice(entries.begin(), entries, i->second);
+                return i->second->second;
+            }
+
+            return nullptr;
+        }
+
+        // returns false if the clip is cached or is already being decoded
+        bool beginDecode(Key key)
+        {
+            std::scoped_lock lock{mutex};
+            if (index.find(key) != index.end()) return false;
+            return pending.insert(key).second;
+        }
+
+        // the clip is dropped if it was erased while it was being decoded
+        void insert(Key key, std::shared_ptr<const Clip> clip)
+        {
+            std::scoped_lock lock{mutex};
+
+            if (pending.erase(key) == 0) return;
+
+            const auto clipSize = clip->getSize();
+            if (clipSize > maxSize) return;
+
+            eraseEntry(key);
+
+            while (size + clipSize > maxSize && !entries.empty())
+                eraseEntry(entries.back().first);
+
+            entries.emplace_front(key, std::move(clip));
+            index[key] = entries.begin();
+            size += clipSize;
+        }
+
+        void erase(Key key)
+        {
+            std::scoped_lock lock{mutex};
+            pending.erase(key);
+            eraseEntry(key);
+        }
+
+    private:
+        void eraseEntry(Key key)
+        {
+            if (const auto i = index.find(key); i != index.end())
+            {
+                size -= i->second->second->getSize();
+                entries.erase(i->second);
+                index.erase(i);
+            }
+        }
+
+        std::size_t maxSize;
+        SampleFormat format;
+
+        mutable std::mutex mutex;
+        std::size_t size = 0;
+        std::list<std::pair<Key, std::shared_ptr<const Clip>>> entries; // most recently used first
+        std::unordered_map<Key, std::list<std::pair<Key, std::shared_ptr<const Clip>>>::iterator> index;
+        std::set<Key> pending;
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_PCMCACHE_HPP
@@ -0,0 +1,94 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_AUDIO_MIXER_RINGBUFFER_HPP
+#define OUZEL_AUDIO_MIXER_RINGBUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel::audio::mixer
+{
+    // Single-producer single-consumer ring buffer of planar float frames
+    class RingBuffer final
+    {
+    public:
+        RingBuffer(std::size_t initCapacity, std::uint32_t initChannels):
+            capacity{initCapacity},
+            channels{initChannels},
+            buffer(initCapacity * initChannels)
+        {
+        }
+
+        auto getCapacity() const noexcept { return capacity; }
+        auto getChannels() const noexcept { return channels; }
+
+        std::size_t getReadableFrames() const noexcept
+        {
+            return writePosition.load(std::memory_order_acquire) -
+                readPosition.load(std::memory_order_relaxed);
+        }
+
+        std::size_t getWritableFrames() const noexcept
+        {
+            return capacity - (writePosition.load(std::memory_order_relaxed) -
+                               readPosition.load(std::memory_order_acquire));
+        }
+
+        // number of frames that can be written without wrapping around
+        std::size_t getContiguousWritableFrames() const noexcept
+        {
+            const auto offset = writePosition.load(std::memory_order_relaxed) % capacity;
+            return std::min(getWritableFrames(), capacity - offset);
+        }
+
+        float* getWritePointer(std::uint32_t channel) noexcept
+        {
+            const auto offset = writePosition.load(std::memory_order_relaxed) % capacity;
+            return &buffer[channel * capacity + offset];
+        }
+
+        void commitWrite(std::size_t frames) noexcept
+        {
+            writePosition.store(writePosition.load(std::memory_order_relaxed) + frames,
+                                std::memory_order_release);
+        }
+
+        // copies up to frames frames to the given channel pointers and returns the number of frames read
+        std::size_t read(std::size_t frames, float* const* outputChannels) noexcept
+        {
+            const auto readableFrames = std::min(frames, getReadableFrames());
+            const auto position = readPosition.load(std::memory_order_relaxed);
+            const auto offset = position % capacity;
+            const auto firstFrames = std::min(readableFrames, capacity - offset);
+
+            for (std::uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const auto bufferChannel = &buffer[channel * capacity];
+                std::copy(bufferChannel + offset, bufferChannel + offset + firstFrames,
+                          outputChannels[channel]);
+                std::copy(bufferChannel, bufferChannel + (readableFrames - firstFrames),
+                          outputChannels[channel] + firstFrames);
+            }
+
+            readPosition.store(position + readableFrames, std::memory_order_release);
+            return readableFrames;
+        }
+
+        void skip(std::size_t frames) noexcept
+        {
+            const auto position = readPosition.load(std::memory_order_relaxed);
+            readPosition.store(position + frames, std::memory_order_release);
+        }
+
+    private:
+        std::size_t capacity;
+        std::uint32_t channels;
+        std::vector<float> buffer;
+        std::atomic<std::size_t> readPosition{0};
+        std::atomic<std::size_t> writePosition{0};
+    };
+}
+
+#endif // OUZEL_AUDIO_MIXER_RINGBUFFER_HPP
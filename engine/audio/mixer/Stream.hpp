@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_MIXER_STREAM_HPP
 #define OUZEL_AUDIO_MIXER_STREAM_HPP
 
+#include <functional>
 #include "Object.hpp"
 #include "Bus.hpp"
 #include "Data.hpp"
@@ -50,14 +51,35 @@ namespace ouzel::audio::mixer
             if (shouldReset) reset();
         }
 
+        // virtual streams advance their position without generating samples
+        auto isVirtual() const noexcept { return virtualized; }
+        void setVirtual(bool newVirtual) noexcept { virtualized = newVirtual; }
+
+        // called on the mixer thread when the stream reaches its end
+        void setFinishCallback(std::function<void()> newFinishCallback)
+        {
+            finishCallback = std::move(newFinishCallback);
+        }
+
         virtual void reset() = 0;
 
         virtual void generateSamples(std::uint32_t frames, std::vector<float>& samples) = 0;
+        virtual void skipSamples(std::uint32_t frames) = 0;
 
     protected:
+        void finish()
+        {
+            playing = false;
+            if (finishCallback) finishCallback();
+        }
+
         Data& data;
         Bus* output = nullptr;
         bool playing = false;
+        bool virtualized = false;
+
+    private:
+        std::function<void()> finishCallback;
     };
 }
 
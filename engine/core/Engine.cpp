@@ -149,6 +149,26 @@ namespace ouzel::core
 
             settings.audioSettings.audioDevice = userEngineSection.getValue("audioDevice", defaultEngineSection.getValue("audioDevice"));
 
+            const auto& pcmCacheSizeValue = userEngineSection.getValue("pcmCacheSize", defaultEngineSection.getValue("pcmCacheSize"));
+            if (!pcmCacheSizeValue.empty()) settings.audioSettings.pcmCacheSize = static_cast<std::size_t>(std::stoull(pcmCacheSizeValue));
+
+            const auto& pcmCacheMaxLengthValue = userEngineSection.getValue("pcmCacheMaxLength", defaultEngineSection.getValue("pcmCacheMaxLength"));
+            if (!pcmCacheMaxLengthValue.empty()) settings.audioSettings.pcmCacheMaxLength = std::stof(pcmCacheMaxLengthValue);
+
+            const auto& pcmCacheFormatValue = userEngineSection.getValue("pcmCacheFormat", defaultEngineSection.getValue("pcmCacheFormat"));
+            if (!pcmCacheFormatValue.empty())
+            {
+                if (pcmCacheFormatValue == "int16")
+                    settings.audioSettings.pcmCacheFormat = audio::SampleFormat::signedInt16;
+                else if (pcmCacheFormatValue == "float32")
+                    settings.audioSettings.pcmCacheFormat = audio::SampleFormat::float32;
+                else
+                    throw std::runtime_error{"Invalid PCM cache format specified"};
+            }
+
+            const auto& maxVoicesValue = userEngineSection.getValue("maxVoices", defaultEngineSection.getValue("maxVoices"));
+            if (!maxVoicesValue.empty()) settings.audioSettings.maxVoices = static_cast<std::uint32_t>(std::stoul(maxVoicesValue));
+
             return settings;
         }
 
@@ -581,8 +601,8 @@ namespace ouzel::core
     {
         if (active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStop;
+            SystemEvent event;
+            event.type = Event::Type::engineStop;
             eventDispatcher.postEvent(std::move(event));
         }
 
@@ -592,14 +612,17 @@ namespace ouzel::core
 #ifndef __EMSCRIPTEN__
         if (updateThread.isJoinable()) updateThread.join();
 #endif
+
+        // the pending asset loads are abandoned instead of decoded
+        workerPool.stop();
     }
 
     void Engine::start()
     {
         if (!active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStart;
+            SystemEvent event;
+            event.type = Event::Type::engineStart;
             eventDispatcher.postEvent(std::move(event));
 
             active = true;
@@ -619,8 +642,8 @@ namespace ouzel::core
     {
         if (active && !paused)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::enginePause;
+            SystemEvent event;
+            event.type = Event::Type::enginePause;
             eventDispatcher.postEvent(std::move(event));
 
             paused = true;
@@ -631,8 +654,8 @@ namespace ouzel::core
     {
         if (active && paused)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineResume;
+            SystemEvent event;
+            event.type = Event::Type::engineResume;
             eventDispatcher.postEvent(std::move(event));
 
             paused = false;
@@ -645,8 +668,8 @@ namespace ouzel::core
 
         if (active)
         {
-            auto event = std::make_unique<SystemEvent>();
-            event->type = Event::Type::engineStop;
+            SystemEvent event;
+            event.type = Event::Type::engineStop;
             eventDispatcher.postEvent(std::move(event));
 
             active = false;
@@ -657,6 +680,14 @@ namespace ouzel::core
     {
         eventDispatcher.dispatchEvents();
 
+        std::unique_lock lock{updateThreadFunctionsMutex};
+        auto functions = std::move(updateThreadFunctions);
+        updateThreadFunctions.clear();
+        lock.unlock();
+
+        for (const auto& func : functions)
+            func();
+
         const auto currentTime = std::chrono::steady_clock::now();
         auto diff = currentTime - previousUpdateTime;
 
@@ -668,10 +699,10 @@ namespace ouzel::core
             previousUpdateTime = currentTime;
             const auto delta = static_cast<float>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) / 1000000.0F;
 
-            auto updateEvent = std::make_unique<UpdateEvent>();
-            updateEvent->type = Event::Type::update;
-            updateEvent->delta = delta;
-            eventDispatcher.dispatchEvent(std::move(updateEvent));
+            UpdateEvent updateEvent;
+            updateEvent.type = Event::Type::update;
+            updateEvent.delta = delta;
+            eventDispatcher.dispatchEvent(updateEvent);
         }
 
         inputManager.update();
@@ -692,6 +723,12 @@ namespace ouzel::core
         if (active) runOnMainThread(func);
     }
 
+    void Engine::executeOnUpdateThread(const std::function<void()>& func)
+    {
+        std::scoped_lock lock{updateThreadFunctionsMutex};
+        updateThreadFunctions.push_back(func);
+    }
+
     void Engine::engineMain()
     {
         try
@@ -724,31 +761,31 @@ namespace ouzel::core
         screenSaverEnabled = newScreenSaverEnabled;
     }
 
-    void Engine::handleEvents(std::queue<std::unique_ptr<Event>> windowEvents)
+    void Engine::handleEvents(std::queue<WindowEvent> windowEvents)
     {
         while (!windowEvents.empty())
         {
             auto windowEvent = std::move(windowEvents.front());
             windowEvents.pop();
 
-            switch (windowEvent->type)
+            switch (windowEvent.type)
             {
                 case Event::Type::windowSizeChange:
                     break;
                 case Event::Type::resolutionChange:
-                    graphics.setSize(static_cast<WindowEvent*>(windowEvent.get())->size);
+                    graphics.setSize(windowEvent.size);
                     sceneManager.calculateProjection();
                     break;
                 case Event::Type::fullscreenChange:
                     break;
                 case Event::Type::screenChange:
-                    graphics.changeScreen(static_cast<WindowEvent*>(windowEvent.get())->screenId);
+                    graphics.changeScreen(windowEvent.screenId);
                     break;
                 default:
                     break;
             }
 
-            eventDispatcher.dispatchEvent(std::move(windowEvent));
+            eventDispatcher.dispatchEvent(windowEvent);
         }
     }
 }
@@ -6,6 +6,7 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <mutex>
 #include <random>
 #include <thread>
 #include <vector>
@@ -86,6 +87,9 @@ namespace ouzel::core
         [[nodiscard]] auto& getNetwork() noexcept { return network; }
         [[nodiscard]] auto& getNetwork() const noexcept { return network; }
 
+        [[nodiscard]] auto& getWorkerPool() noexcept { return workerPool; }
+        [[nodiscard]] auto& getWorkerPool() const noexcept { return workerPool; }
+
         void start();
         void pause();
         void resume();
@@ -97,6 +101,7 @@ namespace ouzel::core
         void update();
 
         void executeOnMainThread(const std::function<void()>& func);
+        void executeOnUpdateThread(const std::function<void()>& func);
 
         virtual void openUrl(const std::string& url);
 
@@ -137,10 +142,9 @@ namespace ouzel::core
         assets::Bundle assetBundle;
         scene::SceneManager sceneManager;
         network::Network network;
-        WorkerPool workerPool;
 
     private:
-        void handleEvents(std::queue<std::unique_ptr<Event>> windowEvents);
+        void handleEvents(std::queue<WindowEvent> windowEvents);
         std::vector<std::string> args;
 
 #ifndef __EMSCRIPTEN__
@@ -148,6 +152,12 @@ namespace ouzel::core
 #endif
         std::chrono::steady_clock::time_point previousUpdateTime;
 
+        std::vector<std::function<void()>> updateThreadFunctions;
+        std::mutex updateThreadFunctionsMutex;
+
+        // the tasks post functions to the update thread, so the pool is destroyed first
+        WorkerPool workerPool;
+
         std::atomic_bool active{false};
         std::atomic_bool paused{false};
         std::atomic_bool oneUpdatePerFrame{false};
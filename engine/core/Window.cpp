@@ -69,11 +69,11 @@ namespace ouzel::core
     {
     }
 
-    std::queue<std::unique_ptr<Event>> Window::getEvents(bool waitForEvents)
+    std::queue<WindowEvent> Window::getEvents(bool waitForEvents)
     {
         auto events = nativeWindow.getEvents(waitForEvents);
 
-        std::queue<std::unique_ptr<Event>> result;
+        std::queue<WindowEvent> result;
 
         while (!events.empty())
         {
@@ -86,10 +86,10 @@ namespace ouzel::core
                 {
                     size = event.size;
 
-                    auto sizeChangeEvent = std::make_unique<WindowEvent>();
-                    sizeChangeEvent->type = Event::Type::windowSizeChange;
-                    sizeChangeEvent->window = this;
-                    sizeChangeEvent->size = event.size;
+                    WindowEvent sizeChangeEvent;
+                    sizeChangeEvent.type = Event::Type::windowSizeChange;
+                    sizeChangeEvent.window = this;
+                    sizeChangeEvent.size = event.size;
                     result.push(std::move(sizeChangeEvent));
                     break;
                 }
@@ -97,10 +97,10 @@ namespace ouzel::core
                 {
                     resolution = event.size;
 
-                    auto resolutionChangeEvent = std::make_unique<WindowEvent>();
-                    resolutionChangeEvent->type = Event::Type::resolutionChange;
-                    resolutionChangeEvent->window = this;
-                    resolutionChangeEvent->size = event.size;
+                    WindowEvent resolutionChangeEvent;
+                    resolutionChangeEvent.type = Event::Type::resolutionChange;
+                    resolutionChangeEvent.window = this;
+                    resolutionChangeEvent.size = event.size;
                     result.push(std::move(resolutionChangeEvent));
                     break;
                 }
@@ -108,10 +108,10 @@ namespace ouzel::core
                 {
                     fullscreen = event.fullscreen;
 
-                    auto fullscreenChangeEvent = std::make_unique<WindowEvent>();
-                    fullscreenChangeEvent->type = Event::Type::fullscreenChange;
-                    fullscreenChangeEvent->window = this;
-                    fullscreenChangeEvent->fullscreen = event.fullscreen;
+                    WindowEvent fullscreenChangeEvent;
+                    fullscreenChangeEvent.type = Event::Type::fullscreenChange;
+                    fullscreenChangeEvent.window = this;
+                    fullscreenChangeEvent.fullscreen = event.fullscreen;
                     result.push(std::move(fullscreenChangeEvent));
                     break;
                 }
@@ -119,10 +119,10 @@ namespace ouzel::core
                 {
                     displayId = event.displayId;
 
-                    auto screenChangeEvent = std::make_unique<WindowEvent>();
-                    screenChangeEvent->type = Event::Type::screenChange;
-                    screenChangeEvent->window = this;
-                    screenChangeEvent->screenId = event.displayId;
+                    WindowEvent screenChangeEvent;
+                    screenChangeEvent.type = Event::Type::screenChange;
+                    screenChangeEvent.window = this;
+                    screenChangeEvent.screenId = event.displayId;
                     result.push(std::move(screenChangeEvent));
                     break;
                 }
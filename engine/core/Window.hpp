@@ -64,7 +64,7 @@ namespace ouzel::core
         auto& getNativeWindow() const noexcept { return nativeWindow; }
 
         void close();
-        std::queue<std::unique_ptr<Event>> getEvents(bool waitForEvents);
+        std::queue<WindowEvent> getEvents(bool waitForEvents);
 
         auto& getSize() const noexcept { return size; }
         void setSize(const math::Size<std::uint32_t, 2>& newSize);
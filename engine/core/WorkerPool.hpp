@@ -104,10 +104,31 @@ namespace ouzel::core
 
         ~WorkerPool()
         {
+            std::unique_lock lock{taskQueueMutex};
             running = false;
+            lock.unlock();
             taskQueueCondition.notify_all();
         }
 
+        // drops the queued tasks and waits for the running ones to finish
+        void stop()
+        {
+            std::unique_lock lock{taskQueueMutex};
+            running = false;
+
+            while (!taskQueue.empty())
+            {
+                taskQueue.front().first.decrement();
+                taskQueue.pop();
+            }
+
+            lock.unlock();
+            taskQueueCondition.notify_all();
+
+            for (auto& worker : workers)
+                if (worker.isJoinable()) worker.join();
+        }
+
         Future run(TaskGroup&& taskGroup)
         {
             Promise promise{taskGroup};
@@ -115,9 +136,18 @@ namespace ouzel::core
 
             std::unique_lock lock{taskQueueMutex};
 
+            // the tasks are dropped after the pool is stopped, like the queued ones in stop()
+            if (!running)
+            {
+                for (; !taskGroup.taskQueue.empty(); taskGroup.taskQueue.pop())
+                    promise.decrement();
+
+                return future;
+            }
+
             while (!taskGroup.taskQueue.empty())
             {
-                taskQueue.push(std::pair(std::move(promise),
+                taskQueue.push(std::pair(promise, // all tasks share the state of the promise
                                          std::move(taskGroup.taskQueue.front())));
                 taskGroup.taskQueue.pop();
             }
@@ -133,12 +163,13 @@ namespace ouzel::core
         void work()
         {
             log(Log::Level::info) << "Worker started";
+            thread::setWorkerThread(true);
 
             for (;;)
             {
                 std::unique_lock lock{taskQueueMutex};
                 taskQueueCondition.wait(lock, [this]() noexcept { return !running || !taskQueue.empty(); });
-                if (!running) break;
+                if (taskQueue.empty()) break; // the queued tasks are finished before stopping
                 auto task = std::move(taskQueue.front());
                 taskQueue.pop();
                 lock.unlock();
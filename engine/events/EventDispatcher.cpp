@@ -7,205 +7,227 @@
 
 namespace ouzel
 {
+    namespace
+    {
+        template <class T>
+        bool dispatch(const std::vector<EventHandler*>& slots,
+                      const std::vector<std::size_t>& eventHandlers,
+                      std::function<bool(const T&)> EventHandler::*function,
+                      const T& event)
+        {
+            // the handlers can remove handlers but the list is not changed until the next update
+            for (std::size_t i = 0; i < eventHandlers.size(); ++i)
+                if (const auto eventHandler = slots[eventHandlers[i]];
+                    eventHandler && eventHandler->*function && (eventHandler->*function)(event))
+                    return true;
+
+            return false;
+        }
+    }
+
     EventDispatcher::~EventDispatcher()
     {
-        for (auto eventHandler : eventHandlerAddSet)
-            eventHandler->eventDispatcher = nullptr;
-
-        for (auto eventHandler : eventHandlers)
-            if (std::find(eventHandlerDeleteSet.begin(),
-                          eventHandlerDeleteSet.end(),
-                          eventHandler) == eventHandlerDeleteSet.end())
-                eventHandler->eventDispatcher = nullptr;
+        for (const auto eventHandler : slots)
+            if (eventHandler) eventHandler->eventDispatcher = nullptr;
     }
 
-    void EventDispatcher::dispatchEvents()
+    void EventDispatcher::updateEventHandlers()
     {
-        for (const auto eventHandler : eventHandlerDeleteSet)
-            if (const auto i = std::find(eventHandlers.begin(),
-                                         eventHandlers.end(),
-                                         eventHandler); i != eventHandlers.end())
-                eventHandlers.erase(i);
-
-        eventHandlerDeleteSet.clear();
-
-        for (const auto eventHandler : eventHandlerAddSet)
-            if (std::find(eventHandlers.begin(),
-                          eventHandlers.end(),
-                          eventHandler) == eventHandlers.end())
-            {
-                const auto upperBound = std::upper_bound(eventHandlers.begin(), eventHandlers.end(), eventHandler,
-                                                         [](const auto a, const auto b) noexcept {
-                                                                return a->priority > b->priority;
-                                                            });
+        if (!removedSlots.empty())
+        {
+            for (auto& categoryEventHandlers : eventHandlers)
+                categoryEventHandlers.erase(std::remove_if(categoryEventHandlers.begin(),
+                                                           categoryEventHandlers.end(),
+                                                           [this](const auto slot) noexcept {
+                                                               return slots[slot] == nullptr;
+                                                           }),
+                                            categoryEventHandlers.end());
+
+            freeSlots.insert(freeSlots.end(), removedSlots.begin(), removedSlots.end());
+            removedSlots.clear();
+        }
 
-                eventHandlers.insert(upperBound, eventHandler);
+        for (const auto slot : addedSlots)
+            if (const auto eventHandler = slots[slot])
+            {
+                const auto insert = [this, slot, eventHandler](const Category category) {
+                    auto& categoryEventHandlers = eventHandlers[static_cast<std::size_t>(category)];
+                    const auto upperBound = std::upper_bound(categoryEventHandlers.begin(), categoryEventHandlers.end(),
+                                                             eventHandler->priority,
+                                                             [this](const auto priority, const auto other) noexcept {
+                                                                 return priority > slots[other]->priority;
+                                                             });
+
+                    categoryEventHandlers.insert(upperBound, slot);
+                };
+
+                if (eventHandler->keyboardHandler) insert(Category::keyboard);
+                if (eventHandler->mouseHandler) insert(Category::mouse);
+                if (eventHandler->touchHandler) insert(Category::touch);
+                if (eventHandler->gamepadHandler) insert(Category::gamepad);
+                if (eventHandler->windowHandler) insert(Category::window);
+                if (eventHandler->systemHandler) insert(Category::system);
+                if (eventHandler->uiHandler) insert(Category::ui);
+                if (eventHandler->animationHandler) insert(Category::animation);
+                if (eventHandler->soundHandler) insert(Category::sound);
+                if (eventHandler->updateHandler) insert(Category::update);
+                if (eventHandler->userHandler) insert(Category::user);
             }
 
-        eventHandlerAddSet.clear();
+        addedSlots.clear();
+    }
 
-        std::pair<std::promise<bool>, std::unique_ptr<Event>> event;
+    void EventDispatcher::dispatchEvents()
+    {
+        updateEventHandlers();
 
         for (;;)
         {
-            std::unique_lock lock{eventQueueMutex};
-            if (eventQueue.empty()) break;
-
-            event = std::move(eventQueue.front());
-            eventQueue.pop();
-            lock.unlock();
+            // the events posted while dispatching are dispatched in the next pass
+            {
+                std::scoped_lock lock{eventQueueMutex};
+                std::swap(eventQueue, dispatchQueue);
+            }
 
-            event.first.set_value(dispatchEvent(std::move(event.second)));
-        }
-    }
+            if (dispatchQueue.empty()) break;
 
-    bool EventDispatcher::dispatchEvent(std::unique_ptr<Event> event)
-    {
-        if (!event) return false;
+            for (auto& entry : dispatchQueue)
+            {
+                const auto result = std::visit([this](const auto& event) {
+                    return dispatchEvent(event);
+                }, entry.event);
 
-        for (const auto eventHandler : eventHandlers)
-            if (std::find(eventHandlerDeleteSet.begin(),
-                          eventHandlerDeleteSet.end(),
-                          eventHandler) == eventHandlerDeleteSet.end())
-                switch (event->type)
+                if (entry.result)
                 {
-                    case Event::Type::keyboardConnect:
-                    case Event::Type::keyboardDisconnect:
-                    case Event::Type::keyboardKeyPress:
-                    case Event::Type::keyboardKeyRelease:
-                        if (eventHandler->keyboardHandler &&
-                            eventHandler->keyboardHandler(*static_cast<KeyboardEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::mouseConnect:
-                    case Event::Type::mouseDisconnect:
-                    case Event::Type::mousePress:
-                    case Event::Type::mouseRelease:
-                    case Event::Type::mouseScroll:
-                    case Event::Type::mouseMove:
-                    case Event::Type::mouseCursorLockChange:
-                        if (eventHandler->mouseHandler &&
-                            eventHandler->mouseHandler(*static_cast<MouseEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::touchpadConnect:
-                    case Event::Type::touchpadDisconnect:
-                    case Event::Type::touchBegin:
-                    case Event::Type::touchMove:
-                    case Event::Type::touchEnd:
-                    case Event::Type::touchCancel:
-                        if (eventHandler->touchHandler &&
-                            eventHandler->touchHandler(*static_cast<TouchEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::gamepadConnect:
-                    case Event::Type::gamepadDisconnect:
-                    case Event::Type::gamepadButtonChange:
-                        if (eventHandler->gamepadHandler &&
-                            eventHandler->gamepadHandler(*static_cast<GamepadEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::windowSizeChange:
-                    case Event::Type::fullscreenChange:
-                    case Event::Type::screenChange:
-                    case Event::Type::resolutionChange:
-                        if (eventHandler->windowHandler &&
-                            eventHandler->windowHandler(*static_cast<WindowEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::engineStart:
-                    case Event::Type::engineStop:
-                    case Event::Type::engineResume:
-                    case Event::Type::enginePause:
-                    case Event::Type::orientationChange:
-                    case Event::Type::lowMemory:
-                    case Event::Type::openFile:
-                        if (eventHandler->systemHandler &&
-                            eventHandler->systemHandler(*static_cast<SystemEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::actorEnter:
-                    case Event::Type::actorLeave:
-                    case Event::Type::actorPress:
-                    case Event::Type::actorRelease:
-                    case Event::Type::actorClick:
-                    case Event::Type::actorDrag:
-                    case Event::Type::widgetChange:
-                        if (eventHandler->uiHandler &&
-                            eventHandler->uiHandler(*static_cast<UIEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::animationStart:
-                    case Event::Type::animationReset:
-                    case Event::Type::animationFinish:
-                        if (eventHandler->animationHandler &&
-                            eventHandler->animationHandler(*static_cast<AnimationEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::soundStart:
-                    case Event::Type::soundReset:
-                    case Event::Type::soundFinish:
-                        if (eventHandler->soundHandler &&
-                            eventHandler->soundHandler(*static_cast<SoundEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::update:
-                        if (eventHandler->updateHandler &&
-                            eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get())))
-                            return true;
-                        break;
-                    case Event::Type::user:
-                        if (eventHandler->userHandler &&
-                            eventHandler->userHandler(*static_cast<UserEvent*>(event.get())))
-                            return true;
-                        break;
-                    default:
-                        return false; // custom event should not be sent
+                    entry.result->set_value(result);
+                    entry.result.reset();
                 }
+            }
+
+            dispatchQueue.clear();
+        }
+    }
 
-        return false;
+    bool EventDispatcher::dispatchEvent(const Event& event)
+    {
+        switch (event.type)
+        {
+            case Event::Type::keyboardConnect:
+            case Event::Type::keyboardDisconnect:
+            case Event::Type::keyboardKeyPress:
+            case Event::Type::keyboardKeyRelease:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::keyboard)],
+                                &EventHandler::keyboardHandler,
+                                static_cast<const KeyboardEvent&>(event));
+            case Event::Type::mouseConnect:
+            case Event::Type::mouseDisconnect:
+            case Event::Type::mousePress:
+            case Event::Type::mouseRelease:
+            case Event::Type::mouseScroll:
+            case Event::Type::mouseMove:
+            case Event::Type::mouseCursorLockChange:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::mouse)],
+                                &EventHandler::mouseHandler,
+                                static_cast<const MouseEvent&>(event));
+            case Event::Type::touchpadConnect:
+            case Event::Type::touchpadDisconnect:
+            case Event::Type::touchBegin:
+            case Event::Type::touchMove:
+            case Event::Type::touchEnd:
+            case Event::Type::touchCancel:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::touch)],
+                                &EventHandler::touchHandler,
+                                static_cast<const TouchEvent&>(event));
+            case Event::Type::gamepadConnect:
+            case Event::Type::gamepadDisconnect:
+            case Event::Type::gamepadButtonChange:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::gamepad)],
+                                &EventHandler::gamepadHandler,
+                                static_cast<const GamepadEvent&>(event));
+            case Event::Type::windowSizeChange:
+            case Event::Type::fullscreenChange:
+            case Event::Type::screenChange:
+            case Event::Type::resolutionChange:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::window)],
+                                &EventHandler::windowHandler,
+                                static_cast<const WindowEvent&>(event));
+            case Event::Type::engineStart:
+            case Event::Type::engineStop:
+            case Event::Type::engineResume:
+            case Event::Type::enginePause:
+            case Event::Type::orientationChange:
+            case Event::Type::lowMemory:
+            case Event::Type::openFile:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::system)],
+                                &EventHandler::systemHandler,
+                                static_cast<const SystemEvent&>(event));
+            case Event::Type::actorEnter:
+            case Event::Type::actorLeave:
+            case Event::Type::actorPress:
+            case Event::Type::actorRelease:
+            case Event::Type::actorClick:
+            case Event::Type::actorDrag:
+            case Event::Type::widgetChange:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::ui)],
+                                &EventHandler::uiHandler,
+                                static_cast<const UIEvent&>(event));
+            case Event::Type::animationStart:
+            case Event::Type::animationReset:
+            case Event::Type::animationFinish:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::animation)],
+                                &EventHandler::animationHandler,
+                                static_cast<const AnimationEvent&>(event));
+            case Event::Type::soundStart:
+            case Event::Type::soundReset:
+            case Event::Type::soundFinish:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::sound)],
+                                &EventHandler::soundHandler,
+                                static_cast<const SoundEvent&>(event));
+            case Event::Type::update:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::update)],
+                                &EventHandler::updateHandler,
+                                static_cast<const UpdateEvent&>(event));
+            case Event::Type::user:
+                return dispatch(slots, eventHandlers[static_cast<std::size_t>(Category::user)],
+                                &EventHandler::userHandler,
+                                static_cast<const UserEvent&>(event));
+            default:
+                return false; // custom event should not be sent
+        }
     }
 
     void EventDispatcher::addEventHandler(EventHandler& eventHandler)
     {
+        if (eventHandler.eventDispatcher == this) return;
+
         if (eventHandler.eventDispatcher)
             eventHandler.eventDispatcher->removeEventHandler(eventHandler);
 
         eventHandler.eventDispatcher = this;
 
-        eventHandlerAddSet.insert(&eventHandler);
-
-        const auto setIterator = eventHandlerDeleteSet.find(&eventHandler);
+        if (freeSlots.empty())
+        {
+            eventHandler.slot = slots.size();
+            slots.push_back(&eventHandler);
+        }
+        else
+        {
+            eventHandler.slot = freeSlots.back();
+            freeSlots.pop_back();
+            slots[eventHandler.slot] = &eventHandler;
+        }
 
-        if (setIterator != eventHandlerDeleteSet.end())
-            eventHandlerDeleteSet.erase(setIterator);
+        addedSlots.push_back(eventHandler.slot);
     }
 
     void EventDispatcher::removeEventHandler(EventHandler& eventHandler)
     {
-        if (eventHandler.eventDispatcher == this)
-            eventHandler.eventDispatcher = nullptr;
-
-        eventHandlerDeleteSet.insert(&eventHandler);
-
-        const auto setIterator = eventHandlerAddSet.find(&eventHandler);
-
-        if (setIterator != eventHandlerAddSet.end())
-            eventHandlerAddSet.erase(setIterator);
-    }
-
-    std::future<bool> EventDispatcher::postEvent(std::unique_ptr<Event> event)
-    {
-        std::promise<bool> promise;
-        auto future = promise.get_future();
+        if (eventHandler.eventDispatcher != this) return;
 
-#ifdef __EMSCRIPTEN__
-        promise.set_value(dispatchEvent(std::move(event)));
-#else
-        std::scoped_lock lock{eventQueueMutex};
-        eventQueue.push(std::pair<std::promise<bool>, std::unique_ptr<Event>>{std::move(promise), std::move(event)});
-#endif
+        eventHandler.eventDispatcher = nullptr;
 
-        return future;
+        // the slot is reused after it is removed from the lists
+        slots[eventHandler.slot] = nullptr;
+        removedSlots.push_back(eventHandler.slot);
     }
 }
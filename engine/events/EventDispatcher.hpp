@@ -3,11 +3,12 @@
 #ifndef OUZEL_EVENTS_EVENTDISPATCHER_HPP
 #define OUZEL_EVENTS_EVENTDISPATCHER_HPP
 
+#include <array>
 #include <cstdint>
 #include <future>
-#include <memory>
-#include <queue>
-#include <set>
+#include <mutex>
+#include <optional>
+#include <variant>
 #include <vector>
 #include "Event.hpp"
 
@@ -26,25 +27,119 @@ namespace ouzel
         EventDispatcher(EventDispatcher&&) = delete;
         EventDispatcher& operator=(EventDispatcher&&) = delete;
 
+        // the handler functions must be set before adding the handler
         void addEventHandler(EventHandler& eventHandler);
         void removeEventHandler(EventHandler& eventHandler);
 
         // dispatches the event immediately
-        bool dispatchEvent(std::unique_ptr<Event> event);
+        bool dispatchEvent(const Event& event);
 
-        // posts the event for dispatching on the game thread
-        std::future<bool> postEvent(std::unique_ptr<Event> event);
+        // posts a copy of the event for dispatching on the game thread
+        template <class T>
+        void postEvent(T&& event)
+        {
+#ifdef __EMSCRIPTEN__
+            dispatchEvent(event);
+#else
+            std::scoped_lock lock{eventQueueMutex};
+            eventQueue.push(std::forward<T>(event), std::nullopt);
+#endif
+        }
+
+        // posts a copy of the event for dispatching on the game thread and returns whether it was handled
+        template <class T>
+        std::future<bool> postEventWithResult(T&& event)
+        {
+            std::promise<bool> promise;
+            auto future = promise.get_future();
+
+#ifdef __EMSCRIPTEN__
+            promise.set_value(dispatchEvent(event));
+#else
+            std::scoped_lock lock{eventQueueMutex};
+            eventQueue.push(std::forward<T>(event), std::move(promise));
+#endif
+
+            return future;
+        }
 
         // dispatches all queued events on the game thread
         void dispatchEvents();
 
     private:
-        std::vector<EventHandler*> eventHandlers;
-        std::set<EventHandler*> eventHandlerAddSet;
-        std::set<EventHandler*> eventHandlerDeleteSet;
+        enum class Category
+        {
+            keyboard,
+            mouse,
+            touch,
+            gamepad,
+            window,
+            system,
+            ui,
+            animation,
+            sound,
+            update,
+            user
+        };
+
+        static constexpr std::size_t categoryCount = static_cast<std::size_t>(Category::user) + 1;
+
+        using QueuedEvent = std::variant<KeyboardEvent,
+                                         MouseEvent,
+                                         TouchEvent,
+                                         GamepadEvent,
+                                         WindowEvent,
+                                         SystemEvent,
+                                         UIEvent,
+                                         AnimationEvent,
+                                         SoundEvent,
+                                         UpdateEvent,
+                                         UserEvent>;
+
+        // the events are assigned to the entries that are kept for reuse
+        class EventQueue final
+        {
+        public:
+            struct Entry final
+            {
+                QueuedEvent event;
+                std::optional<std::promise<bool>> result;
+            };
+
+            template <class T>
+            void push(T&& event, std::optional<std::promise<bool>> result)
+            {
+                if (size == entries.size()) entries.emplace_back();
+
+                auto& entry = entries[size++];
+                entry.event = std::forward<T>(event);
+                entry.result = std::move(result);
+            }
+
+            auto begin() noexcept { return entries.begin(); }
+            auto end() noexcept { return entries.begin() + static_cast<std::ptrdiff_t>(size); }
+            bool empty() const noexcept { return size == 0; }
+            void clear() noexcept { size = 0; }
+
+        private:
+            std::vector<Entry> entries;
+            std::size_t size = 0;
+        };
+
+        void updateEventHandlers();
+
+        // the removed handlers are set to null until the next update
+        std::vector<EventHandler*> slots;
+        std::vector<std::size_t> freeSlots;
+        std::vector<std::size_t> addedSlots;
+        std::vector<std::size_t> removedSlots;
+
+        // slots of the handlers of each category in the order of priority
+        std::array<std::vector<std::size_t>, categoryCount> eventHandlers;
 
         std::mutex eventQueueMutex;
-        std::queue<std::pair<std::promise<bool>, std::unique_ptr<Event>>> eventQueue;
+        EventQueue eventQueue;
+        EventQueue dispatchQueue;
     };
 }
 
@@ -3,8 +3,9 @@
 #ifndef OUZEL_EVENTS_EVENTHANDLER_HPP
 #define OUZEL_EVENTS_EVENTHANDLER_HPP
 
-#include <functional>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include "Event.hpp"
 #include "EventDispatcher.hpp"
 
@@ -52,6 +53,7 @@ namespace ouzel
     private:
         Priority priority;
         EventDispatcher* eventDispatcher = nullptr;
+        std::size_t slot = 0;
     };
 }
 
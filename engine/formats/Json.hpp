@@ -5,10 +5,13 @@
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
+#include <charconv>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <functional>
-#include <map>
+#include <iterator>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -85,13 +88,242 @@ namespace ouzel::json
 
             return std::pair{true, iterator};
         }
+
+        [[nodiscard]]
+        constexpr bool isDigit(const char c) noexcept
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        template <class Iterator>
+        [[nodiscard]]
+        Iterator skipDigits(Iterator iterator, const Iterator end)
+        {
+            while (iterator != end && isDigit(static_cast<char>(*iterator)))
+                ++iterator;
+            return iterator;
+        }
+
+        template <class Iterator>
+        [[nodiscard]]
+        Iterator parseNumber(const Iterator begin, const Iterator end, std::variant<std::int64_t, double>& result)
+        {
+            Iterator iterator = begin;
+
+            if (static_cast<char>(*iterator) == '-')
+                if (++iterator == end || !isDigit(static_cast<char>(*iterator)))
+                    throw ParseError{"Invalid number"};
+
+            iterator = skipDigits(iterator, end);
+
+            bool floatingPoint = false;
+
+            if (iterator != end &&
+                static_cast<char>(*iterator) == '.')
+            {
+                floatingPoint = true;
+                iterator = skipDigits(++iterator, end);
+            }
+
+            // parse exponent
+            if (iterator != end &&
+                (static_cast<char>(*iterator) == 'e' ||
+                 static_cast<char>(*iterator) == 'E'))
+            {
+                floatingPoint = true;
+
+                if (++iterator == end)
+                    throw ParseError{"Invalid exponent"};
+
+                if (static_cast<char>(*iterator) == '+' ||
+                    static_cast<char>(*iterator) == '-')
+                    ++iterator;
+
+                if (iterator == end || !isDigit(static_cast<char>(*iterator)))
+                    throw ParseError{"Invalid exponent"};
+
+                iterator = skipDigits(iterator, end);
+            }
+
+            // the number is copied to a local buffer, because the iterators do not have to point to chars
+            // it is null-terminated for strtod
+            std::array<char, 65> buffer;
+            std::string longNumber;
+            const char* first = buffer.data();
+            const char* last = buffer.data();
+
+            if (const auto length = static_cast<std::size_t>(std::distance(begin, iterator)); length < buffer.size())
+            {
+                std::transform(begin, iterator, buffer.begin(), [](const auto c) noexcept {
+                    return static_cast<char>(c);
+                });
+                buffer[length] = '\0';
+                last = first + length;
+            }
+            else
+            {
+                longNumber.reserve(length);
+                for (auto i = begin; i != iterator; ++i)
+                    longNumber.push_back(static_cast<char>(*i));
+                first = longNumber.data();
+                last = first + length;
+            }
+
+            if (!floatingPoint)
+            {
+                std::int64_t integer = 0;
+                if (const auto [ptr, error] = std::from_chars(first, last, integer); error == std::errc{})
+                {
+                    result = integer;
+                    return iterator;
+                }
+                // integers that do not fit in 64 bits are stored as floating point numbers
+            }
+
+            double number = 0.0;
+#ifdef __cpp_lib_to_chars
+            if (const auto [ptr, error] = std::from_chars(first, last, number); error != std::errc{})
+                throw ParseError{"Invalid number"};
+#else
+            // the standard library does not support floating-point from_chars
+            errno = 0;
+            char* pointer;
+            number = std::strtod(first, &pointer);
+            if (pointer != last || errno == ERANGE)
+                throw ParseError{"Invalid number"};
+#endif
+
+            result = number;
+            return iterator;
+        }
+
+        inline void appendUtf8(const char32_t c, std::string& result)
+        {
+            if (c <= 0x7F)
+                result.push_back(static_cast<char>(c));
+            else if (c <= 0x7FF)
+            {
+                result.push_back(static_cast<char>(0xC0 | ((c >> 6) & 0x1F)));
+                result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            }
+            else if (c <= 0xFFFF)
+            {
+                result.push_back(static_cast<char>(0xE0 | ((c >> 12) & 0x0F)));
+                result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            }
+            else
+            {
+                result.push_back(static_cast<char>(0xF0 | ((c >> 18) & 0x07)));
+                result.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            }
+        }
+
+        template <class Iterator>
+        [[nodiscard]]
+        Iterator parseString(const Iterator begin, const Iterator end, std::string& result)
+        {
+            Iterator iterator = begin;
+
+            if (iterator == end || static_cast<char>(*iterator) != '"')
+                throw ParseError{"Invalid string"};
+
+            ++iterator;
+
+            while (iterator != end && static_cast<char>(*iterator) != '"')
+            {
+                if (static_cast<char>(*iterator) == '\\')
+                {
+                    if (++iterator == end)
+                        throw ParseError{"Unterminated string literal"};
+
+                    switch (static_cast<char>(*iterator))
+                    {
+                        case '"': result.push_back('"'); break;
+                        case '\\': result.push_back('\\'); break;
+                        case '/': result.push_back('/'); break;
+                        case 'b': result.push_back('\b'); break;
+                        case 'f': result.push_back('\f'); break;
+                        case 'n': result.push_back('\n'); break;
+                        case 'r': result.push_back('\r'); break;
+                        case 't': result.push_back('\t'); break;
+                        case 'u':
+                        {
+                            char32_t c = 0;
+
+                            for (std::uint32_t i = 0; i < 4; ++i)
+                            {
+                                if (++iterator == end)
+                                    throw ParseError{"Unexpected end of data"};
+
+                                std::uint8_t code = 0;
+
+                                if (static_cast<char>(*iterator) >= '0' && static_cast<char>(*iterator) <= '9')
+                                    code = static_cast<std::uint8_t>(*iterator) - '0';
+                                else if (static_cast<char>(*iterator) >= 'a' && static_cast<char>(*iterator) <='f')
+                                    code = static_cast<std::uint8_t>(*iterator) - 'a' + 10;
+                                else if (static_cast<char>(*iterator) >= 'A' && static_cast<char>(*iterator) <='F')
+                                    code = static_cast<std::uint8_t>(*iterator) - 'A' + 10;
+                                else
+                                    throw ParseError{"Invalid character code"};
+
+                                c = (c << 4) | code;
+                            }
+
+                            appendUtf8(c, result);
+                            break;
+                        }
+                        default:
+                            throw ParseError{"Unrecognized escape character"};
+                    }
+
+                    ++iterator;
+                }
+                else
+                {
+                    // the characters up to the next quote or escape are appended at once
+                    const auto runBegin = iterator;
+
+                    for (; iterator != end; ++iterator)
+                    {
+                        const auto c = static_cast<char>(*iterator);
+                        if (c == '"' || c == '\\') break;
+                        if (static_cast<std::uint8_t>(c) <= 0x1F) // control char
+                            throw ParseError{"Unterminated string literal"};
+                    }
+
+                    if constexpr (std::is_same_v<std::decay_t<decltype(*iterator)>, char>)
+                        result.append(runBegin, iterator);
+                    else
+                        for (auto i = runBegin; i != iterator; ++i)
+                            result.push_back(static_cast<char>(*i));
+                }
+            }
+
+            if (iterator == end || static_cast<char>(*iterator) != '"')
+                throw ParseError{"Invalid string"};
+
+            return ++iterator;
+        }
     }
 
     class Value final
     {
         using Array = std::vector<Value>;
-        using Object = std::map<std::string, Value, std::less<>>;
+        // members are kept in the insertion order, looked up from the end, so that the last duplicate wins
+        using Object = std::vector<std::pair<std::string, Value>>;
         using String = std::string;
+
+        template <class Members>
+        [[nodiscard]] static auto findMember(Members& members, std::string_view member) noexcept
+        {
+            return std::find_if(members.rbegin(), members.rend(), [member](const auto& entry) noexcept {
+                return entry.first == member;
+            });
+        }
+
     public:
         Value() noexcept = default;
 
@@ -288,7 +520,7 @@ namespace ouzel::json
         [[nodiscard]] bool hasMember(std::string_view member) const
         {
             if (const auto p = std::get_if<Object>(&value))
-                return p->find(member) != p->end();
+                return findMember(*p, member) != p->rend();
             else
                 throw TypeError{"Wrong type"};
         }
@@ -297,14 +529,10 @@ namespace ouzel::json
         {
             if (const auto p = std::get_if<Object>(&value))
             {
-                if (const auto iterator = p->find(member); iterator != p->end())
+                if (const auto iterator = findMember(*p, member); iterator != p->rend())
                     return iterator->second;
                 else
-                {
-                    const auto [newIterator, success] = p->insert({std::string{member}, Value{}});
-                    (void)success;
-                    return newIterator->second;
-                }
+                    return p->emplace_back(std::string{member}, Value{}).second;
             }
             else
                 throw TypeError{"Wrong type"};
@@ -314,7 +542,7 @@ namespace ouzel::json
         {
             if (const auto p = std::get_if<Object>(&value))
             {
-                if (const auto iterator = p->find(member); iterator != p->end())
+                if (const auto iterator = findMember(*p, member); iterator != p->rend())
                     return iterator->second;
                 else
                     throw RangeError{"Member does not exist"};
@@ -394,7 +622,7 @@ namespace ouzel::json
     };
 
     using Array = std::vector<Value>;
-    using Object = std::map<std::string, Value, std::less<>>;
+    using Object = std::vector<std::pair<std::string, Value>>;
     using String = std::string;
 
     template <class Iterator>
@@ -407,7 +635,9 @@ namespace ouzel::json
             static Value parse(const Iterator begin, const Iterator end)
             {
                 const auto startIterator = hasByteOrderMark(begin, end) ? begin + 3 : begin;
-                const auto [result, valueIterator] = parseValue(startIterator, end);
+
+                Value result;
+                const auto valueIterator = parseValue(startIterator, end, result);
                 if (const auto endIterator = skipWhiteSpaces(valueIterator, end); endIterator != end)
                     throw ParseError{"Unexpected data"};
 
@@ -415,8 +645,8 @@ namespace ouzel::json
             }
 
         private:
-            [[nodiscard]]
-            static std::pair<Value, Iterator> parseValue(const Iterator begin, const Iterator end)
+            // the values are parsed directly into their place in the parent, so no subtree is copied
+            static Iterator parseValue(const Iterator begin, const Iterator end, Value& result)
             {
                 Iterator iterator = skipWhiteSpaces(begin, end);
 
@@ -427,7 +657,8 @@ namespace ouzel::json
                 {
                     ++iterator;
 
-                    Value result = Object{};
+                    result = Object{};
+                    auto& object = result.as<Object>();
 
                     bool firstValue = true;
 
@@ -444,31 +675,26 @@ namespace ouzel::json
                             iterator = skipWhiteSpaces(iterator, end);
                         }
 
-                        const auto [key, stringIterator] = parseString(iterator, end);
-                        iterator = skipWhiteSpaces(stringIterator, end);
+                        auto& member = object.emplace_back();
+                        iterator = skipWhiteSpaces(parseString(iterator, end, member.first), end);
 
-                        if (static_cast<char>(*iterator++) != ':')
+                        if (iterator == end || static_cast<char>(*iterator++) != ':')
                             throw ParseError{"Invalid object"};
 
-                        iterator = skipWhiteSpaces(iterator, end);
-
-                        const auto [value, valueIterator] = parseValue(iterator, end);
-                        iterator = valueIterator;
-                        result[key] = std::move(value);
+                        iterator = parseValue(iterator, end, member.second);
                     }
 
                     if (iterator == end || static_cast<char>(*iterator) != '}')
                         throw ParseError{"Invalid object"};
 
-                    ++iterator;
-
-                    return std::pair{result, iterator};
+                    return ++iterator;
                 }
                 else if (static_cast<char>(*iterator) == '[')
                 {
                     ++iterator;
 
-                    Value result = Array{};
+                    result = Array{};
+                    auto& array = result.as<Array>();
 
                     bool firstValue = true;
 
@@ -485,100 +711,32 @@ namespace ouzel::json
                             iterator = skipWhiteSpaces(iterator, end);
                         }
 
-                        const auto [value, valueIterator] = parseValue(iterator, end);
-                        iterator = valueIterator;
-                        result.pushBack(value);
+                        iterator = parseValue(iterator, end, array.emplace_back());
                     }
 
                     if (iterator == end || static_cast<char>(*iterator) != ']')
                         throw ParseError{"Invalid array"};
 
-                    ++iterator;
-
-                    return std::pair{result, iterator};
+                    return ++iterator;
                 }
                 else if (static_cast<char>(*iterator) == '-' ||
                          (static_cast<char>(*iterator) >= '0' &&
                           static_cast<char>(*iterator) <= '9'))
                 {
-                    std::string value;
-
-                    if (static_cast<char>(*iterator) == '-')
-                    {
-                        value.push_back('-');
-
-                        if (++iterator == end ||
-                            static_cast<char>(*iterator) < '0' ||
-                            static_cast<char>(*iterator) > '9')
-                            throw ParseError{"Invalid number"};
-                    }
-
-                    while (iterator != end &&
-                           (static_cast<char>(*iterator) >= '0' &&
-                            static_cast<char>(*iterator) <= '9'))
-                    {
-                        value.push_back(static_cast<char>(*iterator));
-                        ++iterator;
-                    }
-
-                    bool floatingPoint = false;
-
-                    if (iterator != end &&
-                        static_cast<char>(*iterator) == '.')
-                    {
-                        floatingPoint = true;
-
-                        value.push_back(static_cast<char>(*iterator));
-                        ++iterator;
-
-                        while (iterator != end &&
-                               (static_cast<char>(*iterator) >= '0' &&
-                                static_cast<char>(*iterator) <= '9'))
-                        {
-                            value.push_back(static_cast<char>(*iterator));
-                            ++iterator;
-                        }
-                    }
-
-                    // parse exponent
-                    if (iterator != end &&
-                        (static_cast<char>(*iterator) == 'e' ||
-                         static_cast<char>(*iterator) == 'E'))
-                    {
-                        floatingPoint = true;
-
-                        value.push_back(static_cast<char>(*iterator));
+                    std::variant<std::int64_t, double> number;
+                    iterator = parseNumber(iterator, end, number);
 
-                        if (++iterator == end)
-                            throw ParseError{"Invalid exponent"};
-
-                        if (static_cast<char>(*iterator) == '+' ||
-                            static_cast<char>(*iterator) == '-')
-                            value.push_back(static_cast<char>(*iterator++));
-
-                        if (iterator == end ||
-                            static_cast<char>(*iterator) < '0' ||
-                            static_cast<char>(*iterator) > '9')
-                            throw ParseError{"Invalid exponent"};
-
-                        while (iterator != end &&
-                               static_cast<char>(*iterator) >= '0' &&
-                               static_cast<char>(*iterator) <= '9')
-                        {
-                            value.push_back(static_cast<char>(*iterator));
-                            ++iterator;
-                        }
-                    }
+                    if (const auto integer = std::get_if<std::int64_t>(&number))
+                        result = *integer;
+                    else
+                        result = std::get<double>(number);
 
-                    return floatingPoint ?
-                        std::pair{Value{std::stod(value)}, iterator} :
-                        std::pair{Value{static_cast<std::int64_t>(std::stoll(value))}, iterator};
+                    return iterator;
                 }
                 else if (static_cast<char>(*iterator) == '"')
                 {
-                    const auto [stringValue, stringIterator] = parseString(iterator, end);
-                    iterator = stringIterator;
-                    return std::pair{Value{stringValue}, iterator};
+                    result = String{};
+                    return parseString(iterator, end, result.as<String>());
                 }
                 else
                 {
@@ -591,118 +749,33 @@ namespace ouzel::json
                                                                std::end(trueString));
                     iterator = trueIterator;
                     if (isTrue)
-                        return std::pair{Value{true}, iterator};
+                    {
+                        result = true;
+                        return iterator;
+                    }
 
                     const auto [isFalse, falseIterator] = isSame(iterator, end,
                                                                  std::begin(falseString),
                                                                  std::end(falseString));
                     iterator = falseIterator;
                     if (isFalse)
-                        return std::pair{Value{false}, iterator};
+                    {
+                        result = false;
+                        return iterator;
+                    }
 
                     const auto [isNull, nullIterator] = isSame(iterator, end,
                                                                std::begin(nullString),
                                                                std::end(nullString));
                     iterator = nullIterator;
                     if (isNull)
-                        return std::pair{Value{nullptr}, iterator};
-
-                    throw ParseError{"Unexpected identifier"};
-                }
-            }
-
-            [[nodiscard]]
-            static std::pair<std::string, Iterator> parseString(const Iterator begin, const Iterator end)
-            {
-                std::string result;
-                Iterator iterator = begin;
-
-                if (iterator == end || static_cast<char>(*iterator) != '"')
-                    throw ParseError{"Invalid string"};
-
-                ++iterator;
-
-                while (iterator != end && static_cast<char>(*iterator) != '"')
-                {
-                    if (static_cast<char>(*iterator) == '\\')
                     {
-                        if (++iterator == end)
-                            throw ParseError{"Unterminated string literal"};
-
-                        switch (static_cast<char>(*iterator))
-                        {
-                            case '"': result.push_back('"'); break;
-                            case '\\': result.push_back('\\'); break;
-                            case '/': result.push_back('/'); break;
-                            case 'b': result.push_back('\b'); break;
-                            case 'f': result.push_back('\f'); break;
-                            case 'n': result.push_back('\n'); break;
-                            case 'r': result.push_back('\r'); break;
-                            case 't': result.push_back('\t'); break;
-                            case 'u':
-                            {
-                                char32_t c = 0;
-
-                                for (std::uint32_t i = 0; i < 4; ++i)
-                                {
-                                    if (++iterator == end)
-                                        throw ParseError{"Unexpected end of data"};
-
-                                    std::uint8_t code = 0;
-
-                                    if (static_cast<char>(*iterator) >= '0' && static_cast<char>(*iterator) <= '9')
-                                        code = static_cast<std::uint8_t>(*iterator) - '0';
-                                    else if (static_cast<char>(*iterator) >= 'a' && static_cast<char>(*iterator) <='f')
-                                        code = static_cast<std::uint8_t>(*iterator) - 'a' + 10;
-                                    else if (static_cast<char>(*iterator) >= 'A' && static_cast<char>(*iterator) <='F')
-                                        code = static_cast<std::uint8_t>(*iterator) - 'A' + 10;
-                                    else
-                                        throw ParseError{"Invalid character code"};
-
-                                    c = (c << 4) | code;
-                                }
-
-                                if (c <= 0x7F)
-                                    result.push_back(static_cast<char>(c));
-                                else if (c <= 0x7FF)
-                                {
-                                    result.push_back(static_cast<char>(0xC0 | ((c >> 6) & 0x1F)));
-                                    result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
-                                }
-                                else if (c <= 0xFFFF)
-                                {
-                                    result.push_back(static_cast<char>(0xE0 | ((c >> 12) & 0x0F)));
-                                    result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
-                                    result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
-                                }
-                                else
-                                {
-                                    result.push_back(static_cast<char>(0xF0 | ((c >> 18) & 0x07)));
-                                    result.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
-                                    result.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
-                                    result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
-                                }
-
-                                break;
-                            }
-                            default:
-                                throw ParseError{"Unrecognized escape character"};
-                        }
+                        result = nullptr;
+                        return iterator;
                     }
-                    else if (static_cast<std::uint8_t>(*iterator) <= 0x1F) // control char
-                        throw ParseError{"Unterminated string literal"};
-                    else
-                        result.push_back(static_cast<char>(*iterator));
 
-                    ++iterator;
+                    throw ParseError{"Unexpected identifier"};
                 }
-
-                if (iterator == end || static_cast<char>(*iterator) != '"')
-                    throw ParseError{"Invalid string"};
-
-                ++iterator;
-
-                return std::pair{result, iterator};
             }
         };
 
@@ -723,6 +796,182 @@ namespace ouzel::json
         return parse(begin(data), end(data));
     }
 
+    // pull reader that walks the document once without building a Value tree
+    class Reader final
+    {
+    public:
+        enum class Type
+        {
+            null,
+            boolean,
+            number,
+            string,
+            object,
+            array
+        };
+
+        Reader(const char* initBegin, const char* initEnd) noexcept:
+            iterator{initBegin}, end{initEnd}
+        {
+            if (hasByteOrderMark(iterator, end)) iterator += utf8ByteOrderMark.size();
+        }
+
+        template <class Data>
+        explicit Reader(const Data& data) noexcept:
+            Reader{reinterpret_cast<const char*>(std::data(data)),
+                   reinterpret_cast<const char*>(std::data(data)) + std::size(data)}
+        {
+            static_assert(sizeof(*std::data(data)) == 1, "Data must be a sequence of bytes");
+        }
+
+        // type of the next value
+        [[nodiscard]] Type peek()
+        {
+            iterator = skipWhiteSpaces(iterator, end);
+
+            if (iterator == end)
+                throw ParseError{"Unexpected end of data"};
+
+            switch (*iterator)
+            {
+                case '{': return Type::object;
+                case '[': return Type::array;
+                case '"': return Type::string;
+                case 't':
+                case 'f': return Type::boolean;
+                case 'n': return Type::null;
+                default:
+                    if (*iterator == '-' || isDigit(*iterator)) return Type::number;
+                    throw ParseError{"Unexpected identifier"};
+            }
+        }
+
+        void readNull()
+        {
+            constexpr char nullString[] = {'n', 'u', 'l', 'l'};
+            if (!readLiteral(std::begin(nullString), std::end(nullString)))
+                throw ParseError{"Expected null"};
+        }
+
+        [[nodiscard]] bool readBoolean()
+        {
+            constexpr char trueString[] = {'t', 'r', 'u', 'e'};
+            constexpr char falseString[] = {'f', 'a', 'l', 's', 'e'};
+
+            if (readLiteral(std::begin(trueString), std::end(trueString))) return true;
+            if (readLiteral(std::begin(falseString), std::end(falseString))) return false;
+
+            throw ParseError{"Expected a boolean"};
+        }
+
+        template <typename T, typename std::enable_if_t<std::is_arithmetic_v<T>>* = nullptr>
+        [[nodiscard]] T readNumber()
+        {
+            if (peek() != Type::number)
+                throw ParseError{"Expected a number"};
+
+            std::variant<std::int64_t, double> number;
+            iterator = parseNumber(iterator, end, number);
+
+            if (const auto integer = std::get_if<std::int64_t>(&number))
+                return static_cast<T>(*integer);
+            else
+                return static_cast<T>(std::get<double>(number));
+        }
+
+        [[nodiscard]] std::string readString()
+        {
+            std::string result;
+            iterator = parseString(skipWhiteSpaces(iterator, end), end, result);
+            return result;
+        }
+
+        // calls the function with the key of every member, the function must read or skip the value
+        template <class Function>
+        void readObject(Function function)
+        {
+            expect('{', "Expected an object");
+
+            if (skip('}')) return;
+
+            std::string key;
+            do
+            {
+                key.clear();
+                iterator = parseString(skipWhiteSpaces(iterator, end), end, key);
+                expect(':', "Invalid object");
+                function(std::string_view{key});
+            }
+            while (skip(','));
+
+            expect('}', "Invalid object");
+        }
+
+        // calls the function for every element, the function must read or skip the element
+        template <class Function>
+        void readArray(Function function)
+        {
+            expect('[', "Expected an array");
+
+            if (skip(']')) return;
+
+            do function();
+            while (skip(','));
+
+            expect(']', "Invalid array");
+        }
+
+        void skip()
+        {
+            switch (peek())
+            {
+                case Type::null: readNull(); break;
+                case Type::boolean: (void)readBoolean(); break;
+                case Type::number: (void)readNumber<double>(); break;
+                case Type::string: (void)readString(); break;
+                case Type::object: readObject([this](std::string_view) { skip(); }); break;
+                case Type::array: readArray([this]() { skip(); }); break;
+            }
+        }
+
+        // checks that there is nothing after the root value
+        void readEnd()
+        {
+            if (skipWhiteSpaces(iterator, end) != end)
+                throw ParseError{"Unexpected data"};
+        }
+
+    private:
+        bool skip(const char c)
+        {
+            iterator = skipWhiteSpaces(iterator, end);
+            if (iterator == end || *iterator != c) return false;
+            ++iterator;
+            return true;
+        }
+
+        void expect(const char c, const char* error)
+        {
+            if (!skip(c)) throw ParseError{error};
+        }
+
+        bool readLiteral(const char* literalBegin, const char* literalEnd)
+        {
+            iterator = skipWhiteSpaces(iterator, end);
+
+            const auto length = static_cast<std::size_t>(literalEnd - literalBegin);
+            if (static_cast<std::size_t>(end - iterator) < length ||
+                !std::equal(literalBegin, literalEnd, iterator))
+                return false;
+
+            iterator += length;
+            return true;
+        }
+
+        const char* iterator;
+        const char* end;
+    };
+
     [[nodiscard]]
     inline std::string encode(const Value& value,
                               const bool whiteSpaces = false,
@@ -755,7 +1004,7 @@ namespace ouzel::json
                     else if (c == '\n') result.insert(result.end(), {'\\', 'n'});
                     else if (c == '\r') result.insert(result.end(), {'\\', 'r'});
                     else if (c == '\t') result.insert(result.end(), {'\\', 't'});
-                    else if (c <= 0x1F)
+                    else if (static_cast<std::uint8_t>(c) <= 0x1F)
                     {
                         result.insert(result.end(), {'\\', 'u'});
 
@@ -6,11 +6,16 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "../utils/Span.hpp"
 #include "../utils/Utils.hpp"
 
 namespace ouzel::obf
@@ -61,6 +66,130 @@ namespace ouzel::obf
         dictionary
     };
 
+    // writes values straight to the end of the caller's buffer, the counts of the containers are written up front
+    class Writer final
+    {
+    public:
+        explicit Writer(std::vector<std::uint8_t>& initBuffer) noexcept:
+            buffer{initBuffer}
+        {
+        }
+
+        void writeInteger(const std::uint64_t value)
+        {
+            if (value > std::numeric_limits<std::uint32_t>::max())
+            {
+                const auto data = append(Marker::int64, sizeof(std::uint64_t));
+                encodeBigEndian<std::uint64_t>(data, value);
+            }
+            else if (value > std::numeric_limits<std::uint16_t>::max())
+            {
+                const auto data = append(Marker::int32, sizeof(std::uint32_t));
+                encodeBigEndian<std::uint32_t>(data, static_cast<std::uint32_t>(value));
+            }
+            else if (value > std::numeric_limits<std::uint8_t>::max())
+            {
+                const auto data = append(Marker::int16, sizeof(std::uint16_t));
+                encodeBigEndian<std::uint16_t>(data, static_cast<std::uint16_t>(value));
+            }
+            else
+                *append(Marker::int8, sizeof(std::uint8_t)) = static_cast<std::uint8_t>(value);
+        }
+
+        void writeFloat(const float value)
+        {
+            std::memcpy(append(Marker::floatingPoint, sizeof(value)), &value, sizeof(value));
+        }
+
+        void writeDouble(const double value)
+        {
+            std::memcpy(append(Marker::doublePrecision, sizeof(value)), &value, sizeof(value));
+        }
+
+        void writeString(const std::string_view value)
+        {
+            std::uint8_t* data;
+
+            if (value.length() > std::numeric_limits<std::uint16_t>::max())
+            {
+                if (value.length() > std::numeric_limits<std::uint32_t>::max())
+                    throw RangeError{"String is too long"};
+
+                data = append(Marker::longString, sizeof(std::uint32_t) + value.length());
+                encodeBigEndian<std::uint32_t>(data, static_cast<std::uint32_t>(value.length()));
+                data += sizeof(std::uint32_t);
+            }
+            else
+            {
+                data = append(Marker::string, sizeof(std::uint16_t) + value.length());
+                encodeBigEndian<std::uint16_t>(data, static_cast<std::uint16_t>(value.length()));
+                data += sizeof(std::uint16_t);
+            }
+
+            if (!value.empty()) std::memcpy(data, value.data(), value.length());
+        }
+
+        void writeByteArray(const Span<const std::uint8_t> value)
+        {
+            if (value.size() > std::numeric_limits<std::uint32_t>::max())
+                throw RangeError{"Byte array is too long"};
+
+            const auto data = append(Marker::byteArray, sizeof(std::uint32_t) + value.size());
+            encodeBigEndian<std::uint32_t>(data, static_cast<std::uint32_t>(value.size()));
+            if (!value.empty()) std::memcpy(data + sizeof(std::uint32_t), value.data(), value.size());
+        }
+
+        // must be followed by count pairs of writeKey(std::uint32_t) and a value
+        void beginObject(const std::uint32_t count)
+        {
+            encodeBigEndian<std::uint32_t>(append(Marker::object, sizeof(count)), count);
+        }
+
+        // must be followed by count values
+        void beginArray(const std::uint32_t count)
+        {
+            encodeBigEndian<std::uint32_t>(append(Marker::array, sizeof(count)), count);
+        }
+
+        // must be followed by count pairs of writeKey(std::string_view) and a value
+        void beginDictionary(const std::uint32_t count)
+        {
+            encodeBigEndian<std::uint32_t>(append(Marker::dictionary, sizeof(count)), count);
+        }
+
+        void writeKey(const std::uint32_t key)
+        {
+            encodeBigEndian<std::uint32_t>(append(sizeof(key)), key);
+        }
+
+        void writeKey(const std::string_view key)
+        {
+            if (key.length() > std::numeric_limits<std::uint16_t>::max())
+                throw RangeError{"Key is too long"};
+
+            const auto data = append(sizeof(std::uint16_t) + key.length());
+            encodeBigEndian<std::uint16_t>(data, static_cast<std::uint16_t>(key.length()));
+            if (!key.empty()) std::memcpy(data + sizeof(std::uint16_t), key.data(), key.length());
+        }
+
+    private:
+        std::uint8_t* append(const std::size_t size)
+        {
+            const auto offset = buffer.size();
+            buffer.resize(offset + size);
+            return buffer.data() + offset;
+        }
+
+        std::uint8_t* append(const Marker marker, const std::size_t size)
+        {
+            const auto data = append(sizeof(marker) + size);
+            *data = static_cast<std::uint8_t>(marker);
+            return data + sizeof(marker);
+        }
+
+        std::vector<std::uint8_t>& buffer;
+    };
+
     class Value final
     {
     public:
@@ -329,101 +458,12 @@ namespace ouzel::obf
 
         std::size_t encode(std::vector<std::uint8_t>& buffer) const
         {
-            std::size_t size = 0;
+            const auto originalSize = buffer.size();
 
-            switch (type)
-            {
-                case Type::integer:
-                {
-                    if (intValue > std::numeric_limits<std::uint32_t>::max())
-                    {
-                        buffer.push_back(static_cast<std::uint8_t>(Marker::int64));
-                        size += 1;
-                        size += writeInt64(buffer, intValue);
-                    }
-                    else if (intValue > std::numeric_limits<std::uint16_t>::max())
-                    {
-                        buffer.push_back(static_cast<std::uint8_t>(Marker::int32));
-                        size += 1;
-                        size += writeInt32(buffer, static_cast<std::uint32_t>(intValue));
-                    }
-                    else if (intValue > std::numeric_limits<std::uint8_t>::max())
-                    {
-                        buffer.push_back(static_cast<std::uint8_t>(Marker::int16));
-                        size += 1;
-                        size += writeInt16(buffer, static_cast<std::uint16_t>(intValue));
-                    }
-                    else
-                    {
-                        buffer.push_back(static_cast<std::uint8_t>(Marker::int8));
-                        size += 1;
-                        size += writeInt8(buffer, static_cast<std::uint8_t>(intValue));
-                    }
-                    break;
-                }
-                case Type::floatingPoint:
-                {
-                    buffer.push_back(static_cast<std::uint8_t>(Marker::floatingPoint));
-                    size += 1;
-                    size += writeFloat(buffer, static_cast<float>(doubleValue));
-                    break;
-                }
-                case Type::doublePrecision:
-                {
-                    buffer.push_back(static_cast<std::uint8_t>(Marker::doublePrecision));
-                    size += 1;
-                    size += writeDouble(buffer, doubleValue);
-                    break;
-                }
-                case Type::string:
-                {
-                    if (stringValue.length() > std::numeric_limits<std::uint16_t>::max())
-                    {
-                        buffer.push_back(static_cast<std::uint8_t>(Marker::longString));
-                        size += 1;
-                        size += writeLongString(buffer, stringValue);
-                    }
-                    else
-                    {
-                        buffer.push_back(static_cast<std::uint8_t>(Marker::string));
-                        size += 1;
-                        size += writeString(buffer, stringValue);
-                    }
-                    break;
-                }
-                case Type::byteArray:
-                {
-                    buffer.push_back(static_cast<std::uint8_t>(Marker::byteArray));
-                    size += 1;
-                    size += writeByteArray(buffer, byteArrayValue);
-                    break;
-                }
-                case Type::object:
-                {
-                    buffer.push_back(static_cast<std::uint8_t>(Marker::object));
-                    size += 1;
-                    size += writeObject(buffer, objectValue);
-                    break;
-                }
-                case Type::array:
-                {
-                    buffer.push_back(static_cast<std::uint8_t>(Marker::array));
-                    size += 1;
-                    size += writeArray(buffer, arrayValue);
-                    break;
-                }
-                case Type::dictionary:
-                {
-                    buffer.push_back(static_cast<std::uint8_t>(Marker::dictionary));
-                    size += 1;
-                    size += writeDictionary(buffer, dictionaryValue);
-                    break;
-                }
-                default:
-                    throw std::runtime_error{"Unsupported type"};
-            }
+            Writer writer{buffer};
+            write(writer);
 
-            return size;
+            return buffer.size() - originalSize;
         }
 
         bool operator!()
@@ -806,7 +846,7 @@ namespace ouzel::obf
 
                 offset += node.decode(buffer, offset);
 
-                result[static_cast<std::uint32_t>(key)] = node;
+                result[static_cast<std::uint32_t>(key)] = std::move(node);
             }
 
             return offset - originalOffset;
@@ -830,7 +870,7 @@ namespace ouzel::obf
                 Value node;
                 offset += node.decode(buffer, offset);
 
-                result.push_back(node);
+                result.push_back(std::move(node));
             }
 
             return offset - originalOffset;
@@ -868,214 +908,392 @@ namespace ouzel::obf
 
                 offset += node.decode(buffer, offset);
 
-                result[key] = node;
+                result[std::move(key)] = std::move(node);
             }
 
             return offset - originalOffset;
         }
 
-        // writing
-        static std::size_t writeInt8(std::vector<std::uint8_t>& buffer, std::uint8_t value)
+        void write(Writer& writer) const
         {
-            buffer.push_back(value);
-
-            return sizeof(value);
+            switch (type)
+            {
+                case Type::integer:
+                    writer.writeInteger(intValue);
+                    break;
+                case Type::floatingPoint:
+                    writer.writeFloat(static_cast<float>(doubleValue));
+                    break;
+                case Type::doublePrecision:
+                    writer.writeDouble(doubleValue);
+                    break;
+                case Type::string:
+                    writer.writeString(stringValue);
+                    break;
+                case Type::byteArray:
+                    writer.writeByteArray(byteArrayValue);
+                    break;
+                case Type::object:
+                    writer.beginObject(static_cast<std::uint32_t>(objectValue.size()));
+                    for (const auto& [key, entryValue] : objectValue)
+                    {
+                        writer.writeKey(key);
+                        entryValue.write(writer);
+                    }
+                    break;
+                case Type::array:
+                    writer.beginArray(static_cast<std::uint32_t>(arrayValue.size()));
+                    for (const auto& entryValue : arrayValue)
+                        entryValue.write(writer);
+                    break;
+                case Type::dictionary:
+                    writer.beginDictionary(static_cast<std::uint32_t>(dictionaryValue.size()));
+                    for (const auto& [key, entryValue] : dictionaryValue)
+                    {
+                        writer.writeKey(key);
+                        entryValue.write(writer);
+                    }
+                    break;
+                default:
+                    throw std::runtime_error{"Unsupported type"};
+            }
         }
 
-        static std::size_t writeInt16(std::vector<std::uint8_t>& buffer, std::uint16_t value)
+        Type type = Type::object;
+        union
         {
-            std::array<std::uint8_t, sizeof(value)> data;
-
-            encodeBigEndian<std::uint16_t>(data.data(), value);
+            std::uint64_t intValue = 0;
+            double doubleValue;
+        };
+        std::string stringValue;
+        ByteArray byteArrayValue;
+        Object objectValue;
+        Array arrayValue;
+        Dictionary dictionaryValue;
+    };
 
-            buffer.insert(buffer.end(), data.begin(), data.end());
+    // read-only view of an encoded value, decoded lazily from the buffer, that must outlive the view
+    class View final
+    {
+    public:
+        struct Entry;
+        class Iterator;
 
-            return sizeof(value);
+        View() noexcept = default;
+        View(const std::uint8_t* initData, std::size_t initSize) noexcept:
+            data{initData}, size{initSize}
+        {
         }
 
-        static std::size_t writeInt32(std::vector<std::uint8_t>& buffer, std::uint32_t value)
+        explicit View(Span<const std::uint8_t> buffer) noexcept:
+            View{buffer.data(), buffer.size()}
         {
-            std::array<std::uint8_t, sizeof(value)> data;
-
-            encodeBigEndian<std::uint32_t>(data.data(), value);
-
-            buffer.insert(buffer.end(), data.begin(), data.end());
-
-            return sizeof(value);
         }
 
-        static std::size_t writeInt64(std::vector<std::uint8_t>& buffer, std::uint64_t value)
+        explicit View(const std::vector<std::uint8_t>& buffer) noexcept:
+            View{buffer.data(), buffer.size()}
         {
-            std::array<std::uint8_t, sizeof(value)> data;
+        }
 
-            encodeBigEndian<std::uint64_t>(data.data(), value);
+        Type getType() const
+        {
+            switch (getMarker())
+            {
+                case Marker::int8:
+                case Marker::int16:
+                case Marker::int32:
+                case Marker::int64: return Type::integer;
+                case Marker::floatingPoint: return Type::floatingPoint;
+                case Marker::doublePrecision: return Type::doublePrecision;
+                case Marker::string:
+                case Marker::longString: return Type::string;
+                case Marker::byteArray: return Type::byteArray;
+                case Marker::object: return Type::object;
+                case Marker::array: return Type::array;
+                case Marker::dictionary: return Type::dictionary;
+                default: throw DecodeError{"Unsupported marker"};
+            }
+        }
 
-            buffer.insert(buffer.end(), data.begin(), data.end());
+        auto isIntType() const { return getType() == Type::integer; }
+        auto isFloatType() const { return getType() == Type::floatingPoint || getType() == Type::doublePrecision; }
+        auto isStringType() const { return getType() == Type::string; }
 
-            return sizeof(value);
+        template <typename T, typename std::enable_if_t<std::is_integral_v<T>>* = nullptr>
+        T as() const
+        {
+            switch (getMarker())
+            {
+                case Marker::int8: return static_cast<T>(*getPayload(sizeof(std::uint8_t)));
+                case Marker::int16: return static_cast<T>(decodeBigEndian<std::uint16_t>(getPayload(sizeof(std::uint16_t))));
+                case Marker::int32: return static_cast<T>(decodeBigEndian<std::uint32_t>(getPayload(sizeof(std::uint32_t))));
+                case Marker::int64: return static_cast<T>(decodeBigEndian<std::uint64_t>(getPayload(sizeof(std::uint64_t))));
+                default: throw TypeError{"Wrong type"};
+            }
         }
 
-        static std::size_t writeFloat(std::vector<std::uint8_t>& buffer, float value)
+        template <typename T, typename std::enable_if_t<std::is_floating_point_v<T>>* = nullptr>
+        T as() const
         {
-            buffer.insert(buffer.end(),
-                          reinterpret_cast<const std::uint8_t*>(&value),
-                          reinterpret_cast<const std::uint8_t*>(&value) + sizeof(value));
-
-            return sizeof(float);
+            switch (getMarker())
+            {
+                case Marker::floatingPoint:
+                {
+                    float result;
+                    std::memcpy(&result, getPayload(sizeof(result)), sizeof(result));
+                    return static_cast<T>(result);
+                }
+                case Marker::doublePrecision:
+                {
+                    double result;
+                    std::memcpy(&result, getPayload(sizeof(result)), sizeof(result));
+                    return static_cast<T>(result);
+                }
+                default: throw TypeError{"Wrong type"};
+            }
         }
 
-        static std::size_t writeDouble(std::vector<std::uint8_t>& buffer, double value)
+        // references the buffer
+        template <typename T, typename std::enable_if_t<std::is_same_v<T, std::string_view>>* = nullptr>
+        T as() const
         {
-            buffer.insert(buffer.end(),
-                          reinterpret_cast<const std::uint8_t*>(&value),
-                          reinterpret_cast<const std::uint8_t*>(&value) + sizeof(value));
+            if (getType() != Type::string) throw TypeError{"Wrong type"};
+            const auto [blob, length] = getBlob();
+            return std::string_view{reinterpret_cast<const char*>(blob), length};
+        }
 
-            return sizeof(double);
+        // references the buffer
+        template <typename T, typename std::enable_if_t<std::is_same_v<T, Span<const std::uint8_t>>>* = nullptr>
+        T as() const
+        {
+            if (getMarker() != Marker::byteArray) throw TypeError{"Wrong type"};
+            const auto [blob, length] = getBlob();
+            return Span<const std::uint8_t>{blob, length};
         }
 
-        static std::size_t writeString(std::vector<std::uint8_t>& buffer,
-                                       const std::string& value)
+        // number of the entries of an object, an array or a dictionary
+        std::uint32_t getSize() const
         {
-            std::array<std::uint8_t, sizeof(std::uint16_t)> lengthData;
+            const auto marker = getMarker();
+            if (marker != Marker::object && marker != Marker::array && marker != Marker::dictionary)
+                throw TypeError{"Wrong type"};
 
-            encodeBigEndian<std::uint16_t>(lengthData.data(), static_cast<std::uint16_t>(value.length()));
+            return decodeBigEndian<std::uint32_t>(getPayload(sizeof(std::uint32_t)));
+        }
 
-            buffer.insert(buffer.end(), lengthData.begin(), lengthData.end());
+        // the entries are decoded while iterating, the keys are the indices for the arrays
+        Iterator begin() const;
+        Iterator end() const;
 
-            auto size = lengthData.size();
+        // lookups walk the entries, because the encoding has no index
+        View operator[](std::uint32_t key) const;
+        View operator[](std::string_view key) const;
+        bool hasElement(std::uint32_t key) const;
+        bool hasElement(std::string_view key) const;
 
-            buffer.insert(buffer.end(),
-                          reinterpret_cast<const std::uint8_t*>(value.data()),
-                          reinterpret_cast<const std::uint8_t*>(value.data()) + value.length());
-            size += value.length();
+        // number of bytes the value takes in the buffer
+        std::size_t getEncodedSize() const;
 
-            return size;
+    private:
+        Marker getMarker() const
+        {
+            if (size < 1) throw DecodeError{"Not enough data"};
+            return static_cast<Marker>(*data);
         }
 
-        static std::size_t writeLongString(std::vector<std::uint8_t>& buffer,
-                                           const std::string& value)
+        std::size_t checkSize(std::size_t length) const
         {
-            std::array<std::uint8_t, sizeof(std::uint32_t)> lengthData;
-
-            encodeBigEndian<std::uint32_t>(lengthData.data(), static_cast<std::uint32_t>(value.length()));
-
-            buffer.insert(buffer.end(), lengthData.begin(), lengthData.end());
-
-            auto size = lengthData.size();
-
-            buffer.insert(buffer.end(),
-                          reinterpret_cast<const std::uint8_t*>(value.data()),
-                          reinterpret_cast<const std::uint8_t*>(value.data()) + value.length());
-            size += value.length();
+            if (size < length) throw DecodeError{"Not enough data"};
+            return length;
+        }
 
-            return size;
+        const std::uint8_t* getPayload(std::size_t length) const
+        {
+            checkSize(1 + length);
+            return data + 1;
         }
 
-        static std::size_t writeByteArray(std::vector<std::uint8_t>& buffer,
-                                          const ByteArray& value)
+        std::pair<const std::uint8_t*, std::size_t> getBlob() const
         {
-            std::array<std::uint8_t, sizeof(std::uint32_t)> lengthData;
+            const auto lengthSize = getMarker() == Marker::string ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+            const auto payload = getPayload(lengthSize);
+            const std::size_t length = lengthSize == sizeof(std::uint16_t) ?
+                decodeBigEndian<std::uint16_t>(payload) :
+                decodeBigEndian<std::uint32_t>(payload);
 
-            encodeBigEndian<std::uint32_t>(lengthData.data(), static_cast<std::uint32_t>(value.size()));
+            checkSize(1 + lengthSize + length);
+            return std::pair{payload + lengthSize, length};
+        }
 
-            buffer.insert(buffer.end(), lengthData.begin(), lengthData.end());
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
 
-            auto size = lengthData.size();
+    struct View::Entry final
+    {
+        std::uint32_t key = 0; // key of an object or index in an array
+        std::string_view name; // key of a dictionary, references the buffer
+        View value;
+    };
 
-            buffer.insert(buffer.end(), value.begin(), value.end());
-            size += value.size();
+    class View::Iterator final
+    {
+        friend View;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entry*;
+        using reference = const Entry&;
 
-            return size;
-        }
+        const Entry& operator*() const noexcept { return entry; }
+        const Entry* operator->() const noexcept { return &entry; }
 
-        static std::size_t writeObject(std::vector<std::uint8_t>& buffer,
-                                       const Object& value)
+        Iterator& operator++()
         {
-            std::array<std::uint8_t, sizeof(std::uint32_t)> lengthData;
+            position = entry.value.data + entry.value.getEncodedSize();
+            --remaining;
+            ++index;
+            decodeEntry();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const noexcept { return remaining == other.remaining; }
+        bool operator!=(const Iterator& other) const noexcept { return remaining != other.remaining; }
 
-            encodeBigEndian<std::uint32_t>(lengthData.data(), static_cast<std::uint32_t>(value.size()));
+    private:
+        Iterator(Marker initMarker, const std::uint8_t* initPosition, const std::uint8_t* initEnd,
+                 std::uint32_t initRemaining):
+            marker{initMarker}, position{initPosition}, end{initEnd}, remaining{initRemaining}
+        {
+            decodeEntry();
+        }
 
-            buffer.insert(buffer.end(), lengthData.begin(), lengthData.end());
+        void decodeEntry()
+        {
+            if (remaining == 0) return;
 
-            auto size = lengthData.size();
+            auto valuePosition = position;
 
-            for (const auto& [key, entryValue] : value)
+            if (marker == Marker::object)
             {
-                std::array<std::uint8_t, sizeof(std::uint32_t)> keyData;
+                if (static_cast<std::size_t>(end - valuePosition) < sizeof(std::uint32_t))
+                    throw DecodeError{"Not enough data"};
 
-                encodeBigEndian<std::uint32_t>(keyData.data(), key);
+                entry.key = decodeBigEndian<std::uint32_t>(valuePosition);
+                valuePosition += sizeof(std::uint32_t);
+            }
+            else if (marker == Marker::dictionary)
+            {
+                if (static_cast<std::size_t>(end - valuePosition) < sizeof(std::uint16_t))
+                    throw DecodeError{"Not enough data"};
 
-                buffer.insert(buffer.end(), keyData.begin(), keyData.end());
+                const auto length = decodeBigEndian<std::uint16_t>(valuePosition);
+                valuePosition += sizeof(std::uint16_t);
 
-                size += sizeof(keyData);
+                if (static_cast<std::size_t>(end - valuePosition) < length)
+                    throw DecodeError{"Not enough data"};
 
-                size += entryValue.encode(buffer);
+                entry.name = std::string_view{reinterpret_cast<const char*>(valuePosition), length};
+                valuePosition += length;
             }
+            else
+                entry.key = index;
 
-            return size;
+            entry.value = View{valuePosition, static_cast<std::size_t>(end - valuePosition)};
         }
 
-        static std::size_t writeArray(std::vector<std::uint8_t>& buffer,
-                                      const Array& value)
-        {
-            std::array<std::uint8_t, sizeof(std::uint32_t)> lengthData;
-
-            encodeBigEndian<std::uint32_t>(lengthData.data(), static_cast<std::uint32_t>(value.size()));
-
-            buffer.insert(buffer.end(), lengthData.begin(), lengthData.end());
+        Marker marker = Marker::array;
+        const std::uint8_t* position = nullptr;
+        const std::uint8_t* end = nullptr;
+        std::uint32_t remaining = 0;
+        std::uint32_t index = 0;
+        Entry entry;
+    };
 
-            auto size = lengthData.size();
+    inline View::Iterator View::begin() const
+    {
+        const auto count = getSize();
+        const auto entries = data + 1 + sizeof(std::uint32_t);
+        return Iterator{getMarker(), entries, data + size, count};
+    }
 
-            for (const auto& i : value)
-                size += i.encode(buffer);
+    inline View::Iterator View::end() const
+    {
+        return Iterator{getMarker(), data + size, data + size, 0};
+    }
 
-            return size;
+    inline std::size_t View::getEncodedSize() const
+    {
+        switch (getMarker())
+        {
+            case Marker::int8: return checkSize(1 + sizeof(std::uint8_t));
+            case Marker::int16: return checkSize(1 + sizeof(std::uint16_t));
+            case Marker::int32: return checkSize(1 + sizeof(std::uint32_t));
+            case Marker::int64: return checkSize(1 + sizeof(std::uint64_t));
+            case Marker::floatingPoint: return checkSize(1 + sizeof(float));
+            case Marker::doublePrecision: return checkSize(1 + sizeof(double));
+            case Marker::string:
+            case Marker::longString:
+            case Marker::byteArray:
+            {
+                const auto [blob, length] = getBlob();
+                return static_cast<std::size_t>(blob - data) + length;
+            }
+            case Marker::object:
+            case Marker::array:
+            case Marker::dictionary:
+            {
+                const auto last = end();
+                auto i = begin();
+                while (i != last) ++i;
+                return static_cast<std::size_t>(i.position - data);
+            }
+            default: throw DecodeError{"Unsupported marker"};
         }
+    }
 
-        static std::size_t writeDictionary(std::vector<std::uint8_t>& buffer,
-                                           const Dictionary& value)
-        {
-            std::array<std::uint8_t, sizeof(std::uint32_t)> sizeData;
+    inline View View::operator[](std::uint32_t key) const
+    {
+        if (getMarker() != Marker::object && getMarker() != Marker::array)
+            throw TypeError{"Wrong type"};
 
-            encodeBigEndian<std::uint32_t>(sizeData.data(), static_cast<std::uint32_t>(value.size()));
+        for (const auto& entry : *this)
+            if (entry.key == key) return entry.value;
 
-            buffer.insert(buffer.end(), sizeData.begin(), sizeData.end());
+        throw RangeError{"Index out of range"};
+    }
 
-            auto size = sizeData.size();
+    inline View View::operator[](std::string_view key) const
+    {
+        if (getMarker() != Marker::dictionary) throw TypeError{"Wrong type"};
 
-            for (const auto& [key, entryValue] : value)
-            {
-                std::array<std::uint8_t, sizeof(std::uint16_t)> lengthData;
+        for (const auto& entry : *this)
+            if (entry.name == key) return entry.value;
 
-                encodeBigEndian<std::uint16_t>(lengthData.data(), static_cast<std::uint16_t>(key.length()));
+        throw RangeError{"Invalid key"};
+    }
 
-                buffer.insert(buffer.end(), lengthData.begin(), lengthData.end());
+    inline bool View::hasElement(std::uint32_t key) const
+    {
+        if (getMarker() == Marker::array) return key < getSize();
+        if (getMarker() != Marker::object) throw TypeError{"Wrong type"};
 
-                size += sizeof(lengthData);
+        for (const auto& entry : *this)
+            if (entry.key == key) return true;
 
-                buffer.insert(buffer.end(),
-                              reinterpret_cast<const std::uint8_t*>(key.data()),
-                              reinterpret_cast<const std::uint8_t*>(key.data()) + key.length());
-                size += static_cast<std::uint32_t>(key.length());
+        return false;
+    }
 
-                size += entryValue.encode(buffer);
-            }
+    inline bool View::hasElement(std::string_view key) const
+    {
+        if (getMarker() != Marker::dictionary) throw TypeError{"Wrong type"};
 
-            return size;
-        }
+        for (const auto& entry : *this)
+            if (entry.name == key) return true;
 
-        Type type = Type::object;
-        union
-        {
-            std::uint64_t intValue = 0;
-            double doubleValue;
-        };
-        std::string stringValue;
-        ByteArray byteArrayValue;
-        Object objectValue;
-        Array arrayValue;
-        Dictionary dictionaryValue;
-    };
+        return false;
+    }
 }
 
 #endif // OUZEL_FORMATS_OBF_HPP
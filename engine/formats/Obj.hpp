@@ -0,0 +1,519 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_FORMATS_OBJ_HPP
+#define OUZEL_FORMATS_OBJ_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../graphics/Vertex.hpp"
+#include "../math/Box.hpp"
+#include "../thread/Thread.hpp"
+
+// Wavefront OBJ mesh parser
+namespace ouzel::obj
+{
+    class ParseError final: public std::logic_error
+    {
+    public:
+        using std::logic_error::logic_error;
+    };
+
+    struct Mesh final
+    {
+        std::string name; // empty for the faces before the first object
+        std::string material; // empty if no material is used
+        math::Box<float, 3> boundingBox;
+        std::vector<graphics::Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+    struct Data final
+    {
+        std::vector<std::string> materialLibraries;
+        std::vector<Mesh> meshes; // objects without faces are skipped
+    };
+
+    inline namespace detail
+    {
+        // face vertex as written in the file, the indices are resolved after all the chunks are parsed
+        struct FaceVertex final
+        {
+            // 1-based indices, 0 if the attribute is missing
+            // relative (negative in the file) indices are stored relative to the beginning of the chunk
+            std::int32_t indices[3]{};
+            std::uint8_t relative = 0; // bit mask of the relative indices
+        };
+
+        struct Command final
+        {
+            enum class Type
+            {
+                materialLibrary,
+                material,
+                object
+            };
+
+            Type type;
+            std::string name;
+            std::size_t faceCount; // number of the faces in the chunk before the command
+        };
+
+        // part of the file that is parsed independently of the other parts
+        struct Chunk final
+        {
+            std::vector<math::Vector<float, 3>> positions;
+            std::vector<math::Vector<float, 2>> texCoords;
+            std::vector<math::Vector<float, 3>> normals;
+            std::vector<FaceVertex> faceVertices;
+            std::vector<std::uint32_t> faceSizes;
+            std::vector<Command> commands;
+            std::exception_ptr exception;
+        };
+
+        [[nodiscard]] constexpr auto isWhiteSpace(const char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline void skipWhiteSpaces(const char*& iterator, const char* const end) noexcept
+        {
+            while (iterator != end && isWhiteSpace(*iterator))
+                ++iterator;
+        }
+
+        [[nodiscard]] inline std::string_view parseString(const char*& iterator, const char* const end)
+        {
+            skipWhiteSpaces(iterator, end);
+
+            const auto begin = iterator;
+            while (iterator != end && static_cast<std::uint8_t>(*iterator) > 0x20)
+                ++iterator;
+
+            if (iterator == begin)
+                throw ParseError{"Invalid string"};
+
+            return std::string_view{begin, static_cast<std::size_t>(iterator - begin)};
+        }
+
+        // returns 0 if there is no number, like the attributes that are left out
+        [[nodiscard]] inline float parseFloat(const char*& iterator, const char* const end)
+        {
+            skipWhiteSpaces(iterator, end);
+
+            if (iterator != end && *iterator == '+') ++iterator; // not accepted by from_chars
+
+            float result = 0.0F;
+#ifdef __cpp_lib_to_chars
+            if (const auto [pointer, error] = std::from_chars(iterator, end, result); error != std::errc::invalid_argument)
+                iterator = pointer;
+#else
+            // the standard library does not support floating-point from_chars
+            char buffer[64];
+            const auto length = std::min(static_cast<std::size_t>(end - iterator), sizeof(buffer) - 1);
+            std::memcpy(buffer, iterator, length);
+            buffer[length] = '\0';
+
+            char* pointer;
+            result = std::strtof(buffer, &pointer);
+            iterator += pointer - buffer;
+#endif
+            return result;
+        }
+
+        [[nodiscard]] inline std::int32_t parseIndex(const char*& iterator, const char* const end)
+        {
+            std::int32_t result = 0;
+            const auto [pointer, error] = std::from_chars(iterator, end, result);
+
+            if (error != std::errc{} || result == 0)
+                throw ParseError{"Invalid index"};
+
+            iterator = pointer;
+            return result;
+        }
+
+        inline void parseFace(const char* iterator, const char* const end, Chunk& chunk)
+        {
+            const std::size_t counts[3] = {
+                chunk.positions.size(),
+                chunk.texCoords.size(),
+                chunk.normals.size()
+            };
+
+            std::uint32_t faceSize = 0;
+
+            for (;;)
+            {
+                skipWhiteSpaces(iterator, end);
+                if (iterator == end) break;
+
+                FaceVertex faceVertex;
+
+                for (std::size_t attribute = 0; attribute < 3; ++attribute)
+                {
+                    // two slashes in a row indicate that there are no texture coordinates
+                    if (attribute == 0 || (iterator != end && *iterator != '/' && !isWhiteSpace(*iterator)))
+                    {
+                        if (const auto index = parseIndex(iterator, end); index > 0)
+                            faceVertex.indices[attribute] = index;
+                        else
+                        {
+                            faceVertex.indices[attribute] = static_cast<std::int32_t>(counts[attribute]) + index + 1;
+                            faceVertex.relative |= 1U << attribute;
+                        }
+                    }
+
+                    if (attribute == 2 || iterator == end || *iterator != '/') break;
+                    ++iterator;
+                }
+
+                chunk.faceVertices.push_back(faceVertex);
+                ++faceSize;
+            }
+
+            if (faceSize < 3)
+                throw ParseError{"Invalid face count"};
+
+            chunk.faceSizes.push_back(faceSize);
+        }
+
+        inline void parseLine(const char* iterator, const char* const end, Chunk& chunk)
+        {
+            skipWhiteSpaces(iterator, end);
+
+            // skip empty lines and comments
+            if (iterator == end || *iterator == '#') return;
+
+            const auto keyword = parseString(iterator, end);
+
+            if (keyword == "v")
+            {
+                const auto x = parseFloat(iterator, end);
+                const auto y = parseFloat(iterator, end);
+                const auto z = parseFloat(iterator, end);
+                chunk.positions.push_back(math::Vector<float, 3>{x, y, z});
+            }
+            else if (keyword == "vt")
+            {
+                const auto u = parseFloat(iterator, end);
+                const auto v = parseFloat(iterator, end);
+                chunk.texCoords.push_back(math::Vector<float, 2>{u, v});
+            }
+            else if (keyword == "vn")
+            {
+                const auto x = parseFloat(iterator, end);
+                const auto y = parseFloat(iterator, end);
+                const auto z = parseFloat(iterator, end);
+                chunk.normals.push_back(math::Vector<float, 3>{x, y, z});
+            }
+            else if (keyword == "f")
+                parseFace(iterator, end, chunk);
+            else if (keyword == "mtllib")
+                chunk.commands.push_back(Command{Command::Type::materialLibrary, std::string{parseString(iterator, end)}, chunk.faceSizes.size()});
+            else if (keyword == "usemtl")
+                chunk.commands.push_back(Command{Command::Type::material, std::string{parseString(iterator, end)}, chunk.faceSizes.size()});
+            else if (keyword == "o")
+                chunk.commands.push_back(Command{Command::Type::object, std::string{parseString(iterator, end)}, chunk.faceSizes.size()});
+
+            // all unknown commands are skipped
+        }
+
+        inline void parseChunk(const char* iterator, const char* const end, Chunk& chunk) noexcept
+        {
+            try
+            {
+                // the average line of a mesh is around 30 bytes long
+                const auto estimatedLineCount = static_cast<std::size_t>(end - iterator) / 30;
+                chunk.positions.reserve(estimatedLineCount / 4);
+                chunk.faceVertices.reserve(estimatedLineCount);
+                chunk.faceSizes.reserve(estimatedLineCount / 2);
+
+                while (iterator != end)
+                {
+                    auto lineEnd = static_cast<const char*>(std::memchr(iterator, '\n', static_cast<std::size_t>(end - iterator)));
+                    if (!lineEnd) lineEnd = end;
+
+                    parseLine(iterator, lineEnd, chunk);
+
+                    iterator = (lineEnd == end) ? end : lineEnd + 1;
+                }
+            }
+            catch (...)
+            {
+                chunk.exception = std::current_exception();
+            }
+        }
+
+        // flat open addressing hash map from the position, texture coordinate and normal indices to a vertex index
+        class VertexMap final
+        {
+        public:
+            void reserve(std::size_t count)
+            {
+                std::size_t capacity = 64;
+                while (capacity < count * 2) capacity <<= 1;
+
+                if (capacity > slots.size()) rehash(capacity);
+            }
+
+            // starts a new object without touching the slots
+            void clear() noexcept
+            {
+                ++generation;
+                size = 0;
+
+                if (generation == 0) // wrapped around, the old generations must not match
+                {
+                    std::fill(slots.begin(), slots.end(), Slot{});
+                    generation = 1;
+                }
+            }
+
+            // returns the index of the existing vertex or inserts the new index
+            std::pair<std::uint32_t, bool> insert(const std::uint32_t (&key)[3], const std::uint32_t index)
+            {
+                if ((size + 1) * 2 > slots.size()) rehash(std::max(slots.size() * 2, std::size_t{64}));
+
+                for (auto i = getSlot(key);; i = (i + 1) & (slots.size() - 1))
+                {
+                    auto& slot = slots[i];
+
+                    if (slot.generation != generation)
+                    {
+                        slot = Slot{generation, {key[0], key[1], key[2]}, index};
+                        ++size;
+                        return {index, true};
+                    }
+
+                    if (slot.key[0] == key[0] && slot.key[1] == key[1] && slot.key[2] == key[2])
+                        return {slot.index, false};
+                }
+            }
+
+        private:
+            struct Slot final
+            {
+                std::uint32_t generation = 0;
+                std::uint32_t key[3]{};
+                std::uint32_t index = 0;
+            };
+
+            std::size_t getSlot(const std::uint32_t (&key)[3]) const noexcept
+            {
+                // Fibonacci hashing of the combined indices
+                const auto value = (key[0] + key[1] * 0x9E3779B1ULL + key[2] * 0x85EBCA77ULL) * 0x9E3779B97F4A7C15ULL;
+                return static_cast<std::size_t>(value >> 32) & (slots.size() - 1);
+            }
+
+            void rehash(std::size_t capacity)
+            {
+                std::vector<Slot> oldSlots(capacity);
+                std::swap(slots, oldSlots);
+                size = 0;
+
+                for (const auto& slot : oldSlots)
+                    if (slot.generation == generation)
+                        for (auto i = getSlot(slot.key);; i = (i + 1) & (slots.size() - 1))
+                            if (slots[i].generation != generation)
+                            {
+                                slots[i] = slot;
+                                ++size;
+                                break;
+                            }
+            }
+
+            std::vector<Slot> slots;
+            std::size_t size = 0;
+            std::uint32_t generation = 1;
+        };
+
+        template <typename T>
+        std::vector<T> concatenate(std::vector<Chunk>& chunks, std::vector<T> Chunk::* attribute)
+        {
+            if (chunks.size() == 1) return std::move(chunks.front().*attribute);
+
+            std::size_t count = 0;
+            for (const auto& chunk : chunks) count += (chunk.*attribute).size();
+
+            std::vector<T> result;
+            result.reserve(count);
+            for (auto& chunk : chunks)
+            {
+                result.insert(result.end(), (chunk.*attribute).begin(), (chunk.*attribute).end());
+                (chunk.*attribute) = std::vector<T>{};
+            }
+
+            return result;
+        }
+    }
+
+    inline Data parse(const std::byte* data, std::size_t size)
+    {
+        const auto begin = reinterpret_cast<const char*>(data);
+        const auto end = begin + size;
+
+        // large files are split into chunks at line boundaries and parsed on separate threads,
+        // unless this already runs on a worker of a pool
+        constexpr std::size_t minChunkSize = 4U * 1024U * 1024U;
+        const std::size_t cpuCount = thread::isWorkerThread() ? 1U :
+            std::max(std::thread::hardware_concurrency(), 1U);
+        const auto chunkCount = std::clamp(size / minChunkSize, std::size_t{1}, cpuCount);
+
+        std::vector<Chunk> chunks(chunkCount);
+        std::vector<const char*> boundaries{begin};
+
+        for (std::size_t i = 1; i < chunkCount; ++i)
+        {
+            auto boundary = std::max(begin + size * i / chunkCount, boundaries.back());
+            while (boundary != end && *boundary != '\n') ++boundary;
+            if (boundary != end) ++boundary;
+            boundaries.push_back(boundary);
+        }
+        boundaries.push_back(end);
+
+        std::vector<thread::Thread> threads;
+        threads.reserve(chunkCount - 1);
+
+        for (std::size_t i = 1; i < chunkCount; ++i)
+            threads.emplace_back(parseChunk, boundaries[i], boundaries[i + 1], std::ref(chunks[i]));
+
+        parseChunk(boundaries[0], boundaries[1], chunks[0]);
+
+        for (auto& t : threads) t.join();
+
+        for (const auto& chunk : chunks)
+            if (chunk.exception) std::rethrow_exception(chunk.exception);
+
+        // the vertices are assembled on the calling thread in the order of the file
+        std::size_t offsets[3] = {0, 0, 0};
+        std::size_t faceVertexCount = 0;
+        std::size_t indexCount = 0;
+
+        std::vector<std::array<std::size_t, 3>> chunkOffsets;
+        chunkOffsets.reserve(chunks.size());
+
+        for (const auto& chunk : chunks)
+        {
+            chunkOffsets.push_back({offsets[0], offsets[1], offsets[2]});
+            offsets[0] += chunk.positions.size();
+            offsets[1] += chunk.texCoords.size();
+            offsets[2] += chunk.normals.size();
+            faceVertexCount += chunk.faceVertices.size();
+            for (const auto faceSize : chunk.faceSizes) indexCount += (faceSize - 2) * 3;
+        }
+
+        const auto positions = concatenate(chunks, &Chunk::positions);
+        const auto texCoords = concatenate(chunks, &Chunk::texCoords);
+        const auto normals = concatenate(chunks, &Chunk::normals);
+        const std::size_t counts[3] = {positions.size(), texCoords.size(), normals.size()};
+
+        Data result;
+        Mesh mesh;
+        std::vector<std::uint32_t> faceIndices;
+        VertexMap vertexMap;
+
+        // the first mesh usually holds all of the faces
+        mesh.vertices.reserve(std::min(faceVertexCount, positions.size() * 2));
+        mesh.indices.reserve(indexCount);
+        vertexMap.reserve(mesh.vertices.capacity());
+
+        const auto runCommand = [&](const Command& command) {
+            switch (command.type)
+            {
+                case Command::Type::materialLibrary:
+                    if (std::find(result.materialLibraries.begin(), result.materialLibraries.end(), command.name) == result.materialLibraries.end())
+                        result.materialLibraries.push_back(command.name);
+                    break;
+                case Command::Type::material:
+                    mesh.material = command.name;
+                    break;
+                case Command::Type::object:
+                    if (!mesh.indices.empty())
+                        result.meshes.push_back(std::move(mesh));
+
+                    mesh = Mesh{};
+                    mesh.name = command.name;
+                    vertexMap.clear();
+                    break;
+            }
+        };
+
+        for (std::size_t c = 0; c < chunks.size(); ++c)
+        {
+            const auto& chunk = chunks[c];
+            auto command = chunk.commands.begin();
+            auto faceVertex = chunk.faceVertices.begin();
+
+            for (std::size_t face = 0; face < chunk.faceSizes.size(); ++face)
+            {
+                for (; command != chunk.commands.end() && command->faceCount == face; ++command)
+                    runCommand(*command);
+
+                faceIndices.clear();
+
+                for (std::uint32_t i = 0; i < chunk.faceSizes[face]; ++i, ++faceVertex)
+                {
+                    std::uint32_t key[3];
+
+                    for (std::size_t attribute = 0; attribute < 3; ++attribute)
+                    {
+                        const bool relative = faceVertex->relative & (1U << attribute);
+                        std::int64_t index = faceVertex->indices[attribute];
+                        if (relative) index += static_cast<std::int64_t>(chunkOffsets[c][attribute]);
+
+                        // only the texture coordinates and normals can be left out
+                        const bool present = attribute == 0 || relative || index != 0;
+                        if (present && (index < 1 || index > static_cast<std::int64_t>(counts[attribute])))
+                            throw ParseError{"Invalid vertex index"};
+
+                        key[attribute] = static_cast<std::uint32_t>(index);
+                    }
+
+                    const auto [index, inserted] = vertexMap.insert(key, static_cast<std::uint32_t>(mesh.vertices.size()));
+
+                    if (inserted)
+                    {
+                        graphics::Vertex vertex;
+                        vertex.position = positions[key[0] - 1];
+                        if (key[1] >= 1) vertex.texCoords[0] = texCoords[key[1] - 1];
+                        vertex.color = math::whiteColor;
+                        if (key[2] >= 1) vertex.normal = normals[key[2] - 1];
+                        mesh.vertices.push_back(vertex);
+                        insertPoint(mesh.boundingBox, vertex.position);
+                    }
+
+                    faceIndices.push_back(index);
+                }
+
+                // polygons are triangulated as fans
+                for (std::size_t i = 1; i + 1 < faceIndices.size(); ++i)
+                {
+                    mesh.indices.push_back(faceIndices[0]);
+                    mesh.indices.push_back(faceIndices[i]);
+                    mesh.indices.push_back(faceIndices[i + 1]);
+                }
+            }
+
+            for (; command != chunk.commands.end(); ++command)
+                runCommand(*command);
+        }
+
+        if (!mesh.indices.empty())
+            result.meshes.push_back(std::move(mesh));
+
+        return result;
+    }
+}
+
+#endif // OUZEL_FORMATS_OBJ_HPP
@@ -0,0 +1,288 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_FORMATS_OMESH_HPP
+#define OUZEL_FORMATS_OMESH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../graphics/Vertex.hpp"
+#include "../math/Box.hpp"
+#include "../utils/Span.hpp"
+#include "../utils/Utils.hpp"
+
+// Precompiled static meshes with the vertices and indices in the GPU layout
+//
+// header (little-endian):
+//   magic "OMSH", version (uint32), material library count (uint32), mesh count (uint32)
+//   for every material library: name length (uint32), name
+//   for every mesh:
+//     name length (uint32), name (empty for the unnamed mesh), material length (uint32), material
+//     bounding box minimum and maximum (6 floats)
+//     index size (uint32), index count (uint32), vertex count (uint32)
+//     index offset (uint64), vertex offset (uint64)
+// followed by the indices and the vertices of the meshes, each aligned to 16 bytes
+// the vertices are stored as graphics::Vertex of a little-endian platform
+namespace ouzel::omesh
+{
+    class DecodeError final: public std::logic_error
+    {
+    public:
+        using std::logic_error::logic_error;
+    };
+
+    constexpr std::uint8_t magic[4] = {'O', 'M', 'S', 'H'};
+    constexpr std::uint32_t version = 1;
+    constexpr std::size_t headerSize = 16;
+    constexpr std::size_t meshHeaderSize = 52;
+    constexpr std::size_t vertexSize = 44;
+    constexpr std::size_t dataAlignment = 16;
+
+    static_assert(sizeof(graphics::Vertex) == vertexSize, "Vertex layout does not match the file format");
+
+    inline bool isOmesh(const std::byte* data, std::size_t size) noexcept
+    {
+        return size >= sizeof(magic) && std::memcmp(data, magic, sizeof(magic)) == 0;
+    }
+
+    // mesh to encode
+    struct Mesh final
+    {
+        std::string name;
+        std::string material;
+        math::Box<float, 3> boundingBox;
+        std::vector<graphics::Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+    inline namespace detail
+    {
+        inline float decodeFloat(const std::byte* data) noexcept
+        {
+            const auto bits = decodeLittleEndian<std::uint32_t>(data);
+            float result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        inline void encodeFloat(std::uint8_t* buffer, float value) noexcept
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            encodeLittleEndian<std::uint32_t>(buffer, bits);
+        }
+
+        constexpr std::size_t alignOffset(std::size_t offset) noexcept
+        {
+            return (offset + dataAlignment - 1) & ~(dataAlignment - 1);
+        }
+    }
+
+    // view of precompiled meshes, the data must outlive it
+    class Data final
+    {
+    public:
+        struct Mesh final
+        {
+            std::string_view name;
+            std::string_view material;
+            math::Box<float, 3> boundingBox;
+            std::uint32_t indexSize = 0;
+            std::uint32_t indexCount = 0;
+            std::uint32_t vertexCount = 0;
+            Span<const std::byte> indexData;
+            Span<const std::byte> vertexData;
+        };
+
+        Data(const std::byte* initData, std::size_t initSize):
+            data{initData}, size{initSize}
+        {
+            if (!isOmesh(data, size) || size < headerSize)
+                throw DecodeError{"Not a precompiled mesh"};
+
+            if (decodeLittleEndian<std::uint32_t>(data + 4) != version)
+                throw DecodeError{"Unsupported precompiled mesh version"};
+
+            const std::size_t materialLibraryCount = decodeLittleEndian<std::uint32_t>(data + 8);
+            const std::size_t meshCount = decodeLittleEndian<std::uint32_t>(data + 12);
+
+            std::size_t offset = headerSize;
+
+            materialLibraries.reserve(std::min(materialLibraryCount, size / sizeof(std::uint32_t)));
+            for (std::size_t i = 0; i < materialLibraryCount; ++i)
+                materialLibraries.push_back(readString(offset));
+
+            meshes.reserve(std::min(meshCount, size / meshHeaderSize));
+            for (std::size_t i = 0; i < meshCount; ++i)
+            {
+                Mesh mesh;
+                mesh.name = readString(offset);
+                mesh.material = readString(offset);
+
+                if (size - offset < meshHeaderSize)
+                    throw DecodeError{"Invalid mesh header"};
+
+                const auto meshHeader = data + offset;
+                offset += meshHeaderSize;
+
+                mesh.boundingBox.min = math::Vector<float, 3>{
+                    decodeFloat(meshHeader),
+                    decodeFloat(meshHeader + 4),
+                    decodeFloat(meshHeader + 8)
+                };
+                mesh.boundingBox.max = math::Vector<float, 3>{
+                    decodeFloat(meshHeader + 12),
+                    decodeFloat(meshHeader + 16),
+                    decodeFloat(meshHeader + 20)
+                };
+
+                mesh.indexSize = decodeLittleEndian<std::uint32_t>(meshHeader + 24);
+                mesh.indexCount = decodeLittleEndian<std::uint32_t>(meshHeader + 28);
+                mesh.vertexCount = decodeLittleEndian<std::uint32_t>(meshHeader + 32);
+
+                if (mesh.indexSize != sizeof(std::uint16_t) && mesh.indexSize != sizeof(std::uint32_t))
+                    throw DecodeError{"Invalid index size"};
+
+                mesh.indexData = getBlob(decodeLittleEndian<std::uint64_t>(meshHeader + 36),
+                                         static_cast<std::uint64_t>(mesh.indexCount) * mesh.indexSize);
+                mesh.vertexData = getBlob(decodeLittleEndian<std::uint64_t>(meshHeader + 44),
+                                          static_cast<std::uint64_t>(mesh.vertexCount) * vertexSize);
+
+                meshes.push_back(mesh);
+            }
+        }
+
+        auto& getMaterialLibraries() const noexcept { return materialLibraries; }
+        auto& getMeshes() const noexcept { return meshes; }
+
+    private:
+        std::string_view readString(std::size_t& offset) const
+        {
+            if (size - offset < sizeof(std::uint32_t))
+                throw DecodeError{"Invalid string"};
+
+            const std::size_t length = decodeLittleEndian<std::uint32_t>(data + offset);
+            offset += sizeof(std::uint32_t);
+
+            if (size - offset < length)
+                throw DecodeError{"Invalid string"};
+
+            const std::string_view result{reinterpret_cast<const char*>(data + offset), length};
+            offset += length;
+            return result;
+        }
+
+        Span<const std::byte> getBlob(std::uint64_t offset, std::uint64_t blobSize) const
+        {
+            if (offset > size || blobSize > size - offset)
+                throw DecodeError{"Mesh data out of bounds"};
+
+            return Span<const std::byte>{data + offset, static_cast<std::size_t>(blobSize)};
+        }
+
+        const std::byte* data;
+        std::size_t size;
+        std::vector<std::string_view> materialLibraries;
+        std::vector<Mesh> meshes;
+    };
+
+    inline std::vector<std::byte> encode(const std::vector<std::string>& materialLibraries,
+                                         const std::vector<Mesh>& meshes)
+    {
+        // 16-bit indices are used for the meshes that fit in them
+        std::vector<std::uint32_t> indexSizes;
+        indexSizes.reserve(meshes.size());
+
+        auto size = headerSize;
+        for (const auto& materialLibrary : materialLibraries)
+            size += sizeof(std::uint32_t) + materialLibrary.size();
+
+        for (const auto& mesh : meshes)
+        {
+            if (mesh.vertices.size() > std::numeric_limits<std::uint32_t>::max() ||
+                mesh.indices.size() > std::numeric_limits<std::uint32_t>::max())
+                throw std::runtime_error{"Mesh is too big"};
+
+            indexSizes.push_back(mesh.vertices.size() <= std::numeric_limits<std::uint16_t>::max() + 1U ?
+                                 sizeof(std::uint16_t) : sizeof(std::uint32_t));
+            size += 2 * sizeof(std::uint32_t) + mesh.name.size() + mesh.material.size() + meshHeaderSize;
+        }
+
+        size = alignOffset(size);
+        auto dataOffset = size;
+
+        for (std::size_t i = 0; i < meshes.size(); ++i)
+            size = alignOffset(alignOffset(size + meshes[i].indices.size() * indexSizes[i]) +
+                               meshes[i].vertices.size() * vertexSize);
+
+        std::vector<std::byte> result(size);
+        const auto buffer = reinterpret_cast<std::uint8_t*>(result.data());
+
+        std::memcpy(buffer, magic, sizeof(magic));
+        encodeLittleEndian<std::uint32_t>(buffer + 4, version);
+        encodeLittleEndian<std::uint32_t>(buffer + 8, static_cast<std::uint32_t>(materialLibraries.size()));
+        encodeLittleEndian<std::uint32_t>(buffer + 12, static_cast<std::uint32_t>(meshes.size()));
+
+        std::size_t offset = headerSize;
+
+        const auto writeString = [buffer, &offset](const std::string& s) {
+            encodeLittleEndian<std::uint32_t>(buffer + offset, static_cast<std::uint32_t>(s.size()));
+            offset += sizeof(std::uint32_t);
+            std::memcpy(buffer + offset, s.data(), s.size());
+            offset += s.size();
+        };
+
+        for (const auto& materialLibrary : materialLibraries)
+            writeString(materialLibrary);
+
+        for (std::size_t i = 0; i < meshes.size(); ++i)
+        {
+            const auto& mesh = meshes[i];
+            const auto indexSize = indexSizes[i];
+
+            writeString(mesh.name);
+            writeString(mesh.material);
+
+            const auto meshHeader = buffer + offset;
+            offset += meshHeaderSize;
+
+            for (std::size_t c = 0; c < 3; ++c)
+            {
+                encodeFloat(meshHeader + c * 4, mesh.boundingBox.min.v[c]);
+                encodeFloat(meshHeader + 12 + c * 4, mesh.boundingBox.max.v[c]);
+            }
+
+            encodeLittleEndian<std::uint32_t>(meshHeader + 24, indexSize);
+            encodeLittleEndian<std::uint32_t>(meshHeader + 28, static_cast<std::uint32_t>(mesh.indices.size()));
+            encodeLittleEndian<std::uint32_t>(meshHeader + 32, static_cast<std::uint32_t>(mesh.vertices.size()));
+
+            const auto indexOffset = dataOffset;
+            const auto vertexOffset = alignOffset(indexOffset + mesh.indices.size() * indexSize);
+            dataOffset = alignOffset(vertexOffset + mesh.vertices.size() * vertexSize);
+
+            encodeLittleEndian<std::uint64_t>(meshHeader + 36, indexOffset);
+            encodeLittleEndian<std::uint64_t>(meshHeader + 44, vertexOffset);
+
+            for (std::size_t index = 0; index < mesh.indices.size(); ++index)
+                if (indexSize == sizeof(std::uint16_t))
+                    encodeLittleEndian<std::uint16_t>(buffer + indexOffset + index * indexSize,
+                                                      static_cast<std::uint16_t>(mesh.indices[index]));
+                else
+                    encodeLittleEndian<std::uint32_t>(buffer + indexOffset + index * indexSize,
+                                                      mesh.indices[index]);
+
+            if (!mesh.vertices.empty())
+                std::memcpy(buffer + vertexOffset, mesh.vertices.data(), mesh.vertices.size() * vertexSize);
+        }
+
+        return result;
+    }
+}
+
+#endif // OUZEL_FORMATS_OMESH_HPP
@@ -0,0 +1,145 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_FORMATS_OTEXTURE_HPP
+#define OUZEL_FORMATS_OTEXTURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../graphics/PixelFormat.hpp"
+#include "../math/Size.hpp"
+#include "../utils/Utils.hpp"
+
+// Precompiled texture with all of its mip levels in the GPU pixel format
+//
+// header (little-endian):
+//   magic "OTEX", version (uint32), pixel format (uint32), level count (uint32)
+//   for every level: width (uint32), height (uint32), offset (uint64), size (uint64)
+// followed by the pixels of the levels, each aligned to 16 bytes
+namespace ouzel::otexture
+{
+    class DecodeError final: public std::logic_error
+    {
+    public:
+        using std::logic_error::logic_error;
+    };
+
+    constexpr std::uint8_t magic[4] = {'O', 'T', 'E', 'X'};
+    constexpr std::uint32_t version = 1;
+    constexpr std::size_t headerSize = 16;
+    constexpr std::size_t levelHeaderSize = 24;
+    constexpr std::size_t levelAlignment = 16;
+
+    inline bool isOtexture(const std::byte* data, std::size_t size) noexcept
+    {
+        return size >= sizeof(magic) && std::memcmp(data, magic, sizeof(magic)) == 0;
+    }
+
+    // view of a precompiled texture, the data must outlive it
+    class Data final
+    {
+    public:
+        struct Level final
+        {
+            math::Size<std::uint32_t, 2> size;
+            const std::byte* data = nullptr;
+            std::size_t dataSize = 0;
+        };
+
+        Data(const std::byte* data, std::size_t size)
+        {
+            if (!isOtexture(data, size) || size < headerSize)
+                throw DecodeError{"Not a precompiled texture"};
+
+            if (decodeLittleEndian<std::uint32_t>(data + 4) != version)
+                throw DecodeError{"Unsupported precompiled texture version"};
+
+            pixelFormat = static_cast<graphics::PixelFormat>(decodeLittleEndian<std::uint32_t>(data + 8));
+            if (pixelFormat > graphics::PixelFormat::rgba32Float)
+                throw DecodeError{"Invalid pixel format"};
+
+            const std::size_t levelCount = decodeLittleEndian<std::uint32_t>(data + 12);
+            if (levelCount == 0 || levelCount > (size - headerSize) / levelHeaderSize)
+                throw DecodeError{"Invalid level count"};
+
+            const auto pixelSize = graphics::getPixelSize(pixelFormat);
+            levels.reserve(levelCount);
+
+            for (std::size_t i = 0; i < levelCount; ++i)
+            {
+                const auto levelHeader = data + headerSize + i * levelHeaderSize;
+                const math::Size<std::uint32_t, 2> levelSize{
+                    decodeLittleEndian<std::uint32_t>(levelHeader),
+                    decodeLittleEndian<std::uint32_t>(levelHeader + 4)
+                };
+                const auto offset = decodeLittleEndian<std::uint64_t>(levelHeader + 8);
+                const auto dataSize = decodeLittleEndian<std::uint64_t>(levelHeader + 16);
+
+                if (dataSize != static_cast<std::uint64_t>(levelSize.v[0]) * levelSize.v[1] * pixelSize)
+                    throw DecodeError{"Invalid level size"};
+
+                if (offset > size || dataSize > size - offset)
+                    throw DecodeError{"Level out of bounds"};
+
+                levels.push_back(Level{levelSize, data + offset, static_cast<std::size_t>(dataSize)});
+            }
+        }
+
+        auto getPixelFormat() const noexcept { return pixelFormat; }
+        auto& getSize() const noexcept { return levels.front().size; }
+        auto& getLevels() const noexcept { return levels; }
+
+    private:
+        graphics::PixelFormat pixelFormat;
+        std::vector<Level> levels;
+    };
+
+    inline std::vector<std::byte> encode(graphics::PixelFormat pixelFormat,
+                                         const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& levels)
+    {
+        if (levels.empty())
+            throw std::runtime_error{"Texture has no levels"};
+
+        const auto alignOffset = [](std::size_t offset) noexcept {
+            return (offset + levelAlignment - 1) & ~(levelAlignment - 1);
+        };
+
+        auto size = alignOffset(headerSize + levels.size() * levelHeaderSize);
+        for (const auto& level : levels)
+            size = alignOffset(size + level.second.size());
+
+        std::vector<std::byte> result(size);
+        const auto buffer = reinterpret_cast<std::uint8_t*>(result.data());
+
+        std::memcpy(buffer, magic, sizeof(magic));
+        encodeLittleEndian<std::uint32_t>(buffer + 4, version);
+        encodeLittleEndian<std::uint32_t>(buffer + 8, static_cast<std::uint32_t>(pixelFormat));
+        encodeLittleEndian<std::uint32_t>(buffer + 12, static_cast<std::uint32_t>(levels.size()));
+
+        auto offset = alignOffset(headerSize + levels.size() * levelHeaderSize);
+
+        for (std::size_t i = 0; i < levels.size(); ++i)
+        {
+            const auto& [levelSize, levelData] = levels[i];
+
+            if (levelData.size() != static_cast<std::size_t>(levelSize.v[0]) * levelSize.v[1] * graphics::getPixelSize(pixelFormat))
+                throw std::runtime_error{"Invalid level size"};
+
+            const auto levelHeader = buffer + headerSize + i * levelHeaderSize;
+            encodeLittleEndian<std::uint32_t>(levelHeader, levelSize.v[0]);
+            encodeLittleEndian<std::uint32_t>(levelHeader + 4, levelSize.v[1]);
+            encodeLittleEndian<std::uint64_t>(levelHeader + 8, offset);
+            encodeLittleEndian<std::uint64_t>(levelHeader + 16, levelData.size());
+
+            if (!levelData.empty()) std::memcpy(buffer + offset, levelData.data(), levelData.size());
+            offset = alignOffset(offset + levelData.size());
+        }
+
+        return result;
+    }
+}
+
+#endif // OUZEL_FORMATS_OTEXTURE_HPP
@@ -3,13 +3,23 @@
 #ifndef OUZEL_FORMATS_XML_HPP
 #define OUZEL_FORMATS_XML_HPP
 
+#include <algorithm>
 #include <array>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "../utils/Span.hpp"
 #include "../utils/Utf8.hpp"
 
 namespace ouzel::xml
@@ -1235,6 +1245,747 @@ namespace ouzel::xml
 
         return Encoder::encode(data, whiteSpaces, byteOrderMark);
     }
+
+    inline namespace detail
+    {
+        [[nodiscard]] inline bool hasByteOrderMark(const char* begin, const char* end) noexcept
+        {
+            for (const auto b : utf8ByteOrderMark)
+                if (begin == end || static_cast<std::uint8_t>(*begin++) != b)
+                    return false;
+            return true;
+        }
+
+        [[nodiscard]] constexpr bool isWhiteSpace(const char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        // all the bytes of multi-byte UTF-8 sequences are accepted in names
+        [[nodiscard]] constexpr bool isNameStartChar(const char c) noexcept
+        {
+            return (c >= 'a' && c <= 'z') ||
+                (c >= 'A' && c <= 'Z') ||
+                c == ':' || c == '_' ||
+                static_cast<std::uint8_t>(c) >= 0x80;
+        }
+
+        [[nodiscard]] constexpr bool isNameChar(const char c) noexcept
+        {
+            return isNameStartChar(c) ||
+                c == '-' || c == '.' ||
+                (c >= '0' && c <= '9');
+        }
+
+        [[nodiscard]] inline const char* skipWhiteSpaces(const char* begin, const char* end) noexcept
+        {
+            while (begin != end && isWhiteSpace(*begin)) ++begin;
+            return begin;
+        }
+
+        // appends the character that the reference (without the ampersand and the semicolon) stands for
+        inline void appendReference(const std::string_view reference, std::string& result)
+        {
+            if (reference.empty())
+                throw ParseError{"Invalid entity"};
+
+            if (reference[0] == '#') // char reference
+            {
+                const auto hex = reference.length() > 1 && reference[1] == 'x';
+                const auto digits = reference.substr(hex ? 2 : 1);
+
+                if (digits.empty())
+                    throw ParseError{"Invalid entity"};
+
+                char32_t c = 0;
+
+                for (const auto digit : digits)
+                {
+                    std::uint32_t code = 0;
+
+                    if (digit >= '0' && digit <= '9')
+                        code = static_cast<std::uint32_t>(digit - '0');
+                    else if (hex && digit >= 'a' && digit <= 'f')
+                        code = static_cast<std::uint32_t>(digit - 'a' + 10);
+                    else if (hex && digit >= 'A' && digit <= 'F')
+                        code = static_cast<std::uint32_t>(digit - 'A' + 10);
+                    else
+                        throw ParseError{"Invalid character code"};
+
+                    c = c * (hex ? 16 : 10) + code;
+
+                    if (c > 0x10FFFF)
+                        throw ParseError{"Invalid character code"};
+                }
+
+                result += utf8::fromUtf32(c);
+            }
+            else if (reference == "quot")
+                result.push_back('"');
+            else if (reference == "amp")
+                result.push_back('&');
+            else if (reference == "apos")
+                result.push_back('\'');
+            else if (reference == "lt")
+                result.push_back('<');
+            else if (reference == "gt")
+                result.push_back('>');
+            else
+                throw ParseError{"Invalid entity"};
+        }
+
+        // the result is never longer than the text
+        inline void appendDecoded(const std::string_view text, std::string& result)
+        {
+            for (std::size_t position = 0;;)
+            {
+                const auto ampersand = text.find('&', position);
+                if (ampersand == std::string_view::npos)
+                {
+                    result.append(text.data() + position, text.size() - position);
+                    break;
+                }
+
+                result.append(text.data() + position, ampersand - position);
+
+                const auto semicolon = text.find(';', ampersand + 1);
+                if (semicolon == std::string_view::npos)
+                    throw ParseError{"Invalid entity"};
+
+                appendReference(text.substr(ampersand + 1, semicolon - ampersand - 1), result);
+                position = semicolon + 1;
+            }
+        }
+
+        // bump allocator for trivially destructible objects, that releases all the memory at once
+        class Arena final
+        {
+        public:
+            Arena() = default;
+
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            Arena(Arena&& other) noexcept:
+                blocks{std::move(other.blocks)},
+                position{std::exchange(other.position, nullptr)},
+                remaining{std::exchange(other.remaining, 0)},
+                nextBlockSize{other.nextBlockSize}
+            {
+            }
+
+            Arena& operator=(Arena&& other) noexcept
+            {
+                if (&other == this) return *this;
+                blocks = std::move(other.blocks);
+                position = std::exchange(other.position, nullptr);
+                remaining = std::exchange(other.remaining, 0);
+                nextBlockSize = other.nextBlockSize;
+                return *this;
+            }
+
+            [[nodiscard]] void* allocate(const std::size_t size, const std::size_t alignment)
+            {
+                auto padding = (alignment - reinterpret_cast<std::uintptr_t>(position) % alignment) % alignment;
+
+                if (padding + size > remaining)
+                {
+                    const auto blockSize = std::max(size + alignment, nextBlockSize);
+                    blocks.emplace_back(new std::byte[blockSize]);
+                    position = blocks.back().get();
+                    remaining = blockSize;
+                    nextBlockSize = std::min(nextBlockSize * 2, maxBlockSize);
+                    padding = (alignment - reinterpret_cast<std::uintptr_t>(position) % alignment) % alignment;
+                }
+
+                const auto result = position + padding;
+                position = result + size;
+                remaining -= padding + size;
+                return result;
+            }
+
+            template <class T, class ...Args>
+            [[nodiscard]] T* create(Args&&... args)
+            {
+                static_assert(std::is_trivially_destructible_v<T>, "Destructors are not called");
+                return new(allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+            }
+
+            [[nodiscard]] std::string_view copy(const std::string_view str)
+            {
+                if (str.empty()) return {};
+                const auto result = static_cast<char*>(allocate(str.size(), 1));
+                std::memcpy(result, str.data(), str.size());
+                return std::string_view{result, str.size()};
+            }
+
+        private:
+            static constexpr std::size_t maxBlockSize = 1024 * 1024;
+
+            std::vector<std::unique_ptr<std::byte[]>> blocks;
+            std::byte* position = nullptr;
+            std::size_t remaining = 0;
+            std::size_t nextBlockSize = 4096;
+        };
+    }
+
+    // pull parser, the names and the values are views of the input, except for the ones
+    // that contain references, which are decoded to an internal buffer and valid until the next event
+    class Reader final
+    {
+    public:
+        enum class Event
+        {
+            startTag,
+            endTag, // also reported for the self-closing tags
+            text,
+            characterData,
+            comment,
+            processingInstruction,
+            documentTypeDefinition, // the value is the unparsed rest of the declaration
+            end
+        };
+
+        struct Attribute final
+        {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        Reader(const char* initBegin, const char* initEnd,
+               const bool initPreserveWhiteSpaces = false) noexcept:
+            iterator{initBegin}, end{initEnd}, preserveWhiteSpaces{initPreserveWhiteSpaces}
+        {
+            if (hasByteOrderMark(iterator, end)) iterator += utf8ByteOrderMark.size();
+        }
+
+        template <class Data>
+        explicit Reader(const Data& data, const bool initPreserveWhiteSpaces = false) noexcept:
+            Reader{reinterpret_cast<const char*>(std::data(data)),
+                   reinterpret_cast<const char*>(std::data(data)) + std::size(data),
+                   initPreserveWhiteSpaces}
+        {
+            static_assert(sizeof(*std::data(data)) == 1, "Data must be a sequence of bytes");
+        }
+
+        Event next()
+        {
+            name = {};
+            value = {};
+            attributes.clear();
+
+            if (selfClosing)
+            {
+                selfClosing = false;
+                name = openTags.back();
+                openTags.pop_back();
+                return event = Event::endTag;
+            }
+
+            // the white spaces outside of the root tag are never preserved
+            if (!preserveWhiteSpaces || openTags.empty())
+                iterator = skipWhiteSpaces(iterator, end);
+
+            const auto prologAllowed = prolog;
+            prolog = false;
+
+            if (iterator == end)
+            {
+                if (!openTags.empty())
+                    throw ParseError{"Unexpected end of data"};
+
+                if (!rootTagFound)
+                    throw ParseError{"No root tag found"};
+
+                return event = Event::end;
+            }
+
+            if (*iterator != '<')
+                return event = readText();
+
+            if (++iterator == end)
+                throw ParseError{"Unexpected end of data"};
+
+            switch (*iterator)
+            {
+                case '/': return event = readEndTag();
+                case '?': return event = readProcessingInstruction(prologAllowed);
+                case '!': return event = readDeclaration();
+                default: return event = readStartTag();
+            }
+        }
+
+        // skips the rest of the current tag including its end tag
+        void skip()
+        {
+            if (event != Event::startTag) return;
+
+            const auto depth = openTags.size();
+            while (openTags.size() >= depth) next();
+        }
+
+        [[nodiscard]] Event getEvent() const noexcept { return event; }
+
+        // number of the open tags
+        [[nodiscard]] std::size_t getDepth() const noexcept { return openTags.size(); }
+
+        // name of the tag, the processing instruction or the document type
+        [[nodiscard]] std::string_view getName() const noexcept { return name; }
+
+        [[nodiscard]] std::string_view getValue() const noexcept { return value; }
+
+        [[nodiscard]] const std::vector<Attribute>& getAttributes() const noexcept { return attributes; }
+
+        [[nodiscard]] bool hasAttribute(const std::string_view attribute) const noexcept
+        {
+            for (const auto& a : attributes)
+                if (a.name == attribute) return true;
+            return false;
+        }
+
+        [[nodiscard]] std::string_view operator[](const std::string_view attribute) const
+        {
+            for (const auto& a : attributes)
+                if (a.name == attribute) return a.value;
+            throw RangeError{"Invalid attribute"};
+        }
+
+    private:
+        void expect(const char c)
+        {
+            if (iterator == end)
+                throw ParseError{"Unexpected end of data"};
+
+            if (*iterator != c)
+                throw ParseError{"Unexpected character"};
+
+            ++iterator;
+        }
+
+        // returns the data up to the terminator and skips the terminator
+        std::string_view readUntil(const std::string_view terminator)
+        {
+            const std::string_view rest{iterator, static_cast<std::size_t>(end - iterator)};
+            const auto position = rest.find(terminator);
+            if (position == std::string_view::npos)
+                throw ParseError{"Unexpected end of data"};
+
+            iterator += position + terminator.size();
+            return rest.substr(0, position);
+        }
+
+        std::string_view readName()
+        {
+            if (iterator == end)
+                throw ParseError{"Unexpected end of data"};
+
+            if (!isNameStartChar(*iterator))
+                throw ParseError{"Invalid name start"};
+
+            const auto nameBegin = iterator;
+            while (++iterator != end && isNameChar(*iterator));
+
+            return std::string_view{nameBegin, static_cast<std::size_t>(iterator - nameBegin)};
+        }
+
+        Event readStartTag()
+        {
+            if (openTags.empty())
+            {
+                if (rootTagFound)
+                    throw ParseError{"Multiple root tags found"};
+
+                rootTagFound = true;
+            }
+
+            name = readName();
+
+            std::size_t escapedSize = 0;
+
+            for (;;)
+            {
+                iterator = skipWhiteSpaces(iterator, end);
+
+                if (iterator == end)
+                    throw ParseError{"Unexpected end of data"};
+
+                if (*iterator == '>')
+                {
+                    ++iterator;
+                    break;
+                }
+                else if (*iterator == '/')
+                {
+                    ++iterator;
+                    expect('>');
+                    selfClosing = true;
+                    break;
+                }
+
+                Attribute attribute;
+                attribute.name = readName();
+
+                if (hasAttribute(attribute.name))
+                    throw ParseError{"Duplicate attribute"};
+
+                iterator = skipWhiteSpaces(iterator, end);
+                expect('=');
+                iterator = skipWhiteSpaces(iterator, end);
+
+                if (iterator == end)
+                    throw ParseError{"Unexpected end of data"};
+
+                if (*iterator != '"' && *iterator != '\'')
+                    throw ParseError{"Expected quotes"};
+
+                const char quotes[] = {*iterator++, '\0'};
+                attribute.value = readUntil(quotes);
+
+                if (attribute.value.find('&') != std::string_view::npos)
+                    escapedSize += attribute.value.size();
+
+                attributes.push_back(attribute);
+            }
+
+            if (escapedSize != 0)
+            {
+                // reserving enough space keeps the views of the buffer valid
+                buffer.clear();
+                buffer.reserve(escapedSize);
+
+                for (auto& attribute : attributes)
+                    if (attribute.value.find('&') != std::string_view::npos)
+                    {
+                        const auto start = buffer.size();
+                        appendDecoded(attribute.value, buffer);
+                        attribute.value = std::string_view{buffer.data() + start, buffer.size() - start};
+                    }
+            }
+
+            openTags.push_back(name);
+            return Event::startTag;
+        }
+
+        Event readEndTag()
+        {
+            ++iterator; // skip the slash
+
+            name = readName();
+            iterator = skipWhiteSpaces(iterator, end);
+            expect('>');
+
+            if (openTags.empty() || openTags.back() != name)
+                throw ParseError{"Tag not closed properly"};
+
+            openTags.pop_back();
+            return Event::endTag;
+        }
+
+        Event readText()
+        {
+            if (openTags.empty())
+                throw ParseError{"Text outside of the root tag"};
+
+            const auto textBegin = iterator;
+            iterator = std::find(iterator, end, '<');
+            value = std::string_view{textBegin, static_cast<std::size_t>(iterator - textBegin)};
+
+            if (value.find('&') != std::string_view::npos)
+            {
+                buffer.clear();
+                appendDecoded(value, buffer);
+                value = buffer;
+            }
+
+            return Event::text;
+        }
+
+        Event readProcessingInstruction(const bool prologAllowed)
+        {
+            ++iterator; // skip the question mark
+
+            name = readName();
+
+            if (!prologAllowed && name.length() == 3 &&
+                std::tolower(name[0]) == 'x' &&
+                std::tolower(name[1]) == 'm' &&
+                std::tolower(name[2]) == 'l')
+                throw ParseError{"Invalid processing instruction"};
+
+            iterator = skipWhiteSpaces(iterator, end);
+            value = readUntil("?>");
+            return Event::processingInstruction;
+        }
+
+        Event readDeclaration()
+        {
+            if (++iterator == end)
+                throw ParseError{"Unexpected end of data"};
+
+            if (*iterator == '-') // <!-
+            {
+                ++iterator;
+                expect('-'); // <!--
+
+                value = readUntil("--");
+                expect('>');
+                return Event::comment;
+            }
+            else if (*iterator == '[') // <![
+            {
+                ++iterator;
+
+                if (readName() != "CDATA")
+                    throw ParseError{"Expected CDATA"};
+
+                expect('[');
+
+                if (openTags.empty())
+                    throw ParseError{"Character data outside of the root tag"};
+
+                value = readUntil("]]>");
+                return Event::characterData;
+            }
+            else // <!
+            {
+                if (readName() != "DOCTYPE")
+                    throw ParseError{"Invalid document type declaration"};
+
+                if (rootTagFound)
+                    throw ParseError{"Unexpected document type declaration"};
+
+                iterator = skipWhiteSpaces(iterator, end);
+                name = readName();
+                iterator = skipWhiteSpaces(iterator, end);
+
+                // the internal subset and the quoted literals can contain right angle brackets
+                const auto valueBegin = iterator;
+                char quotes = '\0';
+                bool internalSubset = false;
+
+                for (;; ++iterator)
+                {
+                    if (iterator == end)
+                        throw ParseError{"Unexpected end of data"};
+
+                    if (quotes != '\0')
+                    {
+                        if (*iterator == quotes) quotes = '\0';
+                    }
+                    else if (*iterator == '"' || *iterator == '\'')
+                        quotes = *iterator;
+                    else if (*iterator == '[')
+                        internalSubset = true;
+                    else if (*iterator == ']')
+                        internalSubset = false;
+                    else if (*iterator == '>' && !internalSubset)
+                        break;
+                }
+
+                auto valueEnd = iterator++;
+                while (valueEnd != valueBegin && isWhiteSpace(*(valueEnd - 1))) --valueEnd;
+                value = std::string_view{valueBegin, static_cast<std::size_t>(valueEnd - valueBegin)};
+
+                return Event::documentTypeDefinition;
+            }
+        }
+
+        const char* iterator;
+        const char* end;
+        bool preserveWhiteSpaces = false;
+        bool prolog = true;
+        bool rootTagFound = false;
+        bool selfClosing = false;
+
+        Event event = Event::end;
+        std::string_view name;
+        std::string_view value;
+        std::vector<Attribute> attributes;
+        std::vector<std::string_view> openTags;
+        std::string buffer;
+    };
+
+    // read-only tree built from the Reader events, with all of the nodes and strings stored in an arena
+    class Document final
+    {
+    public:
+        using Type = xml::Node::Type;
+        using Attribute = Reader::Attribute;
+
+        struct Node;
+
+        // iterates over the node and its following siblings
+        class Iterator final
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Node;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Node*;
+            using reference = const Node&;
+
+            explicit Iterator(const Node* initNode = nullptr) noexcept: node{initNode} {}
+
+            const Node& operator*() const noexcept { return *node; }
+            const Node* operator->() const noexcept { return node; }
+
+            Iterator& operator++() noexcept
+            {
+                node = node->nextSibling;
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const noexcept { return node == other.node; }
+            bool operator!=(const Iterator& other) const noexcept { return node != other.node; }
+
+        private:
+            const Node* node;
+        };
+
+        struct Node final
+        {
+            [[nodiscard]] Iterator begin() const noexcept { return Iterator{firstChild}; }
+            [[nodiscard]] Iterator end() const noexcept { return Iterator{}; }
+
+            [[nodiscard]] bool hasAttribute(const std::string_view attribute) const noexcept
+            {
+                for (const auto& a : attributes)
+                    if (a.name == attribute) return true;
+                return false;
+            }
+
+            [[nodiscard]] std::string_view operator[](const std::string_view attribute) const
+            {
+                for (const auto& a : attributes)
+                    if (a.name == attribute) return a.value;
+                throw RangeError{"Invalid attribute"};
+            }
+
+            // first child tag with the name or nullptr
+            [[nodiscard]] const Node* findChild(const std::string_view childName) const noexcept
+            {
+                for (auto child = firstChild; child; child = child->nextSibling)
+                    if (child->type == Type::tag && child->name == childName) return child;
+                return nullptr;
+            }
+
+            Type type = Type::tag;
+            std::string_view name;
+            std::string_view value;
+            Span<const Attribute> attributes;
+            const Node* parent = nullptr;
+            const Node* firstChild = nullptr;
+            const Node* nextSibling = nullptr;
+        };
+
+        Document(const char* begin, const char* end,
+                 const bool preserveWhiteSpaces = false,
+                 const bool preserveComments = false,
+                 const bool preserveProcessingInstructions = false)
+        {
+            Reader reader{begin, end, preserveWhiteSpaces};
+
+            Node* parent = nullptr;
+            Node* previous = nullptr;
+            std::vector<Node*> previousNodes; // the previous sibling of each open tag
+
+            const auto append = [this, &parent, &previous](const Type type) -> Node& {
+                const auto node = arena.create<Node>();
+                node->type = type;
+                node->parent = parent;
+
+                if (previous) previous->nextSibling = node;
+                else if (parent) parent->firstChild = node;
+                else firstChild = node;
+
+                previous = node;
+                return *node;
+            };
+
+            for (;;)
+                switch (reader.next())
+                {
+                    case Reader::Event::startTag:
+                    {
+                        auto& node = append(Type::tag);
+                        node.name = arena.copy(reader.getName());
+
+                        if (const auto& attributes = reader.getAttributes(); !attributes.empty())
+                        {
+                            const auto result = static_cast<Attribute*>(arena.allocate(sizeof(Attribute) * attributes.size(),
+                                                                                       alignof(Attribute)));
+                            for (std::size_t i = 0; i < attributes.size(); ++i)
+                                new(result + i) Attribute{arena.copy(attributes[i].name), arena.copy(attributes[i].value)};
+
+                            node.attributes = Span<const Attribute>{result, attributes.size()};
+                        }
+
+                        if (!parent) root = &node;
+
+                        previousNodes.push_back(&node);
+                        parent = &node;
+                        previous = nullptr;
+                        break;
+                    }
+                    case Reader::Event::endTag:
+                        previous = previousNodes.back();
+                        previousNodes.pop_back();
+                        parent = const_cast<Node*>(previous->parent);
+                        break;
+                    case Reader::Event::text:
+                    case Reader::Event::characterData:
+                        append(reader.getEvent() == Reader::Event::text ? Type::text : Type::characterData).value =
+                            arena.copy(reader.getValue());
+                        break;
+                    case Reader::Event::comment:
+                        if (preserveComments)
+                            append(Type::comment).value = arena.copy(reader.getValue());
+                        break;
+                    case Reader::Event::processingInstruction:
+                        if (preserveProcessingInstructions)
+                        {
+                            auto& node = append(Type::processingInstruction);
+                            node.name = arena.copy(reader.getName());
+                            node.value = arena.copy(reader.getValue());
+                        }
+                        break;
+                    case Reader::Event::documentTypeDefinition:
+                    {
+                        auto& node = append(Type::documentTypeDefinition);
+                        node.name = arena.copy(reader.getName());
+                        node.value = arena.copy(reader.getValue());
+                        break;
+                    }
+                    case Reader::Event::end:
+                        return;
+                }
+        }
+
+        template <class Data>
+        explicit Document(const Data& data,
+                          const bool preserveWhiteSpaces = false,
+                          const bool preserveComments = false,
+                          const bool preserveProcessingInstructions = false):
+            Document{reinterpret_cast<const char*>(std::data(data)),
+                     reinterpret_cast<const char*>(std::data(data)) + std::size(data),
+                     preserveWhiteSpaces,
+                     preserveComments,
+                     preserveProcessingInstructions}
+        {
+            static_assert(sizeof(*std::data(data)) == 1, "Data must be a sequence of bytes");
+        }
+
+        // the top-level nodes
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator{firstChild}; }
+        [[nodiscard]] Iterator end() const noexcept { return Iterator{}; }
+
+        [[nodiscard]] const Node& getRoot() const noexcept { return *root; }
+
+    private:
+        Arena arena;
+        const Node* firstChild = nullptr;
+        const Node* root = nullptr;
+    };
 }
 
 #endif // OUZEL_FORMATS_XML_HPP
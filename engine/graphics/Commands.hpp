@@ -436,7 +436,7 @@ namespace ouzel::graphics
     {
     public:
         InitTextureCommand(ResourceId initTexture,
-                           const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& initLevels,
+                           std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> initLevels,
                            TextureType initTextureType,
                            Flags initFlags,
                            std::uint32_t initSampleCount,
@@ -445,7 +445,7 @@ namespace ouzel::graphics
                            std::uint32_t initMaxAnisotropy) noexcept(false):
             Command{Type::initTexture},
             texture{initTexture},
-            levels{initLevels},
+            levels{std::move(initLevels)},
             textureType{initTextureType},
             flags{initFlags},
             sampleCount{initSampleCount},
@@ -0,0 +1,368 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_GRAPHICS_MIPMAPS_HPP
+#define OUZEL_GRAPHICS_MIPMAPS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
+#include "PixelFormat.hpp"
+#include "../math/Size.hpp"
+#include "../thread/Thread.hpp"
+
+namespace ouzel::graphics
+{
+    inline namespace detail
+    {
+        inline constexpr float gamma = 2.2F;
+        inline constexpr float gammaLookup[256] = {
+            0.0F, 5.077051355e-06F, 2.33280025e-05F, 5.692175546e-05F, 0.0001071873558F, 0.0001751239615F, 0.0002615437261F, 0.0003671362065F,
+            0.0004925037501F, 0.0006381827989F, 0.0008046584553F, 0.0009923742618F, 0.001201739418F, 0.001433134428F, 0.001686915057F, 0.001963415882F,
+            0.002262953203F, 0.00258582551F, 0.002932318253F, 0.003302702913F, 0.003697239328F, 0.004116177093F, 0.00455975486F, 0.00502820313F,
+            0.00552174449F, 0.006040593144F, 0.006584956776F, 0.007155036554F, 0.007751026656F, 0.008373117074F, 0.009021490812F, 0.009696328081F,
+            0.01039780304F, 0.01112608239F, 0.01188133471F, 0.01266372018F, 0.01347339712F, 0.01431051921F, 0.01517523825F, 0.01606770046F,
+            0.01698805206F, 0.01793643273F, 0.0189129822F, 0.01991783828F, 0.02095113136F, 0.02201299369F, 0.02310355566F, 0.02422294207F,
+            0.02537127584F, 0.02654868178F, 0.02775527909F, 0.02899118513F, 0.03025651723F, 0.03155139089F, 0.03287591413F, 0.03423020616F,
+            0.03561436757F, 0.03702851385F, 0.03847274557F, 0.03994716704F, 0.04145189002F, 0.04298700765F, 0.04455262423F, 0.04614884034F,
+            0.04777575657F, 0.04943346232F, 0.05112205446F, 0.05284162983F, 0.05459228158F, 0.05637409911F, 0.05818717927F, 0.06003161147F,
+            0.06190747768F, 0.06381487101F, 0.06575388461F, 0.06772459298F, 0.06972708553F, 0.07176145166F, 0.07382776588F, 0.07592612505F,
+            0.07805658877F, 0.08021926135F, 0.08241420984F, 0.08464150876F, 0.08690125495F, 0.08919350803F, 0.0915183574F, 0.09387587011F,
+            0.09626612067F, 0.09868919849F, 0.1011451632F, 0.1036340967F, 0.1061560661F, 0.1087111533F, 0.1112994179F, 0.1139209345F,
+            0.1165757775F, 0.1192640141F, 0.1219857112F, 0.1247409433F, 0.1275297701F, 0.1303522736F, 0.1332085133F, 0.1360985488F,
+            0.1390224546F, 0.1419802904F, 0.1449721307F, 0.1479980201F, 0.151058048F, 0.1541522592F, 0.1572807282F, 0.1604435146F,
+            0.163640663F, 0.166872263F, 0.170138374F, 0.1734390259F, 0.176774323F, 0.1801442802F, 0.1835489869F, 0.1869885027F,
+            0.1904628724F, 0.1939721555F, 0.1975164264F, 0.2010957301F, 0.204710111F, 0.2083596438F, 0.2120443881F, 0.2157643884F,
+            0.2195197344F, 0.2233104259F, 0.2271365523F, 0.2309981436F, 0.234895274F, 0.2388280034F, 0.2427963763F, 0.2468004376F,
+            0.2508402467F, 0.2549158633F, 0.2590273619F, 0.2631747425F, 0.2673580945F, 0.2715774477F, 0.2758328617F, 0.2801243961F,
+            0.2844520807F, 0.288816005F, 0.2932161689F, 0.2976526618F, 0.3021255136F, 0.3066347837F, 0.311180532F, 0.3157627583F,
+            0.3203815818F, 0.3250369728F, 0.3297290504F, 0.3344578147F, 0.3392233551F, 0.3440256715F, 0.3488648534F, 0.3537409306F,
+            0.3586539328F, 0.3636039197F, 0.368590951F, 0.3736150563F, 0.3786762655F, 0.383774668F, 0.3889102638F, 0.3940831423F,
+            0.3992933333F, 0.4045408368F, 0.409825772F, 0.4151481092F, 0.4205079377F, 0.4259053171F, 0.4313402176F, 0.4368127584F,
+            0.4423229694F, 0.4478708506F, 0.4534564912F, 0.4590799212F, 0.4647411406F, 0.4704402685F, 0.4761772752F, 0.48195225F,
+            0.4877652228F, 0.4936162233F, 0.4995052814F, 0.5054324865F, 0.5113978386F, 0.5174013972F, 0.5234431624F, 0.5295232534F,
+            0.5356416106F, 0.5417983532F, 0.5479935408F, 0.5542271137F, 0.5604991913F, 0.5668097734F, 0.5731588602F, 0.5795466304F,
+            0.5859730244F, 0.5924380422F, 0.598941803F, 0.6054843068F, 0.6120656133F, 0.6186857224F, 0.6253447533F, 0.6320426464F,
+            0.6387794614F, 0.6455552578F, 0.6523700953F, 0.6592240334F, 0.6661169529F, 0.6730490923F, 0.6800203323F, 0.6870308518F,
+            0.6940805316F, 0.7011694908F, 0.7082977891F, 0.7154654264F, 0.7226724625F, 0.7299188972F, 0.7372047901F, 0.744530201F,
+            0.7518950701F, 0.7592995763F, 0.7667436004F, 0.7742273211F, 0.781750679F, 0.7893137336F, 0.7969165444F, 0.8045591116F,
+            0.8122414947F, 0.8199636936F, 0.8277258277F, 0.8355277777F, 0.8433697224F, 0.8512516618F, 0.8591735959F, 0.8671355247F,
+            0.8751375675F, 0.8831797242F, 0.8912620544F, 0.8993844986F, 0.9075471759F, 0.9157501459F, 0.9239933491F, 0.932276845F,
+            0.9406006932F, 0.9489649534F, 0.957369566F, 0.9658146501F, 0.9743002057F, 0.9828262329F, 0.9913928509F, 1.0F
+        };
+
+        // mipmaps are filtered in linear space with 16-bit fixed-point channels
+        inline constexpr auto linearLookup = []() constexpr {
+            std::array<std::uint16_t, 256> result{};
+            for (std::size_t i = 0; i < result.size(); ++i)
+                result[i] = static_cast<std::uint16_t>(gammaLookup[i] * 65535.0F + 0.5F);
+            return result;
+        }();
+
+        class GammaEncoder final
+        {
+        public:
+            GammaEncoder() noexcept
+            {
+                // the smallest linear value that rounds to each of the codes
+                for (std::size_t code = 1; code < thresholds.size(); ++code)
+                    thresholds[code] = static_cast<std::uint16_t>(std::ceil(65535.0 * std::pow((code - 0.5) / 255.0, static_cast<double>(gamma))));
+
+                // the code of the first value of every 16 value wide range
+                std::uint8_t code = 0;
+                for (std::size_t i = 0; i < codes.size(); ++i)
+                {
+                    while (code < 255 && (i << 4) >= thresholds[code + 1U]) ++code;
+                    codes[i] = code;
+                }
+            }
+
+            std::uint8_t encode(std::uint16_t value) const noexcept
+            {
+                // the ranges span several codes only at the steep bottom of the curve
+                auto code = codes[value >> 4];
+                while (code < 255 && value >= thresholds[code + 1U]) ++code;
+                return code;
+            }
+
+        private:
+            std::array<std::uint16_t, 256> thresholds{};
+            std::array<std::uint8_t, 4096> codes{};
+        };
+
+        inline const GammaEncoder gammaEncoder;
+
+        inline std::uint16_t gammaDecode(std::uint8_t value) noexcept
+        {
+            return linearLookup[value]; // std::pow(value / 255.0F, gamma) * 65535
+        }
+
+        inline std::uint8_t gammaEncode(std::uint16_t value) noexcept
+        {
+            return gammaEncoder.encode(value);
+        }
+
+        inline std::uint16_t alphaDecode(std::uint8_t value) noexcept
+        {
+            return static_cast<std::uint16_t>(value * 257U);
+        }
+
+        inline std::uint8_t alphaEncode(std::uint16_t value) noexcept
+        {
+            return static_cast<std::uint8_t>((value * 255U + 32767U) / 65535U);
+        }
+
+        inline void averageRows(const std::uint16_t* row0, const std::uint16_t* row1,
+                         std::uint16_t* result, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64) || _M_IX86_FP >= 2
+            for (; i + 8 <= count; i += 8)
+            {
+                const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+                const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm_avg_epu16(a, b));
+            }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+            for (; i + 8 <= count; i += 8)
+                vst1q_u16(result + i, vrhaddq_u16(vld1q_u16(row0 + i), vld1q_u16(row1 + i)));
+#endif
+            // same rounding as the vector instructions
+            for (; i < count; ++i)
+                result[i] = static_cast<std::uint16_t>((row0[i] + row1[i] + 1U) >> 1);
+        }
+
+        // the first level is read from the encoded image, the smaller ones from the linear previous level
+        inline std::uint16_t colorToLinear(std::uint8_t value) noexcept { return gammaDecode(value); }
+        inline std::uint16_t colorToLinear(std::uint16_t value) noexcept { return value; }
+        inline std::uint16_t alphaToLinear(std::uint8_t value) noexcept { return alphaDecode(value); }
+        inline std::uint16_t alphaToLinear(std::uint16_t value) noexcept { return value; }
+
+        template <std::uint32_t stepX, std::uint32_t stepY, typename T>
+        void downsampleRowsRgba8(std::uint32_t width,
+                                 const T* original, std::uint16_t* resized, std::uint8_t* encoded,
+                                 std::uint32_t beginRow, std::uint32_t endRow) noexcept
+        {
+            // 2^32 / pixel count, rounded up
+            constexpr std::uint64_t reciprocals[] = {0, 0x100000000U, 0x80000000U, 0x55555556U, 0x40000000U};
+            constexpr std::uint32_t count = stepX * stepY;
+            const std::uint32_t dstWidth = std::max(width >> 1, 1U);
+            const std::uint32_t pitch = width * 4;
+
+            for (std::uint32_t y = beginRow; y < endRow; ++y)
+            {
+                const auto* src = original + y * stepY * pitch;
+                auto* dst = resized + y * dstWidth * 4;
+                auto* result = encoded + y * dstWidth * 4;
+
+                for (std::uint32_t x = 0; x < dstWidth; ++x, src += stepX * 4, dst += 4, result += 4)
+                {
+                    // the color is averaged only over the pixels that are not fully transparent
+                    std::uint32_t pixels = 0;
+                    std::uint64_t r = 0;
+                    std::uint64_t g = 0;
+                    std::uint64_t b = 0;
+                    std::uint32_t a = 0;
+
+                    for (std::uint32_t sy = 0; sy < stepY; ++sy)
+                        for (std::uint32_t sx = 0; sx < stepX; ++sx)
+                        {
+                            const auto* pixel = src + sy * pitch + sx * 4;
+                            const std::uint32_t mask = pixel[3] > 0 ? 0xFFFFU : 0U;
+                            r += colorToLinear(pixel[0]) & mask;
+                            g += colorToLinear(pixel[1]) & mask;
+                            b += colorToLinear(pixel[2]) & mask;
+                            pixels += mask & 1U;
+                            a += alphaToLinear(pixel[3]);
+                        }
+
+                    const auto reciprocal = reciprocals[pixels];
+                    dst[0] = static_cast<std::uint16_t>((r * reciprocal + 0x80000000U) >> 32);
+                    dst[1] = static_cast<std::uint16_t>((g * reciprocal + 0x80000000U) >> 32);
+                    dst[2] = static_cast<std::uint16_t>((b * reciprocal + 0x80000000U) >> 32);
+                    // rounded up, so that the alpha does not drop to zero in the smaller levels
+                    dst[3] = static_cast<std::uint16_t>((a + count - 1) / count);
+
+                    result[0] = gammaEncode(dst[0]); // red
+                    result[1] = gammaEncode(dst[1]); // green
+                    result[2] = gammaEncode(dst[2]); // blue
+                    result[3] = alphaEncode(dst[3]); // alpha
+                }
+            }
+        }
+
+        // downsamples the rows [beginRow, endRow) of the next mip level and encodes them
+        template <typename T>
+        void downsampleRows(PixelFormat pixelFormat,
+                            std::uint32_t width, std::uint32_t height,
+                            const T* original, std::uint16_t* resized, std::uint8_t* encoded,
+                            std::uint32_t beginRow, std::uint32_t endRow)
+        {
+            const std::uint32_t channelCount = getChannelCount(pixelFormat);
+            const std::uint32_t dstWidth = std::max(width >> 1, 1U);
+            const std::uint32_t pitch = width * channelCount;
+            const std::uint32_t dstPitch = dstWidth * channelCount;
+            const std::uint32_t stepX = width > 1 ? 2 : 1;
+            const std::uint32_t stepY = height > 1 ? 2 : 1;
+
+            if (pixelFormat == PixelFormat::rgba8UnsignedNorm ||
+                pixelFormat == PixelFormat::rgba8UnsignedNormSRGB)
+            {
+                if (stepX > 1 && stepY > 1)
+                    downsampleRowsRgba8<2, 2>(width, original, resized, encoded, beginRow, endRow);
+                else if (stepY > 1)
+                    downsampleRowsRgba8<1, 2>(width, original, resized, encoded, beginRow, endRow);
+                else if (stepX > 1)
+                    downsampleRowsRgba8<2, 1>(width, original, resized, encoded, beginRow, endRow);
+                else
+                    downsampleRowsRgba8<1, 1>(width, original, resized, encoded, beginRow, endRow);
+            }
+            else
+            {
+                const bool alpha = (pixelFormat == PixelFormat::a8UnsignedNorm);
+                std::vector<std::uint16_t> rows(pitch * 3);
+                auto* row0 = rows.data();
+                auto* row1 = row0 + pitch;
+                auto* rowAverage = row1 + pitch;
+
+                for (std::uint32_t y = beginRow; y < endRow; ++y)
+                {
+                    const auto* src = original + y * stepY * pitch;
+                    auto* dst = resized + y * dstPitch;
+                    auto* result = encoded + y * dstPitch;
+
+                    for (std::uint32_t i = 0; i < pitch; ++i)
+                        row0[i] = alpha ? alphaToLinear(src[i]) : colorToLinear(src[i]);
+
+                    const std::uint16_t* linear = row0;
+
+                    if (stepY > 1)
+                    {
+                        for (std::uint32_t i = 0; i < pitch; ++i)
+                            row1[i] = alpha ? alphaToLinear(src[pitch + i]) : colorToLinear(src[pitch + i]);
+
+                        averageRows(row0, row1, rowAverage, pitch);
+                        linear = rowAverage;
+                    }
+
+                    if (stepX > 1)
+                    {
+                        for (std::uint32_t x = 0; x < dstWidth; ++x, linear += channelCount * 2)
+                            for (std::uint32_t channel = 0; channel < channelCount; ++channel)
+                                dst[x * channelCount + channel] = static_cast<std::uint16_t>((linear[channel] + linear[channelCount + channel] + 1U) >> 1);
+                    }
+                    else
+                        std::copy(linear, linear + dstPitch, dst);
+
+                    for (std::uint32_t i = 0; i < dstPitch; ++i)
+                        result[i] = alpha ? alphaEncode(dst[i]) : gammaEncode(dst[i]);
+                }
+            }
+        }
+
+        template <typename T>
+        void downsample(PixelFormat pixelFormat,
+                        std::uint32_t width, std::uint32_t height,
+                        const T* original,
+                        std::vector<std::uint16_t>& resized,
+                        std::vector<std::uint8_t>& encoded)
+        {
+            const std::uint32_t channelCount = getChannelCount(pixelFormat);
+            const std::uint32_t dstWidth = std::max(width >> 1, 1U);
+            const std::uint32_t dstHeight = std::max(height >> 1, 1U);
+            resized.resize(dstWidth * dstHeight * channelCount);
+            encoded.resize(dstWidth * dstHeight * channelCount);
+
+            // large levels are split into bands of rows that are filtered on separate threads,
+            // unless this already runs on a worker of the pool
+            constexpr std::uint32_t minBandPixels = 128U * 1024U;
+            const std::uint32_t cpuCount = thread::isWorkerThread() ? 1U :
+                std::max(std::thread::hardware_concurrency(), 1U);
+            const std::uint32_t bandCount = std::clamp(dstWidth * dstHeight / minBandPixels, 1U, std::min(cpuCount, dstHeight));
+            const std::uint32_t bandRows = (dstHeight + bandCount - 1) / bandCount;
+
+            std::vector<thread::Thread> threads;
+            threads.reserve(bandCount - 1);
+
+            for (std::uint32_t beginRow = bandRows; beginRow < dstHeight; beginRow += bandRows)
+                threads.emplace_back(downsampleRows<T>, pixelFormat, width, height,
+                                     original, resized.data(), encoded.data(),
+                                     beginRow, std::min(beginRow + bandRows, dstHeight));
+
+            downsampleRows(pixelFormat, width, height,
+                           original, resized.data(), encoded.data(),
+                           0, std::min(bandRows, dstHeight));
+
+            for (auto& t : threads) t.join();
+        }
+    }
+
+    // generates the mip levels of the image, can be called from any thread
+    inline std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> generateMipmaps(const math::Size<std::uint32_t, 2>& size,
+                                                                                                       const std::vector<std::uint8_t>& data,
+                                                                                                       std::uint32_t mipmaps,
+                                                                                                       PixelFormat pixelFormat)
+    {
+        switch (pixelFormat)
+        {
+            case PixelFormat::rgba8UnsignedNorm:
+            case PixelFormat::rgba8UnsignedNormSRGB:
+            case PixelFormat::rg8UnsignedNorm:
+            case PixelFormat::r8UnsignedNorm:
+            case PixelFormat::a8UnsignedNorm:
+                break;
+
+            default:
+                throw std::runtime_error{"Invalid pixel format"};
+        }
+
+        std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> levels;
+
+        std::uint32_t newWidth = size.v[0];
+        std::uint32_t newHeight = size.v[1];
+
+        levels.emplace_back(size, data);
+
+        std::uint32_t previousWidth = newWidth;
+        std::uint32_t previousHeight = newHeight;
+        std::vector<std::uint16_t> previousData;
+        std::vector<std::uint16_t> newData;
+
+        while ((newWidth > 1 || newHeight > 1) &&
+            (mipmaps == 0 || levels.size() < mipmaps))
+        {
+            newWidth >>= 1;
+            newHeight >>= 1;
+
+            if (newWidth < 1) newWidth = 1;
+            if (newHeight < 1) newHeight = 1;
+
+            const math::Size<std::uint32_t, 2> mipMapSize{newWidth, newHeight};
+
+            std::vector<std::uint8_t> encodedData;
+            if (levels.size() == 1)
+                downsample(pixelFormat, previousWidth, previousHeight, data.data(), newData, encodedData);
+            else
+                downsample(pixelFormat, previousWidth, previousHeight, previousData.data(), newData, encodedData);
+            levels.emplace_back(mipMapSize, std::move(encodedData));
+
+            std::swap(previousData, newData);
+
+            previousWidth = newWidth;
+            previousHeight = newHeight;
+        }
+
+        return levels;
+    }
+}
+
+#endif // OUZEL_GRAPHICS_MIPMAPS_HPP
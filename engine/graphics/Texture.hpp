@@ -38,7 +38,7 @@ namespace ouzel::graphics
                 std::uint32_t initMipmaps = 0,
                 PixelFormat initPixelFormat = PixelFormat::rgba8UnsignedNorm);
         Texture(Graphics& initGraphics,
-                const std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>>& initLevels,
+                std::vector<std::pair<math::Size<std::uint32_t, 2>, std::vector<std::uint8_t>>> initLevels,
                 const math::Size<std::uint32_t, 2>& initSize,
                 Flags initFlags = Flags::none,
                 PixelFormat initPixelFormat = PixelFormat::rgba8UnsignedNorm);
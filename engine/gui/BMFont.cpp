@@ -29,8 +29,8 @@ namespace ouzel::gui
             return static_cast<std::uint8_t>(c) <= 0x1F;
         }
 
-        void skipWhiteSpaces(const std::vector<std::byte>& str,
-                             std::vector<std::byte>::const_iterator& iterator) noexcept
+        void skipWhiteSpaces(Span<const std::byte> str,
+                             const std::byte*& iterator) noexcept
         {
             while (iterator != str.end())
                 if (isWhiteSpace(*iterator))
@@ -39,16 +39,16 @@ namespace ouzel::gui
                     break;
         }
 
-        void skipLine(const std::vector<std::byte>& str,
-                      std::vector<std::byte>::const_iterator& iterator) noexcept
+        void skipLine(Span<const std::byte> str,
+                      const std::byte*& iterator) noexcept
         {
             while (iterator != str.end())
                 if (isNewline(*iterator++))
                     break;
         }
 
-        std::string parseString(const std::vector<std::byte>& str,
-                                std::vector<std::byte>::const_iterator& iterator)
+        std::string parseString(Span<const std::byte> str,
+                                const std::byte*& iterator)
         {
             if (iterator == str.end())
                 throw std::runtime_error{"Invalid string"};
@@ -96,8 +96,8 @@ namespace ouzel::gui
             return result;
         }
 
-        void skipString(const std::vector<std::byte>& str,
-                        std::vector<std::byte>::const_iterator& iterator)
+        void skipString(Span<const std::byte> str,
+                        const std::byte*& iterator)
         {
             if (iterator == str.end())
                 throw std::runtime_error{"Invalid string"};
@@ -140,8 +140,8 @@ namespace ouzel::gui
             }
         }
 
-        std::string parseInt(const std::vector<std::byte>& str,
-                             std::vector<std::byte>::const_iterator& iterator)
+        std::string parseInt(Span<const std::byte> str,
+                             const std::byte*& iterator)
         {
             std::string result;
             std::uint32_t length = 1;
@@ -169,8 +169,8 @@ namespace ouzel::gui
             return result;
         }
 
-        void expectToken(const std::vector<std::byte>& str,
-                         std::vector<std::byte>::const_iterator& iterator,
+        void expectToken(Span<const std::byte> str,
+                         const std::byte*& iterator,
                          char token)
         {
             if (iterator == str.end() ||
@@ -181,7 +181,7 @@ namespace ouzel::gui
         }
     }
 
-    BMFont::BMFont(const std::vector<std::byte>& data)
+    BMFont::BMFont(Span<const std::byte> data)
     {
         auto iterator = data.cbegin();
 
@@ -331,94 +331,37 @@ namespace ouzel::gui
         }
     }
 
-    Font::RenderData BMFont::getRenderData(const std::string_view& text,
-                                           math::Color color,
-                                           float fontSize,
-                                           const math::Vector<float, 2>& anchor) const
+    bool BMFont::appendGlyphs(GlyphRun& run,
+                              std::string_view text,
+                              float fontSize) const
     {
-        math::Vector<float, 2> position{};
-
-        const auto utf32Text = utf8::toUtf32(text);
-
-        std::vector<std::uint16_t> indices;
-        std::vector<graphics::Vertex> vertices;
-        indices.reserve(utf32Text.size() * 6);
-        vertices.reserve(utf32Text.size() * 4);
-
-        std::size_t firstChar = 0;
-
-        for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
-        {
-            if (const auto iterator = chars.find(*i); iterator != chars.end())
-            {
-                const auto& f = iterator->second;
-
-                const auto startIndex = static_cast<std::uint16_t>(vertices.size());
-                indices.push_back(startIndex + 0);
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 2);
-
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 3);
-                indices.push_back(startIndex + 2);
-
-                const math::Vector<float, 2> leftTop{
-                    f.x / static_cast<float>(width),
-                    f.y / static_cast<float>(height)
-                };
-
-                const math::Vector<float, 2> rightBottom{
-                    (f.x + f.width) / static_cast<float>(width),
-                    (f.y + f.height) / static_cast<float>(height)
-                };
-
-                const std::array<math::Vector<float, 2>, 4> textCoords{
-                    math::Vector<float, 2>{leftTop.v[0], rightBottom.v[1]},
-                    math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]},
-                    math::Vector<float, 2>{leftTop.v[0], leftTop.v[1]},
-                    math::Vector<float, 2>{rightBottom.v[0], leftTop.v[1]}
-                };
-
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.xOffset, -position.v[1] - f.yOffset - f.height, 0.0F},
-                                      color, textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.xOffset + f.width, -position.v[1] - f.yOffset - f.height, 0.0F},
-                                      color, textCoords[1], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.xOffset, -position.v[1] - f.yOffset, 0.0F},
-                                      color, textCoords[2], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.xOffset + f.width, -position.v[1] - f.yOffset, 0.0F},
-                                      color, textCoords[3], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-
-                if ((i + 1) != utf32Text.end())
-                    position.v[0] += static_cast<float>(getKerningPair(*i, *(i + 1)));
-
-                position.v[0] += f.xAdvance;
-            }
-
-            if (*i == '\n' || // line feed
-                (i + 1) == utf32Text.end()) // end of string
-            {
-                const float lineWidth = position.v[0];
-                position.v[0] = 0.0F;
-                position.v[1] += lineHeight;
-
-                for (std::size_t c = firstChar; c < vertices.size(); ++c)
-                    vertices[c].position.v[0] -= lineWidth * anchor.v[0];
-
-                firstChar = vertices.size();
-            }
-        }
-
-        const auto textHeight = position.v[1];
-
-        for (auto& vertex : vertices)
-        {
-            vertex.position.v[1] += textHeight * (1.0F - anchor.v[1]);
-
-            vertex.position.v[0] *= fontSize;
-            vertex.position.v[1] *= fontSize;
-        }
-
-        return std::make_tuple(std::move(indices), std::move(vertices), fontTexture);
+        // the positions are scaled by the font size when the anchor is applied
+        if (run.isEmpty())
+            run = GlyphRun{fontTexture, static_cast<float>(lineHeight), fontSize};
+
+        run.append(text, [this](const char32_t c, GlyphRun::Glyph& glyph) {
+            const auto iterator = chars.find(c);
+            if (iterator == chars.end()) return false;
+
+            const auto& f = iterator->second;
+            glyph.offset = math::Vector<float, 2>{static_cast<float>(f.xOffset), static_cast<float>(f.yOffset)};
+            glyph.width = f.width;
+            glyph.height = f.height;
+            glyph.leftTop = math::Vector<float, 2>{
+                f.x / static_cast<float>(width),
+                f.y / static_cast<float>(height)
+            };
+            glyph.rightBottom = math::Vector<float, 2>{
+                (f.x + f.width) / static_cast<float>(width),
+                (f.y + f.height) / static_cast<float>(height)
+            };
+            glyph.advance = f.xAdvance;
+            return true;
+        }, [this](const char32_t first, const char32_t second) {
+            return static_cast<float>(getKerningPair(first, second));
+        });
+
+        return true;
     }
 
     std::int16_t BMFont::getKerningPair(char32_t first, char32_t second) const
@@ -6,6 +6,7 @@
 #include <map>
 #include <unordered_map>
 #include "Font.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::gui
 {
@@ -13,12 +14,11 @@ namespace ouzel::gui
     {
     public:
         BMFont() = default;
-        explicit BMFont(const std::vector<std::byte>& data);
+        explicit BMFont(Span<const std::byte> data);
 
-        RenderData getRenderData(const std::string_view& text,
-                                 math::Color color,
-                                 float fontSize,
-                                 const math::Vector<float, 2>& anchor) const override;
+        bool appendGlyphs(GlyphRun& run,
+                          std::string_view text,
+                          float fontSize) const override;
 
     private:
         std::int16_t getKerningPair(char32_t, char32_t) const;
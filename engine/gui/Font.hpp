@@ -3,17 +3,175 @@
 #ifndef OUZEL_GUI_FONT_HPP
 #define OUZEL_GUI_FONT_HPP
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <list>
+#include <map>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 #include "../math/Color.hpp"
 #include "../graphics/Texture.hpp"
 #include "../graphics/Vertex.hpp"
+#include "../utils/Utf8.hpp"
 
 namespace ouzel::gui
 {
+    // the glyph quads of a text without the anchor applied, more text can be appended to it
+    class GlyphRun final
+    {
+    public:
+        struct Glyph final
+        {
+            math::Vector<float, 2> offset{};
+            float width = 0.0F;
+            float height = 0.0F;
+            math::Vector<float, 2> leftTop{}; // texture coordinates
+            math::Vector<float, 2> rightBottom{};
+            float advance = 0.0F;
+        };
+
+        struct Line final
+        {
+            std::size_t firstVertex = 0;
+            float width = 0.0F;
+        };
+
+        GlyphRun() = default;
+        GlyphRun(const std::shared_ptr<graphics::Texture>& initTexture,
+                 float initLineHeight,
+                 float initScale) noexcept:
+            texture{initTexture},
+            lineHeight{initLineHeight},
+            scale{initScale}
+        {
+        }
+
+        // lays out the text after the glyphs that are already in the run
+        template <class GetGlyph, class GetKerning>
+        void append(const std::string_view text, GetGlyph getGlyph, GetKerning getKerning)
+        {
+            // the capacity grows geometrically when text is appended repeatedly
+            if (const auto size = vertices.size() + text.size() * 4; size > vertices.capacity())
+                vertices.reserve(std::max(size, vertices.capacity() * 2));
+
+            for (auto i = text.begin(); i != text.end();)
+            {
+                const auto c = utf8::decode(i, text.end());
+
+                // the kerning with the last glyph of the previously appended text
+                if (kerningGlyph != 0)
+                {
+                    position.v[0] += getKerning(kerningGlyph, c);
+                    kerningGlyph = 0;
+                }
+
+                if (Glyph glyph; getGlyph(c, glyph))
+                {
+                    addQuad(glyph);
+
+                    if (i != text.end())
+                    {
+                        auto next = i;
+                        position.v[0] += getKerning(c, utf8::decode(next, text.end()));
+                    }
+                    else
+                        kerningGlyph = c;
+
+                    position.v[0] += glyph.advance;
+                }
+
+                if (c == '\n') // line feed
+                {
+                    lines.back().width = position.v[0];
+                    lines.push_back(Line{vertices.size(), 0.0F});
+                    position.v[0] = 0.0F;
+                    position.v[1] += lineHeight;
+                    kerningGlyph = 0;
+                    lineStarted = false;
+                }
+                else
+                    lineStarted = true;
+            }
+        }
+
+        // writes the vertices of the lines starting from the first line with the anchor applied to the result,
+        // the result must have room for all of the vertices
+        void getVertices(const math::Vector<float, 2>& anchor,
+                         math::Color color,
+                         graphics::Vertex* result,
+                         const std::size_t firstLine = 0) const noexcept
+        {
+            const auto textHeight = getHeight();
+
+            for (auto line = firstLine; line < lines.size(); ++line)
+            {
+                // the last line ends at the current position
+                const auto last = line + 1 == lines.size();
+                const auto lineWidth = last ? position.v[0] : lines[line].width;
+                const auto end = last ? vertices.size() : lines[line + 1].firstVertex;
+
+                for (auto i = lines[line].firstVertex; i < end; ++i)
+                {
+                    auto& vertex = result[i];
+                    vertex = vertices[i];
+                    vertex.position.v[0] = (vertex.position.v[0] - lineWidth * anchor.v[0]) * scale;
+                    vertex.position.v[1] = (vertex.position.v[1] + textHeight * (1.0F - anchor.v[1])) * scale;
+                    vertex.color = color;
+                }
+            }
+        }
+
+        // four vertices per glyph, the indices of the quads are 0, 1, 2, 1, 3, 2
+        auto& getVertices() const noexcept { return vertices; }
+        auto getQuadCount() const noexcept { return vertices.size() / 4; }
+
+        auto& getTexture() const noexcept { return texture; }
+
+        bool isEmpty() const noexcept { return lines.size() == 1 && !lineStarted; }
+
+        // the index of the line that new glyphs are appended to
+        auto getCurrentLine() const noexcept { return lines.size() - 1; }
+
+        float getHeight() const noexcept
+        {
+            return static_cast<float>(lines.size() - (lineStarted ? 0 : 1)) * lineHeight;
+        }
+
+    private:
+        void addQuad(const Glyph& glyph)
+        {
+            const std::array<math::Vector<float, 2>, 4> textCoords{
+                math::Vector<float, 2>{glyph.leftTop.v[0], glyph.rightBottom.v[1]},
+                math::Vector<float, 2>{glyph.rightBottom.v[0], glyph.rightBottom.v[1]},
+                math::Vector<float, 2>{glyph.leftTop.v[0], glyph.leftTop.v[1]},
+                math::Vector<float, 2>{glyph.rightBottom.v[0], glyph.leftTop.v[1]}
+            };
+
+            vertices.emplace_back(math::Vector<float, 3>{position.v[0] + glyph.offset.v[0], -position.v[1] - glyph.offset.v[1] - glyph.height, 0.0F},
+                                  math::whiteColor, textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+            vertices.emplace_back(math::Vector<float, 3>{position.v[0] + glyph.offset.v[0] + glyph.width, -position.v[1] - glyph.offset.v[1] - glyph.height, 0.0F},
+                                  math::whiteColor, textCoords[1], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+            vertices.emplace_back(math::Vector<float, 3>{position.v[0] + glyph.offset.v[0], -position.v[1] - glyph.offset.v[1], 0.0F},
+                                  math::whiteColor, textCoords[2], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+            vertices.emplace_back(math::Vector<float, 3>{position.v[0] + glyph.offset.v[0] + glyph.width, -position.v[1] - glyph.offset.v[1], 0.0F},
+                                  math::whiteColor, textCoords[3], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+        }
+
+        std::vector<graphics::Vertex> vertices;
+        std::shared_ptr<graphics::Texture> texture;
+        std::vector<Line> lines{Line{}}; // the last line is the current one
+        math::Vector<float, 2> position{}; // the position of the next glyph
+        char32_t kerningGlyph = 0; // the last glyph of the text, kerned with the next appended glyph
+        bool lineStarted = false;
+        float lineHeight = 0.0F;
+        float scale = 1.0F;
+    };
+
     class Font
     {
     public:
@@ -32,10 +190,84 @@ namespace ouzel::gui
             std::vector<graphics::Vertex>,
             std::shared_ptr<graphics::Texture>>;
 
-        virtual RenderData getRenderData(const std::string_view& text,
-                                         math::Color color,
-                                         float fontSize,
-                                         const math::Vector<float, 2>& anchor) const = 0;
+        RenderData getRenderData(const std::string_view& text,
+                                 math::Color color,
+                                 float fontSize,
+                                 const math::Vector<float, 2>& anchor) const
+        {
+            GlyphRun run;
+            appendGlyphs(run, text, fontSize);
+
+            std::vector<std::uint16_t> indices;
+            indices.reserve(run.getQuadCount() * 6);
+
+            for (std::size_t i = 0; i < run.getQuadCount(); ++i)
+            {
+                const auto startIndex = static_cast<std::uint16_t>(i * 4);
+                indices.insert(indices.end(), {
+                    static_cast<std::uint16_t>(startIndex + 0),
+                    static_cast<std::uint16_t>(startIndex + 1),
+                    static_cast<std::uint16_t>(startIndex + 2),
+                    static_cast<std::uint16_t>(startIndex + 1),
+                    static_cast<std::uint16_t>(startIndex + 3),
+                    static_cast<std::uint16_t>(startIndex + 2)
+                });
+            }
+
+            std::vector<graphics::Vertex> vertices(run.getVertices().size());
+            run.getVertices(anchor, color, vertices.data());
+
+            return std::make_tuple(std::move(indices), std::move(vertices), run.getTexture());
+        }
+
+        // lays out the text after the glyphs of the run, returns false without changing the run
+        // if the text can't be appended and the whole text has to be laid out in an empty run
+        virtual bool appendGlyphs(GlyphRun& run,
+                                  std::string_view text,
+                                  float fontSize) const = 0;
+
+        // the runs are shared by all the texts with the same string and size
+        std::shared_ptr<const GlyphRun> getGlyphRun(const std::string_view text, const float fontSize) const
+        {
+            if (const auto runs = glyphRuns.find(fontSize); runs != glyphRuns.end())
+                if (const auto i = runs->second.find(text); i != runs->second.end())
+                {
+                    glyphRunList.splice(glyphRunList.begin(), glyphRunList, i->second);
+                    return i->second->run;
+                }
+
+            auto run = std::make_shared<GlyphRun>();
+            appendGlyphs(*run, text, fontSize);
+
+            glyphRunList.push_front(CachedGlyphRun{fontSize, std::string{text}, run});
+            glyphRuns[fontSize].emplace(glyphRunList.front().text, glyphRunList.begin());
+
+            // the least recently used run is forgotten, the texts that use it keep it alive
+            if (glyphRunList.size() > maxGlyphRunCount)
+            {
+                const auto& last = glyphRunList.back();
+                const auto runs = glyphRuns.find(last.fontSize);
+                runs->second.erase(last.text);
+                if (runs->second.empty()) glyphRuns.erase(runs);
+                glyphRunList.pop_back();
+            }
+
+            return run;
+        }
+
+    private:
+        static constexpr std::size_t maxGlyphRunCount = 256;
+
+        struct CachedGlyphRun final
+        {
+            float fontSize;
+            std::string text;
+            std::shared_ptr<const GlyphRun> run;
+        };
+
+        mutable std::list<CachedGlyphRun> glyphRunList; // the most recently used first
+        // the keys point to the texts in the list
+        mutable std::map<float, std::unordered_map<std::string_view, std::list<CachedGlyphRun>::iterator>> glyphRuns;
     };
 }
 
@@ -27,8 +27,35 @@
 
 namespace ouzel::gui
 {
-    TTFont::TTFont(const std::vector<std::byte>& initData, bool initMipmaps):
-        data{initData},
+    namespace
+    {
+        // the empty space after the glyphs, so that the neighbors don't bleed into them when filtered
+        constexpr std::uint16_t glyphPadding = 2U;
+
+        constexpr std::uint32_t minAtlasSize = 256U;
+        constexpr std::uint32_t maxAtlasSize = 4096U;
+
+        // the atlases of the other sizes are released when a new size is used
+        constexpr std::size_t maxAtlasCount = 8;
+
+        // white with zero alpha
+        std::vector<std::uint8_t> getEmptyPixels(const std::uint32_t size)
+        {
+            std::vector<std::uint8_t> pixels(size * size * 4);
+            for (std::size_t i = 0; i < pixels.size(); i += 4)
+            {
+                pixels[i + 0] = 255;
+                pixels[i + 1] = 255;
+                pixels[i + 2] = 255;
+                pixels[i + 3] = 0;
+            }
+
+            return pixels;
+        }
+    }
+
+    TTFont::TTFont(Span<const std::byte> initData, bool initMipmaps):
+        data{initData.begin(), initData.end()},
         mipmaps{initMipmaps}
     {
         const auto offset = stbtt_GetFontOffsetForIndex(reinterpret_cast<const unsigned char*>(data.data()), 0);
@@ -40,194 +67,282 @@ namespace ouzel::gui
 
         if (!stbtt_InitFont(font.get(), reinterpret_cast<const unsigned char*>(data.data()), offset))
             throw std::runtime_error{"Failed to load font"};
+
+        stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
     }
 
-    Font::RenderData TTFont::getRenderData(const std::string_view& text,
-                                           math::Color color,
-                                           float fontSize,
-                                           const math::Vector<float, 2>& anchor) const
+    bool TTFont::appendGlyphs(GlyphRun& run,
+                              std::string_view text,
+                              float fontSize) const
     {
         if (!font)
             throw std::runtime_error{"Font not loaded"};
 
-        constexpr std::uint32_t spacing = 2U;
+        auto& atlas = getAtlas(fontSize);
+        atlas.lastUse = ++atlasUseCount;
+        ++atlas.useCount;
 
-        const auto s = stbtt_ScaleForPixelHeight(font.get(), fontSize);
+        // all of the glyphs are added before the layout, so that the ones of the text aren't evicted
+        for (auto i = text.begin(); i != text.end();)
+            addGlyph(atlas, utf8::decode(i, text.end()));
 
-        const auto utf32Text = utf8::toUtf32(text);
+        if (!atlas.texture || atlas.invalidated)
+        {
+            // the runs that use the previous texture keep drawing with its pixels
+            atlas.texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
+                                                                atlas.pixels,
+                                                                math::Size<std::uint32_t, 2>{atlas.size, atlas.size},
+                                                                graphics::Flags::dynamic,
+                                                                mipmaps ? 0 : 1);
+        }
+        else if (atlas.dirty)
+            atlas.texture->setData(atlas.pixels);
+
+        atlas.dirty = false;
+        atlas.invalidated = false;
+
+        if (!run.isEmpty() && run.getTexture() != atlas.texture)
+            return false;
+
+        // the glyphs of the nearest whole pixel size are scaled to the font size
+        if (run.isEmpty())
+            run = GlyphRun{atlas.texture,
+                           static_cast<float>(atlas.pixelSize) + static_cast<float>(lineGap),
+                           fontSize / static_cast<float>(atlas.pixelSize)};
+
+        run.append(text, [&atlas](const char32_t c, GlyphRun::Glyph& glyph) {
+            const auto iterator = atlas.glyphs.find(c);
+            if (iterator == atlas.glyphs.end() || !iterator->second.found) return false;
+
+            const auto& f = iterator->second;
+            glyph.offset = f.offset;
+            glyph.width = f.width;
+            glyph.height = f.height;
+            glyph.leftTop = math::Vector<float, 2>{
+                f.x / static_cast<float>(atlas.size),
+                f.y / static_cast<float>(atlas.size)
+            };
+            glyph.rightBottom = math::Vector<float, 2>{
+                (f.x + f.width) / static_cast<float>(atlas.size),
+                (f.y + f.height) / static_cast<float>(atlas.size)
+            };
+            glyph.advance = f.advance;
+            return true;
+        }, [this, s = atlas.scale](const char32_t first, const char32_t second) {
+            const auto kernAdvance = stbtt_GetCodepointKernAdvance(font.get(),
+                                                                   static_cast<int>(first),
+                                                                   static_cast<int>(second));
+            return static_cast<float>(kernAdvance) * s;
+        });
+
+        return true;
+    }
 
-        std::set<char32_t> glyphs;
-        for (const auto i : utf32Text)
-            glyphs.insert(i);
+    TTFont::Atlas& TTFont::getAtlas(const float fontSize) const
+    {
+        const auto pixelSize = static_cast<std::uint32_t>(std::max(std::lround(fontSize), 1L));
+
+        if (const auto i = atlases.find(pixelSize); i != atlases.end())
+            return i->second;
+
+        // the atlases that no text draws with are released with their pixels
+        for (auto i = atlases.begin(); i != atlases.end();)
+            if (!i->second.texture || i->second.texture.use_count() == 1)
+                i = atlases.erase(i);
+            else
+                ++i;
+
+        // the texts keep drawing with the texture of a released atlas
+        if (atlases.size() >= maxAtlasCount)
+            atlases.erase(std::min_element(atlases.begin(), atlases.end(), [](const auto& a, const auto& b) noexcept {
+                return a.second.lastUse < b.second.lastUse;
+            }));
+
+        auto& atlas = atlases[pixelSize];
+        atlas.pixelSize = pixelSize;
+        atlas.scale = stbtt_ScaleForPixelHeight(font.get(), static_cast<float>(pixelSize));
+
+        // room for about 16 rows of 16 glyphs
+        std::uint32_t size = minAtlasSize;
+        while (size < pixelSize * 16U && size < maxAtlasSize) size *= 2;
+        atlas.size = static_cast<std::uint16_t>(size);
+        atlas.pixels = getEmptyPixels(size);
+
+        return atlas;
+    }
 
-        std::uint16_t width = 0;
-        std::uint16_t height = 0;
+    void TTFont::addGlyph(Atlas& atlas, const char32_t c) const
+    {
+        auto i = atlas.glyphs.find(c);
 
-        int ascent;
-        int descent;
-        int lineGap;
-        stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
+        // a glyph that didn't fit is tried again by the next text
+        if (i != atlas.glyphs.end() && i->second.dropped != 0 && i->second.dropped != atlas.useCount)
+        {
+            atlas.glyphs.erase(i);
+            i = atlas.glyphs.end();
+        }
 
-        struct CharDescriptor final
+        if (i == atlas.glyphs.end())
         {
-            std::uint16_t x = 0;
-            std::uint16_t y = 0;
-            std::uint16_t width = 0;
-            std::uint16_t height = 0;
-            math::Vector<float, 2> offset{};
-            float advance = 0;
-            std::vector<std::uint8_t> bitmap;
-        };
-
-        std::unordered_map<std::uint32_t, CharDescriptor> chars;
-
-        for (const char32_t c : glyphs)
+            Atlas::Glyph glyph;
+
             if (const auto index = stbtt_FindGlyphIndex(font.get(), static_cast<int>(c)))
             {
+                glyph.found = true;
+
                 int advance;
                 int leftBearing;
                 stbtt_GetGlyphHMetrics(font.get(), index, &advance, &leftBearing);
+                glyph.advance = static_cast<float>(advance * atlas.scale);
 
-                CharDescriptor charDesc;
                 int w;
                 int h;
                 int xoff;
                 int yoff;
+                const auto s = atlas.scale;
 
-                if (const auto bitmap = stbtt_GetGlyphBitmapSubpixel(font.get(), s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff))
-                {
-                    charDesc.width = static_cast<std::uint16_t>(w);
-                    charDesc.height = static_cast<std::uint16_t>(h);
-                    charDesc.offset.v[0] = static_cast<float>(leftBearing * s);
-                    charDesc.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
-                    charDesc.bitmap = std::vector<std::uint8_t>(bitmap, bitmap + h * w);
-                    charDesc.x = width;
-
-                    width += static_cast<std::uint16_t>(w);
-                    height = std::max(height, static_cast<std::uint16_t>(h));
+                const std::unique_ptr<unsigned char, void(*)(unsigned char*)> bitmap{
+                    stbtt_GetGlyphBitmapSubpixel(font.get(), s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff),
+                    [](unsigned char* p) noexcept { stbtt_FreeBitmap(p, nullptr); }
+                };
 
-                    stbtt_FreeBitmap(bitmap, nullptr);
+                if (bitmap)
+                {
+                    glyph.width = static_cast<std::uint16_t>(w);
+                    glyph.height = static_cast<std::uint16_t>(h);
+                    glyph.offset.v[0] = static_cast<float>(leftBearing * s);
+                    glyph.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
+
+                    // the glyph is left out of the text if the atlas is full, only its advance is kept
+                    if (!addToAtlas(atlas, glyph, bitmap.get()))
+                    {
+                        glyph.width = 0;
+                        glyph.height = 0;
+                        glyph.dropped = atlas.useCount;
+                    }
                 }
-
-                charDesc.advance = static_cast<float>(advance * s);
-
-                if (!chars.empty())
-                    width += spacing;
-
-                chars[c] = charDesc;
-            }
-
-        std::vector<std::uint8_t> textureData(width * height * 4);
-
-        for (std::uint16_t posX = 0; posX < width; ++posX)
-            for (std::uint16_t posY = 0; posY < height; ++posY)
-            {
-                textureData[(posY * width + posX) * 4 + 0] = 255;
-                textureData[(posY * width + posX) * 4 + 1] = 255;
-                textureData[(posY * width + posX) * 4 + 2] = 255;
-                textureData[(posY * width + posX) * 4 + 3] = 0;
             }
 
-        for (const auto& c : chars)
-        {
-            const auto& charDesc = c.second;
-
-            for (std::uint16_t posX = 0; posX < charDesc.width; ++posX)
-                for (std::uint16_t posY = 0; posY < charDesc.height; ++posY)
-                {
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 0] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 1] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 2] = 255;
-                    textureData[(posY * width + posX + charDesc.x) * 4 + 3] = charDesc.bitmap[posY * charDesc.width + posX];
-                }
+            i = atlas.glyphs.emplace(c, glyph).first;
         }
 
-        auto texture = std::make_shared<graphics::Texture>(engine->getGraphics(),
-                                                           textureData,
-                                                           math::Size<std::uint32_t, 2>{width, height},
-                                                           graphics::Flags::none,
-                                                           mipmaps ? 0 : 1);
+        if (i->second.width > 0 && i->second.height > 0)
+            atlas.shelves[i->second.shelf].lastUse = atlas.useCount;
+    }
 
-        math::Vector<float, 2> position{};
+    bool TTFont::addToAtlas(Atlas& atlas, Atlas::Glyph& glyph, const std::uint8_t* bitmap) const
+    {
+        const auto width = static_cast<std::uint16_t>(glyph.width + glyphPadding);
+        const auto height = static_cast<std::uint16_t>(glyph.height + glyphPadding);
 
-        std::vector<std::uint16_t> indices;
-        std::vector<graphics::Vertex> vertices;
-        indices.reserve(utf32Text.size() * 6);
-        vertices.reserve(utf32Text.size() * 4);
+        while (width > atlas.size || height > atlas.size)
+            if (!growAtlas(atlas)) return false;
 
-        std::size_t firstChar = 0;
+        // the lowest shelf that has room for the glyph
+        Atlas::Shelf* result = nullptr;
+        for (auto& shelf : atlas.shelves)
+            if (shelf.height >= height && shelf.width + width <= atlas.size &&
+                (!result || shelf.height < result->height))
+                result = &shelf;
 
-        for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
+        if (!result)
         {
-            if (auto iterator = chars.find(*i); iterator != chars.end())
-            {
-                const auto& f = iterator->second;
+            const auto top = atlas.shelves.empty() ? 0 : atlas.shelves.back().y + atlas.shelves.back().height;
 
-                const auto startIndex = static_cast<std::uint16_t>(vertices.size());
-                indices.push_back(startIndex + 0);
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 2);
-
-                indices.push_back(startIndex + 1);
-                indices.push_back(startIndex + 3);
-                indices.push_back(startIndex + 2);
-
-                const math::Vector<float, 2> leftTop{
-                    f.x / static_cast<float>(width),
-                    f.y / static_cast<float>(height)
-                };
-
-                const math::Vector<float, 2> rightBottom{
-                    (f.x + f.width) / static_cast<float>(width),
-                    (f.y + f.height) / static_cast<float>(height)
-                };
-
-                const std::array<math::Vector<float, 2>, 4> textCoords{
-                    math::Vector<float, 2>{leftTop.v[0], rightBottom.v[1]},
-                    math::Vector<float, 2>{rightBottom.v[0], rightBottom.v[1]},
-                    math::Vector<float, 2>{leftTop.v[0], leftTop.v[1]},
-                    math::Vector<float, 2>{rightBottom.v[0], leftTop.v[1]}
-                };
-
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1] - f.height, 0.0F},
-                                      color, textCoords[0], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1] - f.height, 0.0F},
-                                      color, textCoords[1], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0], -position.v[1] - f.offset.v[1], 0.0F},
-                                      color, textCoords[2], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
-                vertices.emplace_back(math::Vector<float, 3>{position.v[0] + f.offset.v[0] + f.width, -position.v[1] - f.offset.v[1], 0.0F},
-                                      color, textCoords[3], math::Vector<float, 3>{0.0F, 0.0F, -1.0F});
+            if (top + height <= atlas.size)
+                result = &atlas.shelves.emplace_back(Atlas::Shelf{static_cast<std::uint16_t>(top), height, 0, 0});
+            else
+            {
+                // the least recently used adjacent shelves that are tall enough are merged and cleared,
+                // the shelves used by the current text are kept
+                std::size_t first = 0;
+                std::size_t count = 0;
+                std::uint64_t firstLastUse = 0;
 
-                if ((i + 1) != utf32Text.end())
+                for (std::size_t start = 0; start < atlas.shelves.size(); ++start)
                 {
-                    const auto kernAdvance = stbtt_GetCodepointKernAdvance(font.get(),
-                                                                           static_cast<int>(*i),
-                                                                           static_cast<int>(*(i + 1)));
-                    position.v[0] += static_cast<float>(kernAdvance) * s;
+                    std::uint32_t mergedHeight = 0;
+                    std::uint64_t lastUse = 0;
+
+                    for (auto end = start; end < atlas.shelves.size() && atlas.shelves[end].lastUse < atlas.useCount; ++end)
+                    {
+                        mergedHeight += atlas.shelves[end].height;
+                        lastUse = std::max(lastUse, atlas.shelves[end].lastUse);
+
+                        // the free space above the last shelf is added to it
+                        const auto available = end + 1 == atlas.shelves.size() ? atlas.size - atlas.shelves[start].y : mergedHeight;
+
+                        if (available >= height)
+                        {
+                            if (count == 0 || lastUse < firstLastUse)
+                            {
+                                first = start;
+                                count = end - start + 1;
+                                firstLastUse = lastUse;
+                            }
+                            break;
+                        }
+                    }
                 }
 
-                position.v[0] += f.advance;
-            }
-
-            if (*i == static_cast<std::uint32_t>('\n') || // line feed
-                (i + 1) == utf32Text.end()) // end of string
-            {
-                const auto lineWidth = position.v[0];
-                position.v[0] = 0.0F;
-                position.v[1] += fontSize + lineGap;
-
-                for (std::size_t c = firstChar; c < vertices.size(); ++c)
-                    vertices[c].position.v[0] -= lineWidth * anchor.v[0];
-
-                firstChar = vertices.size();
+                // the atlas grows if the current text uses all of its shelves
+                if (count == 0)
+                    return growAtlas(atlas) && addToAtlas(atlas, glyph, bitmap);
+
+                for (auto i = atlas.glyphs.begin(); i != atlas.glyphs.end();)
+                    if (i->second.width > 0 && i->second.height > 0 && i->second.shelf >= first)
+                    {
+                        if (i->second.shelf < first + count)
+                            i = atlas.glyphs.erase(i);
+                        else
+                            (i++)->second.shelf -= count - 1;
+                    }
+                    else
+                        ++i;
+
+                const auto& last = atlas.shelves[first + count - 1];
+                atlas.shelves[first].height = std::max(height, static_cast<std::uint16_t>(last.y + last.height - atlas.shelves[first].y));
+                atlas.shelves.erase(atlas.shelves.begin() + static_cast<std::ptrdiff_t>(first + 1),
+                                    atlas.shelves.begin() + static_cast<std::ptrdiff_t>(first + count));
+                result = &atlas.shelves[first];
+
+                for (std::size_t y = result->y; y < result->y + result->height; ++y)
+                    for (std::size_t x = 0; x < atlas.size; ++x)
+                        atlas.pixels[(y * atlas.size + x) * 4 + 3] = 0;
+
+                result->width = 0;
+                atlas.invalidated = true;
             }
         }
 
-        const auto textHeight = position.v[1];
+        glyph.shelf = static_cast<std::size_t>(result - atlas.shelves.data());
+        glyph.x = result->width;
+        glyph.y = result->y;
+        result->width += width;
 
-        for (auto& vertex : vertices)
-            vertex.position.v[1] += textHeight * (1.0F - anchor.v[1]);
+        for (std::size_t y = 0; y < glyph.height; ++y)
+            for (std::size_t x = 0; x < glyph.width; ++x)
+                atlas.pixels[((glyph.y + y) * atlas.size + glyph.x + x) * 4 + 3] = bitmap[y * glyph.width + x];
 
-        return std::make_tuple(std::move(indices), std::move(vertices), std::move(texture));
+        atlas.dirty = true;
+        return true;
+    }
+
+    bool TTFont::growAtlas(Atlas& atlas)
+    {
+        if (atlas.size >= maxAtlasSize) return false;
+
+        // the glyphs keep their positions, so only the texture coordinates change
+        const std::uint32_t size = atlas.size * 2U;
+        auto pixels = getEmptyPixels(size);
+        for (std::size_t y = 0; y < atlas.size; ++y)
+            std::copy_n(atlas.pixels.begin() + static_cast<std::ptrdiff_t>(y * atlas.size * 4),
+                        atlas.size * 4,
+                        pixels.begin() + static_cast<std::ptrdiff_t>(y * size * 4));
+
+        atlas.pixels = std::move(pixels);
+        atlas.size = static_cast<std::uint16_t>(size);
+        atlas.invalidated = true;
+        return true;
     }
 }
@@ -3,7 +3,10 @@
 #ifndef OUZEL_GUI_TTFONT_HPP
 #define OUZEL_GUI_TTFONT_HPP
 
+#include <map>
+#include <unordered_map>
 #include "../gui/Font.hpp"
+#include "../utils/Span.hpp"
 
 struct stbtt_fontinfo;
 
@@ -13,17 +16,66 @@ namespace ouzel::gui
     {
     public:
         TTFont() = default;
-        TTFont(const std::vector<std::byte>& newData, bool newMipmaps = true);
+        TTFont(Span<const std::byte> initData, bool initMipmaps = true);
 
-        RenderData getRenderData(const std::string_view& text,
-                                 math::Color color,
-                                 float fontSize,
-                                 const math::Vector<float, 2>& anchor) const override;
+        // nothing can be appended to a run after glyphs were evicted from its texture
+        bool appendGlyphs(GlyphRun& run,
+                          std::string_view text,
+                          float fontSize) const override;
 
     private:
+        // the glyphs of a font size, rasterized on their first use
+        struct Atlas final
+        {
+            struct Glyph final
+            {
+                std::uint16_t x = 0;
+                std::uint16_t y = 0;
+                std::uint16_t width = 0;
+                std::uint16_t height = 0;
+                math::Vector<float, 2> offset{};
+                float advance = 0.0F;
+                std::size_t shelf = 0;
+                bool found = false; // false if the font doesn't have the glyph
+                std::uint64_t dropped = 0; // the use when the glyph didn't fit in the atlas, it is added again later
+            };
+
+            // a row of glyphs with the same height, evicted as a whole
+            struct Shelf final
+            {
+                std::uint16_t y = 0;
+                std::uint16_t height = 0;
+                std::uint16_t width = 0;
+                std::uint64_t lastUse = 0;
+            };
+
+            float scale = 1.0F;
+            std::uint32_t pixelSize = 0; // the glyphs are rasterized at whole pixel sizes
+            std::uint16_t size = 0;
+            std::vector<std::uint8_t> pixels;
+            std::shared_ptr<graphics::Texture> texture;
+            std::unordered_map<char32_t, Glyph> glyphs;
+            std::vector<Shelf> shelves;
+            std::uint64_t useCount = 0;
+            std::uint64_t lastUse = 0; // of the atlases of the font
+            bool dirty = false; // glyphs were added since the last upload
+            bool invalidated = false; // glyphs were evicted or the atlas grew since the last upload
+        };
+
+        Atlas& getAtlas(float fontSize) const;
+        void addGlyph(Atlas& atlas, char32_t c) const;
+        bool addToAtlas(Atlas& atlas, Atlas::Glyph& glyph, const std::uint8_t* bitmap) const;
+        static bool growAtlas(Atlas& atlas);
+
         std::unique_ptr<stbtt_fontinfo> font;
         std::vector<std::byte> data;
         bool mipmaps = true;
+
+        int ascent = 0;
+        int descent = 0;
+        int lineGap = 0;
+        mutable std::map<std::uint32_t, Atlas> atlases; // by the pixel size
+        mutable std::uint64_t atlasUseCount = 0;
     };
 }
 
@@ -42,12 +42,12 @@ namespace ouzel::input
                         auto controller = std::make_unique<Gamepad>(*this, event.deviceId);
                         controllers.push_back(controller.get());
 
-                        auto connectEvent = std::make_unique<GamepadEvent>();
-                        connectEvent->type = Event::Type::gamepadConnect;
-                        connectEvent->gamepad = controller.get();
+                        GamepadEvent connectEvent;
+                        connectEvent.type = Event::Type::gamepadConnect;
+                        connectEvent.gamepad = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     case Controller::Type::keyboard:
                     {
@@ -55,12 +55,12 @@ namespace ouzel::input
                         controllers.push_back(controller.get());
                         if (!keyboard) keyboard = controller.get();
 
-                        auto connectEvent = std::make_unique<KeyboardEvent>();
-                        connectEvent->type = Event::Type::keyboardConnect;
-                        connectEvent->keyboard = controller.get();
+                        KeyboardEvent connectEvent;
+                        connectEvent.type = Event::Type::keyboardConnect;
+                        connectEvent.keyboard = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     case Controller::Type::mouse:
                     {
@@ -68,12 +68,12 @@ namespace ouzel::input
                         controllers.push_back(controller.get());
                         if (!mouse) mouse = controller.get();
 
-                        auto connectEvent = std::make_unique<MouseEvent>();
-                        connectEvent->type = Event::Type::mouseConnect;
-                        connectEvent->mouse = controller.get();
+                        MouseEvent connectEvent;
+                        connectEvent.type = Event::Type::mouseConnect;
+                        connectEvent.mouse = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     case Controller::Type::touchpad:
                     {
@@ -81,12 +81,12 @@ namespace ouzel::input
                         controllers.push_back(controller.get());
                         if (!touchpad) touchpad = controller.get();
 
-                        auto connectEvent = std::make_unique<TouchEvent>();
-                        connectEvent->type = Event::Type::touchpadConnect;
-                        connectEvent->touchpad = controller.get();
+                        TouchEvent connectEvent;
+                        connectEvent.type = Event::Type::touchpadConnect;
+                        connectEvent.touchpad = controller.get();
 
                         controllerMap.insert(std::make_pair(event.deviceId, std::move(controller)));
-                        return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
+                        return engine->getEventDispatcher().dispatchEvent(connectEvent);
                     }
                     default: throw std::runtime_error{"Invalid controller type"};
                 }
@@ -108,16 +108,16 @@ namespace ouzel::input
                     {
                         case Controller::Type::gamepad:
                         {
-                            auto disconnectEvent = std::make_unique<GamepadEvent>();
-                            disconnectEvent->type = Event::Type::gamepadDisconnect;
-                            disconnectEvent->gamepad = static_cast<Gamepad*>(controller.get());
-                            return engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            GamepadEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::gamepadDisconnect;
+                            disconnectEvent.gamepad = static_cast<Gamepad*>(controller.get());
+                            return engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                         }
                         case Controller::Type::keyboard:
                         {
-                            auto disconnectEvent = std::make_unique<KeyboardEvent>();
-                            disconnectEvent->type = Event::Type::keyboardDisconnect;
-                            disconnectEvent->keyboard = static_cast<Keyboard*>(controller.get());
+                            KeyboardEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::keyboardDisconnect;
+                            disconnectEvent.keyboard = static_cast<Keyboard*>(controller.get());
 
                             if (controller.get() == keyboard)
                             {
@@ -127,13 +127,13 @@ namespace ouzel::input
                                         keyboard = static_cast<Keyboard*>(c);
                             }
 
-                            return engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            return engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                         }
                         case Controller::Type::mouse:
                         {
-                            auto disconnectEvent = std::make_unique<MouseEvent>();
-                            disconnectEvent->type = Event::Type::mouseDisconnect;
-                            disconnectEvent->mouse = static_cast<Mouse*>(controller.get());
+                            MouseEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::mouseDisconnect;
+                            disconnectEvent.mouse = static_cast<Mouse*>(controller.get());
 
                             if (controller.get() == mouse)
                             {
@@ -143,13 +143,13 @@ namespace ouzel::input
                                         mouse = static_cast<Mouse*>(c);
                             }
 
-                            return engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            return engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                         }
                         case Controller::Type::touchpad:
                         {
-                            auto disconnectEvent = std::make_unique<TouchEvent>();
-                            disconnectEvent->type = Event::Type::touchpadDisconnect;
-                            disconnectEvent->touchpad = static_cast<Touchpad*>(controller.get());
+                            TouchEvent disconnectEvent;
+                            disconnectEvent.type = Event::Type::touchpadDisconnect;
+                            disconnectEvent.touchpad = static_cast<Touchpad*>(controller.get());
 
                             if (controller.get() == touchpad)
                             {
@@ -159,7 +159,7 @@ namespace ouzel::input
                                         touchpad = static_cast<Touchpad*>(c);
                             }
 
-                            return engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
+                            return engine->getEventDispatcher().dispatchEvent(disconnectEvent);
                         }
                         default: throw std::runtime_error{"Invalid controller type"};
                     }
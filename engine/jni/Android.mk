@@ -16,9 +16,12 @@ LOCAL_C_INCLUDES += $(LOCAL_PATH)/.. \
 
 LOCAL_SRC_FILES := ../assets/Bundle.cpp \
     ../assets/Cache.cpp \
+    ../assets/GltfLoader.cpp \
     ../assets/ImageLoader.cpp \
     ../assets/MtlLoader.cpp \
     ../assets/ObjLoader.cpp \
+    ../assets/StaticMeshLoader.cpp \
+    ../assets/TextureLoader.cpp \
     ../assets/WaveLoader.cpp \
     ../audio/mixer/Bus.cpp \
     ../audio/mixer/Mixer.cpp \
@@ -38,6 +41,7 @@ LOCAL_SRC_FILES := ../assets/Bundle.cpp \
     ../audio/Sound.cpp \
     ../audio/Submix.cpp \
     ../audio/Voice.cpp \
+    ../audio/VoiceManager.cpp \
     ../audio/VorbisClip.cpp \
     ../core/android/EngineAndroid.cpp \
     ../core/android/NativeWindowAndroid.cpp \
@@ -36,26 +36,26 @@ namespace ouzel
         }
     }
 
-    Language::Language(const std::vector<std::byte>& data)
+    Language::Language(const std::vector<std::byte>& initData)
     {
-        if (data.size() < 5U * sizeof(std::uint32_t))
+        if (initData.size() < 5U * sizeof(std::uint32_t))
             throw std::runtime_error{"Not enough data"};
 
-        const auto magic = static_cast<std::uint32_t>(data[0]) |
-            (static_cast<std::uint32_t>(data[1]) << 8) |
-            (static_cast<std::uint32_t>(data[2]) << 16) |
-            (static_cast<std::uint32_t>(data[3]) << 24);
+        const auto magic = static_cast<std::uint32_t>(initData[0]) |
+            (static_cast<std::uint32_t>(initData[1]) << 8) |
+            (static_cast<std::uint32_t>(initData[2]) << 16) |
+            (static_cast<std::uint32_t>(initData[3]) << 24);
 
         const auto decodeUInt32 = getDecodeFunction(magic);
 
         const std::size_t revisionOffset = sizeof(magic);
-        const std::uint32_t revision = decodeUInt32(data.data() + revisionOffset);
+        const std::uint32_t revision = decodeUInt32(initData.data() + revisionOffset);
 
         if (revision != 0)
             throw std::runtime_error{"Unsupported revision " + std::to_string(revision)};
 
         const std::size_t stringCountOffset = revisionOffset + sizeof(revision);
-        const std::uint32_t stringCount = decodeUInt32(data.data() + stringCountOffset);
+        const std::uint32_t stringCount = decodeUInt32(initData.data() + stringCountOffset);
 
         struct TranslationInfo final
         {
@@ -68,76 +68,133 @@ namespace ouzel
         std::vector<TranslationInfo> translations(stringCount);
 
         const std::size_t stringsOffsetOffset = stringCountOffset + sizeof(stringCount);
-        const std::uint32_t stringsOffset = decodeUInt32(data.data() + stringsOffsetOffset);
+        const std::uint32_t stringsOffset = decodeUInt32(initData.data() + stringsOffsetOffset);
 
         const std::size_t translationsOffsetOffset = stringsOffsetOffset + sizeof(stringsOffset);
-        const std::uint32_t translationsOffset = decodeUInt32(data.data() + translationsOffsetOffset);
+        const std::uint32_t translationsOffset = decodeUInt32(initData.data() + translationsOffsetOffset);
 
-        if (data.size() < stringsOffset + 2 * sizeof(std::uint32_t) * stringCount)
+        if (initData.size() < stringsOffset + 2 * sizeof(std::uint32_t) * stringCount)
             throw std::runtime_error{"Not enough data"};
 
+        // the table is at most half full
+        std::size_t tableSize = 1;
+        while (tableSize < 2 * static_cast<std::size_t>(stringCount)) tableSize *= 2;
+        table.resize(tableSize);
+        entries.reserve(stringCount);
+
+        // the entry of a duplicate string is replaced
+        const auto addEntry = [this, &initData](const Entry& entry) {
+            const auto getString = [&initData](std::uint32_t offset, std::uint32_t length) noexcept {
+                return std::string_view{reinterpret_cast<const char*>(initData.data() + offset), length};
+            };
+
+            const auto mask = table.size() - 1;
+            auto slot = static_cast<std::size_t>(entry.hash) & mask;
+            for (; table[slot] != 0; slot = (slot + 1) & mask)
+            {
+                auto& other = entries[table[slot] - 1];
+                if (other.hash == entry.hash &&
+                    getString(other.stringOffset, other.stringLength) == getString(entry.stringOffset, entry.stringLength))
+                {
+                    other = entry;
+                    return;
+                }
+            }
+
+            entries.push_back(entry);
+            table[slot] = static_cast<std::uint32_t>(entries.size());
+        };
+
         std::size_t stringOffset = stringsOffset;
         for (std::uint32_t i = 0; i < stringCount; ++i)
         {
-            translations[i].stringLength = decodeUInt32(data.data() + stringOffset);
+            translations[i].stringLength = decodeUInt32(initData.data() + stringOffset);
             stringOffset += sizeof(translations[i].stringLength);
 
-            translations[i].stringOffset = decodeUInt32(data.data() + stringOffset);
+            translations[i].stringOffset = decodeUInt32(initData.data() + stringOffset);
             stringOffset += sizeof(translations[i].stringOffset);
         }
 
-        if (data.size() < translationsOffset + 2 * sizeof(std::uint32_t) * stringCount)
+        if (initData.size() < translationsOffset + 2 * sizeof(std::uint32_t) * stringCount)
             throw std::runtime_error{"Not enough data"};
 
         std::size_t translationOffset = translationsOffset;
         for (std::uint32_t i = 0; i < stringCount; ++i)
         {
-            translations[i].translationLength = decodeUInt32(data.data() + translationOffset);
+            translations[i].translationLength = decodeUInt32(initData.data() + translationOffset);
             translationOffset += sizeof(translations[i].translationLength);
 
-            translations[i].translationOffset = decodeUInt32(data.data() + translationOffset);
+            translations[i].translationOffset = decodeUInt32(initData.data() + translationOffset);
             translationOffset += sizeof(translations[i].translationOffset);
 
-            if (data.size() < translations[i].stringOffset + translations[i].stringLength ||
-                data.size() < translations[i].translationOffset + translations[i].translationLength)
+            // the sums are computed in std::size_t, so that they do not wrap around
+            if (initData.size() < static_cast<std::size_t>(translations[i].stringOffset) + translations[i].stringLength ||
+                initData.size() < static_cast<std::size_t>(translations[i].translationOffset) + translations[i].translationLength)
                 throw std::runtime_error{"Not enough data"};
 
-            const std::string str{
-                reinterpret_cast<const char*>(data.data() + translations[i].stringOffset),
-                translations[i].stringLength
-            };
-            const std::string_view translation{
-                reinterpret_cast<const char*>(data.data() + translations[i].translationOffset),
+            addEntry(Entry{
+                hash::fnv1::hashString<std::uint64_t>(std::string_view{
+                    reinterpret_cast<const char*>(initData.data() + translations[i].stringOffset),
+                    translations[i].stringLength
+                }),
+                translations[i].stringOffset,
+                translations[i].stringLength,
+                translations[i].translationOffset,
                 translations[i].translationLength
-            };
+            });
+        }
+
+        data.assign(reinterpret_cast<const char*>(initData.data()),
+                    reinterpret_cast<const char*>(initData.data()) + initData.size());
+    }
 
-            strings[str] = translation;
+    const Language::Entry* Language::find(const LocalizationKey& key) const noexcept
+    {
+        if (table.empty()) return nullptr;
+
+        const auto mask = table.size() - 1;
+        for (auto slot = static_cast<std::size_t>(key.getHash()) & mask; table[slot] != 0; slot = (slot + 1) & mask)
+        {
+            const auto& entry = entries[table[slot] - 1];
+            if (entry.hash == key.getHash() &&
+                std::string_view{data.data() + entry.stringOffset, entry.stringLength} == key.getString())
+                return &entry;
         }
+
+        return nullptr;
     }
 
-    std::string Language::getString(const std::string& str) const
+    std::string_view Language::getString(const LocalizationKey& key) const noexcept
     {
-        if (const auto i = strings.find(str); i != strings.end())
-            return i->second;
+        if (const auto entry = find(key))
+            return std::string_view{data.data() + entry->translationOffset, entry->translationLength};
         else
-            return str;
+            return key.getString();
     }
 
     void Localization::addLanguage(const std::string& name,
                                    const std::vector<std::byte>& data)
     {
+        auto language = std::make_unique<Language>(data);
+
         if (const auto i = languages.find(name); i != languages.end())
-            i->second = Language{data};
+        {
+            // the reloaded language stays current
+            if (currentLanguage.load() == i->second.get())
+                currentLanguage = language.get();
+
+            i->second = std::move(language);
+        }
         else
-            languages.insert(std::pair{name, Language(data)});
+            languages.emplace(name, std::move(language));
     }
 
     void Localization::removeLanguage(const std::string& name)
     {
         if (const auto i = languages.find(name); i != languages.end())
         {
-            if (currentLanguage == i)
-                currentLanguage = languages.end();
+            if (currentLanguage.load() == i->second.get())
+                currentLanguage = nullptr;
 
             languages.erase(i);
         }
@@ -146,16 +203,8 @@ namespace ouzel
     void Localization::setLanguage(const std::string& name)
     {
         if (const auto i = languages.find(name); i != languages.end())
-            currentLanguage = i;
-        else
-            currentLanguage = languages.end();
-    }
-
-    std::string Localization::getString(const std::string& str) const
-    {
-        if (currentLanguage != languages.end())
-            return currentLanguage->second.getString(str);
+            currentLanguage = i->second.get();
         else
-            return str;
+            currentLanguage = nullptr;
     }
 }
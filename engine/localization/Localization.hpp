@@ -3,37 +3,95 @@
 #ifndef OUZEL_LOCALIZATION_LOCALIZATION_HPP
 #define OUZEL_LOCALIZATION_LOCALIZATION_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "../hash/Fnv1.hpp"
 
 namespace ouzel
 {
+    // the string to translate with its hash, constexpr keys are hashed at compile time
+    class LocalizationKey final
+    {
+    public:
+        constexpr LocalizationKey(const char* initStr) noexcept:
+            LocalizationKey{std::string_view{initStr}}
+        {
+        }
+
+        constexpr LocalizationKey(const std::string_view initStr) noexcept:
+            str{initStr}, hash{hash::fnv1::hashString<std::uint64_t>(initStr)}
+        {
+        }
+
+        // the key refers to the string, so it must outlive the key and the returned fallback
+        explicit LocalizationKey(const std::string& initStr) noexcept:
+            LocalizationKey{std::string_view{initStr}}
+        {
+        }
+
+        LocalizationKey(std::string&&) = delete;
+
+        [[nodiscard]] constexpr auto getString() const noexcept { return str; }
+        [[nodiscard]] constexpr auto getHash() const noexcept { return hash; }
+
+    private:
+        std::string_view str;
+        std::uint64_t hash;
+    };
+
     class Language final
     {
     public:
         Language() = default;
-        explicit Language(const std::vector<std::byte>& data);
+        explicit Language(const std::vector<std::byte>& initData);
 
-        std::string getString(const std::string& str) const;
+        // returns the key if there is no translation for it
+        [[nodiscard]] std::string_view getString(const LocalizationKey& key) const noexcept;
 
     private:
-        std::map<std::string, std::string> strings;
+        struct Entry final
+        {
+            std::uint64_t hash = 0;
+            std::uint32_t stringOffset = 0;
+            std::uint32_t stringLength = 0;
+            std::uint32_t translationOffset = 0;
+            std::uint32_t translationLength = 0;
+        };
+
+        const Entry* find(const LocalizationKey& key) const noexcept;
+
+        std::vector<char> data; // the strings point into the loaded file
+        std::vector<Entry> entries;
+        std::vector<std::uint32_t> table; // open addressing, entry index + 1 or 0 for an empty slot
     };
 
+    // the returned strings are valid until the language is replaced or removed,
+    // languages must not be added or removed while other threads get strings
     class Localization final
     {
     public:
+        // replaces the language if it is already added, without copying the other tables
         void addLanguage(const std::string& name,
                          const std::vector<std::byte>& data);
         void removeLanguage(const std::string& name);
+
+        // switches the current language atomically
         void setLanguage(const std::string& name);
-        std::string getString(const std::string& str) const;
+
+        [[nodiscard]] std::string_view getString(const LocalizationKey& key) const noexcept
+        {
+            const auto language = currentLanguage.load(std::memory_order_acquire);
+            return language ? language->getString(key) : key.getString();
+        }
 
     private:
-        std::map<std::string, Language> languages;
-        std::map<std::string, Language>::const_iterator currentLanguage = languages.end();
+        std::map<std::string, std::unique_ptr<Language>, std::less<>> languages;
+        std::atomic<const Language*> currentLanguage{nullptr};
     };
 }
 
@@ -560,8 +560,8 @@ namespace ouzel::math
     [[nodiscard]] auto getScale(const Matrix<T, 3, 3>& matrix) noexcept
     {
         Vector<T, 2> scale;
-        scale.v[0] = Vector<T, 2>{matrix.m.v[0], matrix.m.v[1]}.length();
-        scale.v[1] = Vector<T, 2>{matrix.m.v[3], matrix.m.v[4]}.length();
+        scale.v[0] = length(Vector<T, 2>{matrix.m.v[0], matrix.m.v[1]});
+        scale.v[1] = length(Vector<T, 2>{matrix.m.v[3], matrix.m.v[4]});
 
         return scale;
     }
@@ -570,9 +570,9 @@ namespace ouzel::math
     [[nodiscard]] auto getScale(const Matrix<T, 4, 4>& matrix) noexcept
     {
         Vector<T, 3> scale;
-        scale.v[0] = Vector<T, 3>{matrix.m.v[0], matrix.m.v[1], matrix.m.v[2]}.length();
-        scale.v[1] = Vector<T, 3>{matrix.m.v[4], matrix.m.v[5], matrix.m.v[6]}.length();
-        scale.v[2] = Vector<T, 3>{matrix.m.v[8], matrix.m.v[9], matrix.m.v[10]}.length();
+        scale.v[0] = length(Vector<T, 3>{matrix.m.v[0], matrix.m.v[1], matrix.m.v[2]});
+        scale.v[1] = length(Vector<T, 3>{matrix.m.v[4], matrix.m.v[5], matrix.m.v[6]});
+        scale.v[2] = length(Vector<T, 3>{matrix.m.v[8], matrix.m.v[9], matrix.m.v[10]});
 
         return scale;
     }
@@ -612,7 +612,10 @@ namespace ouzel::math
         result.v[1] = std::copysign(result.v[1], m13 - m31);
         result.v[2] = std::copysign(result.v[2], m21 - m12);
 
-        result.normalize();
+        const auto norm = std::sqrt(result.v[0] * result.v[0] + result.v[1] * result.v[1] +
+                                    result.v[2] * result.v[2] + result.v[3] * result.v[3]);
+        if (norm > T(0))
+            for (auto& c : result.v) c /= norm;
 
         return result;
     }
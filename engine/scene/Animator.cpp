@@ -41,10 +41,10 @@ namespace ouzel::scene
                 progress = 1.0F;
                 currentTime = length;
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                AnimationEvent finishEvent;
+                finishEvent.type = Event::Type::animationFinish;
+                finishEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(finishEvent);
             }
             else
             {
@@ -63,10 +63,10 @@ namespace ouzel::scene
         engine->getEventDispatcher().addEventHandler(updateHandler);
         play();
 
-        auto startEvent = std::make_unique<AnimationEvent>();
-        startEvent->type = Event::Type::animationStart;
-        startEvent->component = this;
-        engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+        AnimationEvent startEvent;
+        startEvent.type = Event::Type::animationStart;
+        startEvent.component = this;
+        engine->getEventDispatcher().dispatchEvent(startEvent);
     }
 
     void Animator::play()
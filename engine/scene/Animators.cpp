@@ -151,10 +151,10 @@ namespace ouzel::scene
                 const float remainingTime = currentTime - animators.front()->getLength() * static_cast<float>(currentCount);
                 animators.front()->setProgress(remainingTime / animators.front()->getLength());
 
-                auto resetEvent = std::make_unique<AnimationEvent>();
-                resetEvent->type = Event::Type::animationReset;
-                resetEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                AnimationEvent resetEvent;
+                resetEvent.type = Event::Type::animationReset;
+                resetEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(resetEvent);
             }
             else
             {
@@ -163,10 +163,10 @@ namespace ouzel::scene
                 currentTime = length;
                 progress = 1.0F;
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                AnimationEvent finishEvent;
+                finishEvent.type = Event::Type::animationFinish;
+                finishEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(finishEvent);
             }
         }
     }
@@ -128,10 +128,10 @@ namespace ouzel::scene
                 active = false;
                 updateHandler.remove();
 
-                auto finishEvent = std::make_unique<AnimationEvent>();
-                finishEvent->type = Event::Type::animationFinish;
-                finishEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                AnimationEvent finishEvent;
+                finishEvent.type = Event::Type::animationFinish;
+                finishEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(finishEvent);
 
                 return;
             }
@@ -262,10 +262,10 @@ namespace ouzel::scene
 
             if (particleCount == 0)
             {
-                auto startEvent = std::make_unique<AnimationEvent>();
-                startEvent->type = Event::Type::animationStart;
-                startEvent->component = this;
-                engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+                AnimationEvent startEvent;
+                startEvent.type = Event::Type::animationStart;
+                startEvent.component = this;
+                engine->getEventDispatcher().dispatchEvent(startEvent);
             }
         }
     }
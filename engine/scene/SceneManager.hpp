@@ -9,6 +9,7 @@
 namespace ouzel::scene
 {
     class Scene;
+    struct QuadIndexBuffer;
 
     class SceneManager final
     {
@@ -38,7 +39,11 @@ namespace ouzel::scene
 
         void calculateProjection();
 
+        // shared by the text renderers of the engine, released with the last of them
+        auto& getQuadIndexBuffer() noexcept { return quadIndexBuffer; }
+
     private:
+        std::weak_ptr<QuadIndexBuffer> quadIndexBuffer;
         std::vector<Scene*> scenes;
         std::vector<std::unique_ptr<Scene>> ownedScenes;
     };
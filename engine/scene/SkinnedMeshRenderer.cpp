@@ -1,10 +1,59 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include "SkinnedMeshRenderer.hpp"
 #include "../core/Engine.hpp"
+#include "../utils/Utils.hpp"
 
 namespace ouzel::scene
 {
+    SkinnedMeshData::SkinnedMeshData(const math::Box<float, 3>& initBoundingBox,
+                                     const std::vector<std::uint32_t>& indices,
+                                     const std::vector<graphics::Vertex>& vertices,
+                                     const std::shared_ptr<graphics::Material>& initMaterial):
+        boundingBox{initBoundingBox},
+        material{initMaterial}
+    {
+        indexCount = static_cast<std::uint32_t>(indices.size());
+
+        // 16-bit indices are used if all of the vertices can be addressed with them
+        if (vertices.size() <= std::numeric_limits<std::uint16_t>::max() + 1U)
+        {
+            indexSize = sizeof(std::uint16_t);
+
+            std::vector<std::uint16_t> convertedIndices;
+            convertedIndices.reserve(indices.size());
+
+            for (const auto index : indices)
+                convertedIndices.push_back(static_cast<std::uint16_t>(index));
+
+            indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                           graphics::BufferType::index,
+                                           graphics::Flags::none,
+                                           convertedIndices.data(),
+                                           static_cast<std::uint32_t>(getVectorSize(convertedIndices)));
+        }
+        else
+        {
+            indexSize = sizeof(std::uint32_t);
+
+            indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                           graphics::BufferType::index,
+                                           graphics::Flags::none,
+                                           indices.data(),
+                                           static_cast<std::uint32_t>(getVectorSize(indices)));
+        }
+
+        vertexBuffer = graphics::Buffer(engine->getGraphics(),
+                                        graphics::BufferType::vertex,
+                                        graphics::Flags::none,
+                                        vertices.data(),
+                                        static_cast<std::uint32_t>(getVectorSize(vertices)));
+    }
+
     SkinnedMeshRenderer::SkinnedMeshRenderer()
     {
     }
@@ -18,6 +67,210 @@ namespace ouzel::scene
     {
         boundingBox = meshData.boundingBox;
         material = meshData.material;
+        indexCount = meshData.indexCount;
+        indexSize = meshData.indexSize;
+        indexBuffer = &meshData.indexBuffer;
+        vertexBuffer = &meshData.vertexBuffer;
+        mesh = &meshData;
+
+        pose.clear();
+        boneMatrices.clear();
+        skinnedVertices.clear();
+        skinnedVertexBuffer = graphics::Buffer{};
+
+        // meshes without bone weights are drawn from the shared vertex buffer
+        if (!meshData.bones.empty() &&
+            !meshData.bindPoseVertices.empty() &&
+            meshData.boneWeights.size() == meshData.bindPoseVertices.size())
+        {
+            pose.resize(meshData.bones.size());
+            boneMatrices.resize(meshData.bones.size());
+            skinnedVertices = meshData.bindPoseVertices;
+            skinnedVertexBuffer = graphics::Buffer{engine->getGraphics(),
+                                                   graphics::BufferType::vertex,
+                                                   graphics::Flags::dynamic,
+                                                   skinnedVertices.data(),
+                                                   static_cast<std::uint32_t>(getVectorSize(skinnedVertices))};
+            resetPose();
+        }
+    }
+
+    void SkinnedMeshRenderer::setBoneTransform(std::size_t bone,
+                                               const math::Vector<float, 3>& position,
+                                               const math::Quaternion<float>& rotation,
+                                               const math::Vector<float, 3>& scale)
+    {
+        if (bone >= pose.size())
+            throw std::runtime_error{"Invalid bone"};
+
+        pose[bone].position = position;
+        pose[bone].rotation = rotation;
+        pose[bone].scale = scale;
+        poseDirty = true;
+    }
+
+    void SkinnedMeshRenderer::resetPose()
+    {
+        for (std::size_t i = 0; i < pose.size(); ++i)
+        {
+            pose[i].position = mesh->bones[i].position;
+            pose[i].rotation = mesh->bones[i].rotation;
+            pose[i].scale = mesh->bones[i].scale;
+        }
+
+        poseDirty = true;
+    }
+
+    void SkinnedMeshRenderer::animate(const SkinnedMeshData::Animation& animation, float time)
+    {
+        using Channel = SkinnedMeshData::Animation::Channel;
+
+        for (const auto& channel : animation.channels)
+        {
+            if (channel.bone >= pose.size() || channel.times.empty()) continue;
+
+            const std::size_t components = channel.path == Channel::Path::rotation ? 4 : 3;
+            // cubic spline keys are stored as in-tangent, value and out-tangent
+            const std::size_t stride = channel.interpolation == Channel::Interpolation::cubicSpline ? components * 3 : components;
+            const std::size_t valueOffset = channel.interpolation == Channel::Interpolation::cubicSpline ? components : 0;
+
+            if (channel.values.size() < channel.times.size() * stride) continue;
+
+            const auto next = static_cast<std::size_t>(std::upper_bound(channel.times.begin(), channel.times.end(), time) - channel.times.begin());
+            const auto key = next == 0 ? 0 : next - 1;
+
+            std::array<float, 4> result{};
+            const auto keyValue = &channel.values[key * stride + valueOffset];
+            std::copy(keyValue, keyValue + components, result.begin());
+
+            if (next != 0 && next < channel.times.size() && channel.interpolation != Channel::Interpolation::step)
+            {
+                const auto delta = channel.times[next] - channel.times[key];
+                const auto t = delta > 0.0F ? (time - channel.times[key]) / delta : 0.0F;
+                const auto nextValue = &channel.values[next * stride + valueOffset];
+
+                if (channel.interpolation == Channel::Interpolation::linear)
+                {
+                    // the shorter way around for the rotations
+                    float sign = 1.0F;
+                    if (channel.path == Channel::Path::rotation)
+                    {
+                        float dot = 0.0F;
+                        for (std::size_t c = 0; c < components; ++c)
+                            dot += keyValue[c] * nextValue[c];
+                        if (dot < 0.0F) sign = -1.0F;
+                    }
+
+                    for (std::size_t c = 0; c < components; ++c)
+                        result[c] = keyValue[c] * (1.0F - t) + nextValue[c] * sign * t;
+                }
+                else
+                {
+                    const auto t2 = t * t;
+                    const auto t3 = t2 * t;
+                    const auto outTangent = &channel.values[key * stride + components * 2];
+                    const auto inTangent = &channel.values[next * stride];
+
+                    for (std::size_t c = 0; c < components; ++c)
+                        result[c] = (2.0F * t3 - 3.0F * t2 + 1.0F) * keyValue[c] +
+                            (t3 - 2.0F * t2 + t) * delta * outTangent[c] +
+                            (-2.0F * t3 + 3.0F * t2) * nextValue[c] +
+                            (t3 - t2) * delta * inTangent[c];
+                }
+            }
+
+            auto& bonePose = pose[channel.bone];
+            switch (channel.path)
+            {
+                case Channel::Path::translation:
+                    bonePose.position = math::Vector<float, 3>{result[0], result[1], result[2]};
+                    break;
+                case Channel::Path::rotation:
+                {
+                    const auto length = std::sqrt(result[0] * result[0] + result[1] * result[1] +
+                                                  result[2] * result[2] + result[3] * result[3]);
+                    if (length > std::numeric_limits<float>::epsilon())
+                        bonePose.rotation = math::Quaternion<float>{result[0] / length, result[1] / length,
+                                                                    result[2] / length, result[3] / length};
+                    break;
+                }
+                case Channel::Path::scale:
+                    bonePose.scale = math::Vector<float, 3>{result[0], result[1], result[2]};
+                    break;
+            }
+        }
+
+        poseDirty = true;
+    }
+
+    void SkinnedMeshRenderer::updateSkin()
+    {
+        const auto& bones = mesh->bones;
+
+        // the parents are not necessarily listed before their children
+        std::vector<math::Matrix<float, 4>> worldMatrices(bones.size());
+        std::vector<bool> resolved(bones.size(), false);
+
+        const auto resolve = [&](std::size_t i, const auto& self) -> const math::Matrix<float, 4>& {
+            if (resolved[i]) return worldMatrices[i];
+
+            math::Matrix<float, 4> translation;
+            math::setTranslation(translation, pose[i].position);
+            math::Matrix<float, 4> rotation;
+            math::setRotation(rotation, pose[i].rotation);
+            math::Matrix<float, 4> scale;
+            math::setScale(scale, pose[i].scale);
+
+            const auto local = translation * rotation * scale;
+            const auto parent = bones[i].parent;
+            worldMatrices[i] = parent ?
+                self(static_cast<std::size_t>(parent - bones.data()), self) * local :
+                local;
+            resolved[i] = true;
+            return worldMatrices[i];
+        };
+
+        for (std::size_t i = 0; i < bones.size(); ++i)
+            boneMatrices[i] = resolve(i, resolve) * bones[i].inverseBindMatrix;
+
+        for (std::size_t i = 0; i < skinnedVertices.size(); ++i)
+        {
+            const auto& source = mesh->bindPoseVertices[i];
+            const auto& boneWeights = mesh->boneWeights[i];
+
+            math::Vector<float, 3> position{};
+            math::Vector<float, 3> normal{};
+            float totalWeight = 0.0F;
+
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                const auto weight = boneWeights.weights[j];
+                if (weight == 0.0F || boneWeights.bones[j] >= boneMatrices.size()) continue;
+
+                const auto& matrix = boneMatrices[boneWeights.bones[j]];
+
+                auto bonePosition = source.position;
+                math::transformPoint(matrix, bonePosition);
+                auto boneNormal = source.normal;
+                math::transformVector(matrix, boneNormal);
+
+                position += bonePosition * weight;
+                normal += boneNormal * weight;
+                totalWeight += weight;
+            }
+
+            // unweighted vertices stay in the bind pose
+            if (totalWeight <= 0.0F) continue;
+
+            skinnedVertices[i].position = position / totalWeight;
+            const auto normalLength = std::sqrt(normal.v[0] * normal.v[0] + normal.v[1] * normal.v[1] + normal.v[2] * normal.v[2]);
+            if (normalLength > std::numeric_limits<float>::epsilon())
+                skinnedVertices[i].normal = normal / normalLength;
+        }
+
+        skinnedVertexBuffer.setData(skinnedVertices.data(),
+                                    static_cast<std::uint32_t>(getVectorSize(skinnedVertices)));
+        poseDirty = false;
     }
 
     void SkinnedMeshRenderer::draw(const math::Matrix<float, 4>& transformMatrix,
@@ -29,5 +282,40 @@ namespace ouzel::scene
                         opacity,
                         renderViewProjection,
                         wireframe);
+
+        if (!material || !indexBuffer || indexCount == 0) return;
+
+        if (poseDirty) updateSkin();
+
+        const auto modelViewProj = renderViewProjection * transformMatrix;
+        const auto colorVector = {
+            material->diffuseColor.normR(),
+            material->diffuseColor.normG(),
+            material->diffuseColor.normB(),
+            material->diffuseColor.normA() * opacity * material->opacity
+        };
+
+        std::vector<std::vector<float>> fragmentShaderConstants(1);
+        fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
+
+        std::vector<std::vector<float>> vertexShaderConstants(1);
+        vertexShaderConstants[0] = {std::begin(modelViewProj.m.v), std::end(modelViewProj.m.v)};
+
+        std::vector<std::size_t> textures;
+        for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
+            textures.push_back(texture ? texture->getResource() : 0);
+
+        engine->getGraphics().setPipelineState(material->blendState->getResource(),
+                                               material->shader->getResource(),
+                                               material->cullMode,
+                                               wireframe ? graphics::FillMode::wireframe : graphics::FillMode::solid);
+        engine->getGraphics().setShaderConstants(fragmentShaderConstants, vertexShaderConstants);
+        engine->getGraphics().setTextures(textures);
+        engine->getGraphics().draw(indexBuffer->getResource(),
+                                   indexCount,
+                                   indexSize,
+                                   pose.empty() ? vertexBuffer->getResource() : skinnedVertexBuffer.getResource(),
+                                   graphics::DrawMode::triangleList,
+                                   0);
     }
 }
@@ -3,10 +3,16 @@
 #ifndef OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 #define OUZEL_SCENE_SKINNEDMESHRENDERER_HPP
 
+#include <array>
 #include <memory>
+#include <string>
 #include <vector>
 #include "Component.hpp"
+#include "../graphics/Buffer.hpp"
 #include "../graphics/Material.hpp"
+#include "../graphics/Vertex.hpp"
+#include "../math/Matrix.hpp"
+#include "../math/Quaternion.hpp"
 
 namespace ouzel::scene
 {
@@ -18,6 +24,44 @@ namespace ouzel::scene
             Bone* parent = nullptr;
             math::Vector<float, 3> position{};
             math::Quaternion<float> rotation = math::identityQuaternion<float>;
+            math::Vector<float, 3> scale{1.0F, 1.0F, 1.0F};
+            math::Matrix<float, 4> inverseBindMatrix = math::identityMatrix<float, 4>;
+        };
+
+        // up to four bones that influence a vertex
+        struct BoneWeights final
+        {
+            std::array<std::uint16_t, 4> bones{};
+            std::array<float, 4> weights{};
+        };
+
+        struct Animation final
+        {
+            struct Channel final
+            {
+                enum class Path
+                {
+                    translation,
+                    rotation,
+                    scale
+                };
+
+                enum class Interpolation
+                {
+                    step,
+                    linear,
+                    cubicSpline
+                };
+
+                std::size_t bone = 0;
+                Path path = Path::translation;
+                Interpolation interpolation = Interpolation::linear;
+                std::vector<float> times;
+                std::vector<float> values; // three or four components per key, with tangents for cubic splines
+            };
+
+            std::string name;
+            std::vector<Channel> channels;
         };
 
         SkinnedMeshData() = default;
@@ -28,8 +72,21 @@ namespace ouzel::scene
         {
         }
 
+        SkinnedMeshData(const math::Box<float, 3>& initBoundingBox,
+                        const std::vector<std::uint32_t>& indices,
+                        const std::vector<graphics::Vertex>& vertices,
+                        const std::shared_ptr<graphics::Material>& initMaterial);
+
         math::Box<float, 3> boundingBox;
         std::shared_ptr<graphics::Material> material;
+        std::uint32_t indexCount = 0;
+        std::uint32_t indexSize = 0;
+        graphics::Buffer indexBuffer;
+        graphics::Buffer vertexBuffer;
+        std::vector<Bone> bones;
+        std::vector<BoneWeights> boneWeights; // for every vertex
+        std::vector<graphics::Vertex> bindPoseVertices; // only for the skinned meshes
+        std::vector<Animation> animations;
     };
 
     class SkinnedMeshRenderer: public Component
@@ -48,8 +105,38 @@ namespace ouzel::scene
         auto& getMaterial() const noexcept { return material; }
         void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
 
+        auto getBoneCount() const noexcept { return pose.size(); }
+        void setBoneTransform(std::size_t bone,
+                              const math::Vector<float, 3>& position,
+                              const math::Quaternion<float>& rotation,
+                              const math::Vector<float, 3>& scale);
+        void resetPose();
+
+        // samples the animation at the given time
+        void animate(const SkinnedMeshData::Animation& animation, float time);
+
     private:
+        struct BonePose final
+        {
+            math::Vector<float, 3> position{};
+            math::Quaternion<float> rotation = math::identityQuaternion<float>;
+            math::Vector<float, 3> scale{1.0F, 1.0F, 1.0F};
+        };
+
+        void updateSkin();
+
+        const SkinnedMeshData* mesh = nullptr;
         std::shared_ptr<graphics::Material> material;
+        std::uint32_t indexCount = 0;
+        std::uint32_t indexSize = 0;
+        const graphics::Buffer* indexBuffer = nullptr;
+        const graphics::Buffer* vertexBuffer = nullptr;
+
+        std::vector<BonePose> pose;
+        bool poseDirty = false;
+        std::vector<math::Matrix<float, 4>> boneMatrices;
+        std::vector<graphics::Vertex> skinnedVertices;
+        graphics::Buffer skinnedVertexBuffer;
     };
 }
 
@@ -305,22 +305,22 @@ namespace ouzel::scene
                         {
                             currentTime = std::fmod(currentTime, length);
 
-                            auto resetEvent = std::make_unique<AnimationEvent>();
-                            resetEvent->type = Event::Type::animationReset;
-                            resetEvent->component = this;
-                            resetEvent->name = currentAnimation->animation->name;
-                            engine->getEventDispatcher().dispatchEvent(std::move(resetEvent));
+                            AnimationEvent resetEvent;
+                            resetEvent.type = Event::Type::animationReset;
+                            resetEvent.component = this;
+                            resetEvent.name = currentAnimation->animation->name;
+                            engine->getEventDispatcher().dispatchEvent(resetEvent);
                             break;
                         }
                         else
                         {
                             if (running)
                             {
-                                auto finishEvent = std::make_unique<AnimationEvent>();
-                                finishEvent->type = Event::Type::animationFinish;
-                                finishEvent->component = this;
-                                finishEvent->name = currentAnimation->animation->name;
-                                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                                AnimationEvent finishEvent;
+                                finishEvent.type = Event::Type::animationFinish;
+                                finishEvent.component = this;
+                                finishEvent.name = currentAnimation->animation->name;
+                                engine->getEventDispatcher().dispatchEvent(finishEvent);
                             }
 
                             auto nextAnimation = std::next(currentAnimation);
@@ -334,11 +334,11 @@ namespace ouzel::scene
                             {
                                 currentTime -= length;
 
-                                auto startEvent = std::make_unique<AnimationEvent>();
-                                startEvent->type = Event::Type::animationStart;
-                                startEvent->component = this;
-                                startEvent->name = nextAnimation->animation->name;
-                                engine->getEventDispatcher().dispatchEvent(std::move(startEvent));
+                                AnimationEvent startEvent;
+                                startEvent.type = Event::Type::animationStart;
+                                startEvent.component = this;
+                                startEvent.name = nextAnimation->animation->name;
+                                engine->getEventDispatcher().dispatchEvent(startEvent);
                             }
                         }
                     }
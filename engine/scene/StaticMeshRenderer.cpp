@@ -1,6 +1,7 @@
 // Ouzel by Elviss Strazdins
 
 #include <limits>
+#include <stdexcept>
 #include "StaticMeshRenderer.hpp"
 #include "../core/Engine.hpp"
 #include "../utils/Utils.hpp"
@@ -8,7 +9,7 @@
 namespace ouzel::scene
 {
     StaticMeshData::StaticMeshData(const math::Box<float, 3>& initBoundingBox,
-                                   const std::vector<std::uint32_t> indices,
+                                   const std::vector<std::uint32_t>& indices,
                                    const std::vector<graphics::Vertex>& vertices,
                                    const graphics::Material* initMaterial):
         boundingBox{initBoundingBox},
@@ -53,6 +54,36 @@ namespace ouzel::scene
                                         static_cast<std::uint32_t>(getVectorSize(vertices)));
     }
 
+    StaticMeshData::StaticMeshData(const math::Box<float, 3>& initBoundingBox,
+                                   std::uint32_t initIndexSize,
+                                   Span<const std::byte> indexData,
+                                   Span<const std::byte> vertexData,
+                                   const graphics::Material* initMaterial):
+        boundingBox{initBoundingBox},
+        material{initMaterial},
+        indexSize{initIndexSize}
+    {
+        if (indexSize != sizeof(std::uint16_t) && indexSize != sizeof(std::uint32_t))
+            throw std::runtime_error{"Invalid index size"};
+
+        if (indexData.size() % indexSize != 0 || vertexData.size() % sizeof(graphics::Vertex) != 0)
+            throw std::runtime_error{"Invalid mesh data size"};
+
+        indexCount = static_cast<std::uint32_t>(indexData.size() / indexSize);
+
+        indexBuffer = graphics::Buffer(engine->getGraphics(),
+                                       graphics::BufferType::index,
+                                       graphics::Flags::none,
+                                       indexData.data(),
+                                       static_cast<std::uint32_t>(indexData.size()));
+
+        vertexBuffer = graphics::Buffer(engine->getGraphics(),
+                                        graphics::BufferType::vertex,
+                                        graphics::Flags::none,
+                                        vertexData.data(),
+                                        static_cast<std::uint32_t>(vertexData.size()));
+    }
+
     StaticMeshRenderer::StaticMeshRenderer(const StaticMeshData& meshData)
     {
         init(meshData);
@@ -8,6 +8,7 @@
 #include "../graphics/Buffer.hpp"
 #include "../graphics/Material.hpp"
 #include "../graphics/Vertex.hpp"
+#include "../utils/Span.hpp"
 
 namespace ouzel::scene
 {
@@ -16,10 +17,17 @@ namespace ouzel::scene
     public:
         StaticMeshData() = default;
         StaticMeshData(const math::Box<float, 3>& initBoundingBox,
-                       const std::vector<std::uint32_t> indices,
+                       const std::vector<std::uint32_t>& indices,
                        const std::vector<graphics::Vertex>& vertices,
                        const graphics::Material* initMaterial);
 
+        // indices and vertices that are already in the GPU layout
+        StaticMeshData(const math::Box<float, 3>& initBoundingBox,
+                       std::uint32_t initIndexSize,
+                       Span<const std::byte> indexData,
+                       Span<const std::byte> vertexData,
+                       const graphics::Material* initMaterial);
+
         math::Box<float, 3> boundingBox;
         const graphics::Material* material = nullptr;
         std::uint32_t indexCount = 0;
@@ -1,5 +1,6 @@
 // Ouzel by Elviss Strazdins
 
+#include <algorithm>
 #include "TextRenderer.hpp"
 #include "Camera.hpp"
 #include "../core/Engine.hpp"
@@ -9,6 +10,66 @@
 
 namespace ouzel::scene
 {
+    // the glyphs of all the texts are drawn with the same indices
+    struct QuadIndexBuffer final
+    {
+        explicit QuadIndexBuffer(graphics::Graphics& graphics):
+            buffer{graphics,
+                   graphics::BufferType::index,
+                   graphics::Flags::dynamic}
+        {
+        }
+
+        // the buffer only grows, so the indices of the smaller texts stay the same
+        void reserve(const std::size_t count)
+        {
+            if (count <= quadCount || quadCount == maxQuadCount) return;
+
+            auto newQuadCount = std::max(quadCount * 2, std::size_t{64});
+            while (newQuadCount < count) newQuadCount *= 2;
+            quadCount = std::min(newQuadCount, maxQuadCount);
+
+            std::vector<std::uint16_t> indices;
+            indices.reserve(quadCount * 6);
+
+            for (std::size_t i = 0; i < quadCount; ++i)
+            {
+                const auto startIndex = static_cast<std::uint16_t>(i * 4);
+                indices.insert(indices.end(), {
+                    static_cast<std::uint16_t>(startIndex + 0),
+                    static_cast<std::uint16_t>(startIndex + 1),
+                    static_cast<std::uint16_t>(startIndex + 2),
+                    static_cast<std::uint16_t>(startIndex + 1),
+                    static_cast<std::uint16_t>(startIndex + 3),
+                    static_cast<std::uint16_t>(startIndex + 2)
+                });
+            }
+
+            buffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
+        }
+
+        // 16-bit indices can address 65536 vertices
+        static constexpr std::size_t maxQuadCount = 65536 / 4;
+
+        graphics::Buffer buffer;
+        std::size_t quadCount = 0;
+    };
+
+    std::shared_ptr<QuadIndexBuffer> TextRenderer::getQuadIndexBuffer()
+    {
+        // every engine has its own buffer, created with its graphics
+        auto& sharedBuffer = engine->getSceneManager().getQuadIndexBuffer();
+
+        auto result = sharedBuffer.lock();
+        if (!result)
+        {
+            result = std::make_shared<QuadIndexBuffer>(engine->getGraphics());
+            sharedBuffer = result;
+        }
+
+        return result;
+    }
+
     TextRenderer::TextRenderer(const std::string& fontFile,
                                float initFontSize,
                                const std::string& initText,
@@ -16,9 +77,7 @@ namespace ouzel::scene
                                const math::Vector<float, 2>& initTextAnchor):
         shader{engine->getCache().getShader(shaderTexture)},
         blendState{engine->getCache().getBlendState(blendAlpha)},
-        indexBuffer{engine->getGraphics(),
-                    graphics::BufferType::index,
-                    graphics::Flags::dynamic},
+        indexBuffer{getQuadIndexBuffer()},
         vertexBuffer{engine->getGraphics(),
                      graphics::BufferType::vertex,
                      graphics::Flags::dynamic},
@@ -39,9 +98,7 @@ namespace ouzel::scene
                                const math::Vector<float, 2>& initTextAnchor):
         shader{engine->getCache().getShader(shaderTexture)},
         blendState{engine->getCache().getBlendState(blendAlpha)},
-        indexBuffer{engine->getGraphics(),
-                    graphics::BufferType::index,
-                    graphics::Flags::dynamic},
+        indexBuffer{getQuadIndexBuffer()},
         vertexBuffer{engine->getGraphics(),
                      graphics::BufferType::vertex,
                      graphics::Flags::dynamic},
@@ -66,7 +123,8 @@ namespace ouzel::scene
     {
         textAnchor = newTextAnchor;
 
-        updateText();
+        // the glyphs don't have to be laid out again
+        updateVertices();
     }
 
     void TextRenderer::setFontSize(float newFontSize)
@@ -86,9 +144,12 @@ namespace ouzel::scene
                         renderViewProjection,
                         wireframe);
 
+        const auto quadCount = std::min(vertices.size() / 4, QuadIndexBuffer::maxQuadCount);
+        if (quadCount == 0) return;
+
         if (needsMeshUpdate)
         {
-            indexBuffer.setData(indices.data(), static_cast<std::uint32_t>(getVectorSize(indices)));
+            indexBuffer->reserve(quadCount);
             vertexBuffer.setData(vertices.data(), static_cast<std::uint32_t>(getVectorSize(vertices)));
 
             needsMeshUpdate = false;
@@ -115,8 +176,8 @@ namespace ouzel::scene
         engine->getGraphics().setShaderConstants(fragmentShaderConstants,
                                                  vertexShaderConstants);
         engine->getGraphics().setTextures({wireframe ? whitePixelTexture->getResource() : texture ? texture->getResource() : 0U});
-        engine->getGraphics().draw(indexBuffer.getResource(),
-                                   static_cast<std::uint32_t>(indices.size()),
+        engine->getGraphics().draw(indexBuffer->buffer.getResource(),
+                                   static_cast<std::uint32_t>(quadCount * 6),
                                    sizeof(std::uint16_t),
                                    vertexBuffer.getResource(),
                                    graphics::DrawMode::triangleList,
@@ -125,28 +186,72 @@ namespace ouzel::scene
 
     void TextRenderer::setText(const std::string& newText)
     {
+        // only the new glyphs are laid out if the text was appended to
+        if (font && glyphRun &&
+            newText.size() > text.size() &&
+            newText.compare(0, text.size(), text) == 0)
+        {
+            if (!appendedGlyphRun)
+                appendedGlyphRun = std::make_shared<gui::GlyphRun>(*glyphRun);
+
+            const auto line = appendedGlyphRun->getCurrentLine();
+            const auto height = appendedGlyphRun->getHeight();
+
+            try
+            {
+                if (font->appendGlyphs(*appendedGlyphRun, std::string_view{newText}.substr(text.size()), fontSize))
+                {
+                    text = newText;
+                    glyphRun = appendedGlyphRun;
+
+                    // the previous lines move only if the height of the text changes
+                    if (height == glyphRun->getHeight() || textAnchor.v[1] == 1.0F)
+                        updateVertices(line);
+                    else
+                        updateVertices();
+                    return;
+                }
+            }
+            catch (...)
+            {
+                // the run might have been partially appended to
+                appendedGlyphRun.reset();
+                throw;
+            }
+        }
+
         text = newText;
 
         updateText();
     }
 
     void TextRenderer::updateText()
+    {
+        appendedGlyphRun.reset();
+        glyphRun = font ? font->getGlyphRun(text, fontSize) : nullptr;
+
+        updateVertices();
+    }
+
+    void TextRenderer::updateVertices(const std::size_t firstLine)
     {
         reset(boundingBox);
 
-        if (font)
+        if (glyphRun)
         {
-            std::tie(indices, vertices, texture) = font->getRenderData(text, math::whiteColor, fontSize, textAnchor);
-            needsMeshUpdate = true;
+            vertices.resize(glyphRun->getVertices().size());
+            glyphRun->getVertices(textAnchor, math::whiteColor, vertices.data(), firstLine);
+            texture = glyphRun->getTexture();
 
             for (const auto& vertex : vertices)
                 insertPoint(boundingBox, vertex.position);
         }
         else
         {
-            indices.clear();
             vertices.clear();
             texture.reset();
         }
+
+        needsMeshUpdate = true;
     }
 }
@@ -3,6 +3,7 @@
 #ifndef OUZEL_SCENE_TEXTRENDERER_HPP
 #define OUZEL_SCENE_TEXTRENDERER_HPP
 
+#include <memory>
 #include <string>
 #include "Component.hpp"
 #include "../graphics/BlendState.hpp"
@@ -14,6 +15,8 @@
 
 namespace ouzel::scene
 {
+    struct QuadIndexBuffer;
+
     class TextRenderer: public Component
     {
     public:
@@ -64,12 +67,15 @@ namespace ouzel::scene
         }
 
     private:
+        static std::shared_ptr<QuadIndexBuffer> getQuadIndexBuffer();
+
         void updateText();
+        void updateVertices(std::size_t firstLine = 0);
 
         const graphics::Shader* shader = nullptr;
         const graphics::BlendState* blendState = nullptr;
 
-        graphics::Buffer indexBuffer;
+        std::shared_ptr<QuadIndexBuffer> indexBuffer;
         graphics::Buffer vertexBuffer;
 
         std::shared_ptr<graphics::Texture> texture;
@@ -80,7 +86,8 @@ namespace ouzel::scene
         float fontSize = 1.0F;
         math::Vector<float, 2> textAnchor{};
 
-        std::vector<std::uint16_t> indices;
+        std::shared_ptr<const gui::GlyphRun> glyphRun; // shared with the texts with the same string
+        std::shared_ptr<gui::GlyphRun> appendedGlyphRun; // owned by the renderer after text was appended
         std::vector<graphics::Vertex> vertices;
 
         math::Color color = math::whiteColor;
@@ -3,95 +3,146 @@
 #ifndef OUZEL_STORAGE_ARCHIVE_HPP
 #define OUZEL_STORAGE_ARCHIVE_HPP
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <fstream>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
+#include "Inflate.hpp"
+#include "MappedFile.hpp"
 #include "Path.hpp"
 #include "../utils/Utils.hpp"
 
 namespace ouzel::storage
 {
+    // ZIP archive with stored and deflated files
+    // the archive is immutable after it is opened, so files can be read from multiple threads
     class Archive final
     {
     public:
         Archive() = default;
 
         explicit Archive(const Path& path):
-            file{path, std::ios::binary}
+            Archive{MappedFile{path}}
         {
-            constexpr std::uint32_t centralDirectory = 0x02014B50U;
-            constexpr std::uint32_t headerSignature = 0x04034B50U;
+        }
 
-            for (;;)
-            {
-                std::uint8_t signatureData[4];
-                file.read(reinterpret_cast<char*>(signatureData), sizeof(signatureData));
+        explicit Archive(MappedFile initFile):
+            file{std::make_shared<const MappedFile>(std::move(initFile))}
+        {
+            constexpr std::uint32_t endOfCentralDirectorySignature = 0x06054B50U;
+            constexpr std::uint32_t centralDirectorySignature = 0x02014B50U;
+            constexpr std::size_t endOfCentralDirectorySize = 22;
+            constexpr std::size_t centralDirectoryHeaderSize = 46;
+            constexpr std::size_t maxCommentSize = 0xFFFF;
 
-                if (decodeLittleEndian<std::uint32_t>(signatureData) == centralDirectory)
-                    break;
+            const auto data = file->getData();
+            const auto size = file->getSize();
 
-                if (decodeLittleEndian<std::uint32_t>(signatureData) != headerSignature)
-                    throw std::runtime_error{"Bad signature"};
+            if (size < endOfCentralDirectorySize)
+                throw std::runtime_error{"Invalid archive"};
 
-                file.seekg(2, std::ios::cur); // skip version
-                file.seekg(2, std::ios::cur); // skip flags
+            // the end of central directory record is followed by a comment of up to 64 KiB
+            const auto searchEnd = size > endOfCentralDirectorySize + maxCommentSize ?
+                size - endOfCentralDirectorySize - maxCommentSize : 0;
 
-                std::uint8_t compressionData[2];
-                file.read(reinterpret_cast<char*>(&compressionData), sizeof(compressionData));
+            auto endOfCentralDirectory = size - endOfCentralDirectorySize;
+            while (decodeLittleEndian<std::uint32_t>(data + endOfCentralDirectory) != endOfCentralDirectorySignature)
+            {
+                if (endOfCentralDirectory == searchEnd)
+                    throw std::runtime_error{"End of central directory not found"};
 
-                if (decodeLittleEndian<std::uint16_t>(compressionData) != 0x00)
-                    throw std::runtime_error{"Unsupported compression"};
+                --endOfCentralDirectory;
+            }
 
-                file.seekg(2, std::ios::cur); // skip modification time
-                file.seekg(2, std::ios::cur); // skip modification date
-                file.seekg(4, std::ios::cur); // skip CRC-32
+            const auto endRecord = data + endOfCentralDirectory;
+            const std::size_t entryCount = decodeLittleEndian<std::uint16_t>(endRecord + 10);
+            const std::size_t centralDirectorySize = decodeLittleEndian<std::uint32_t>(endRecord + 12);
+            const std::size_t centralDirectoryOffset = decodeLittleEndian<std::uint32_t>(endRecord + 16);
 
-                std::uint8_t compressedSizeData[4];
-                file.read(reinterpret_cast<char*>(compressedSizeData), sizeof(compressedSizeData));
+            if (entryCount == 0xFFFF || centralDirectoryOffset == 0xFFFFFFFFU)
+                throw std::runtime_error{"ZIP64 archives are not supported"};
 
-                std::uint8_t uncompressedSizeData[4];
-                file.read(reinterpret_cast<char*>(uncompressedSizeData), sizeof(uncompressedSizeData));
-                const std::size_t uncompressedSize = decodeLittleEndian<std::uint32_t>(uncompressedSizeData);
+            if (centralDirectoryOffset > endOfCentralDirectory ||
+                centralDirectorySize > endOfCentralDirectory - centralDirectoryOffset)
+                throw std::runtime_error{"Invalid central directory"};
+
+            const auto centralDirectoryEnd = centralDirectoryOffset + centralDirectorySize;
+            auto offset = centralDirectoryOffset;
+
+            for (std::size_t i = 0; i < entryCount; ++i)
+            {
+                if (centralDirectoryEnd - offset < centralDirectoryHeaderSize)
+                    throw std::runtime_error{"Invalid central directory"};
+
+                const auto header = data + offset;
+                if (decodeLittleEndian<std::uint32_t>(header) != centralDirectorySignature)
+                    throw std::runtime_error{"Bad signature"};
 
-                std::uint8_t fileNameLengthData[2];
-                file.read(reinterpret_cast<char*>(fileNameLengthData), sizeof(fileNameLengthData));
-                const std::size_t fileNameLength = decodeLittleEndian<std::uint16_t>(fileNameLengthData);
+                const std::size_t fileNameLength = decodeLittleEndian<std::uint16_t>(header + 28);
+                const std::size_t extraFieldLength = decodeLittleEndian<std::uint16_t>(header + 30);
+                const std::size_t commentLength = decodeLittleEndian<std::uint16_t>(header + 32);
+                const auto headerSize = centralDirectoryHeaderSize + fileNameLength + extraFieldLength + commentLength;
 
-                std::uint8_t extraFieldLengthData[2];
-                file.read(reinterpret_cast<char*>(extraFieldLengthData), sizeof(extraFieldLengthData));
-                const std::size_t extraFieldLength = decodeLittleEndian<std::uint16_t>(extraFieldLengthData);
+                if (centralDirectoryEnd - offset < headerSize)
+                    throw std::runtime_error{"Invalid central directory"};
 
-                const auto name = std::make_unique<char[]>(fileNameLength + 1); // +1 for null character
+                Entry entry;
+                entry.flags = decodeLittleEndian<std::uint16_t>(header + 8);
+                entry.compression = decodeLittleEndian<std::uint16_t>(header + 10);
+                entry.crc = decodeLittleEndian<std::uint32_t>(header + 16);
+                entry.compressedSize = decodeLittleEndian<std::uint32_t>(header + 20);
+                entry.size = decodeLittleEndian<std::uint32_t>(header + 24);
+                entry.headerOffset = decodeLittleEndian<std::uint32_t>(header + 42);
 
-                file.read(name.get(), static_cast<std::streamsize>(fileNameLength));
+                if (entry.compressedSize == 0xFFFFFFFFU ||
+                    entry.size == 0xFFFFFFFFU ||
+                    entry.headerOffset == 0xFFFFFFFFU)
+                    throw std::runtime_error{"ZIP64 archives are not supported"};
 
-                file.seekg(static_cast<std::streamoff>(extraFieldLength),
-                           std::ios::cur); // skip extra field
+                std::string name(reinterpret_cast<const char*>(header + centralDirectoryHeaderSize), fileNameLength);
 
-                entries[name.get()] = {file.tellg(), uncompressedSize};
+                // skip directories
+                if (!name.empty() && name.back() != '/')
+                    entries[std::move(name)] = entry;
 
-                file.seekg(static_cast<std::streamoff>(uncompressedSize),
-                           std::ios::cur); // skip uncompressed size
+                offset += headerSize;
             }
         }
 
-        std::vector<std::byte> readFile(std::string_view filename)
+        std::vector<std::byte> readFile(std::string_view filename) const
         {
-            if (const auto i = entries.find(filename); i != entries.end())
-            {
-                file.seekg(i->second.offset, std::ios::beg);
+            const auto& entry = getEntry(filename);
+            const auto compressedData = getData(entry);
+
+            std::vector<std::byte> result(entry.size);
 
-                std::vector<std::byte> data(i->second.size);
-                file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(i->second.size));
+            if (entry.compression == Compression::stored)
+                std::copy(compressedData, compressedData + entry.size, result.begin());
+            else
+            {
+                Inflater::inflate(compressedData, entry.compressedSize, result.data(), result.size());
 
-                return data;
+                if (calculateCrc(result.data(), result.size()) != entry.crc)
+                    throw std::runtime_error{"CRC mismatch"};
             }
+
+            return result;
+        }
+
+        // returns a view of the archive for stored files and decompresses deflated ones
+        MappedFile mapFile(std::string_view filename) const
+        {
+            const auto& entry = getEntry(filename);
+
+            if (entry.compression == Compression::stored)
+                return MappedFile{file, static_cast<std::size_t>(getData(entry) - file->getData()), entry.size};
             else
-                throw std::runtime_error{"File " + std::string{filename} + " does not exist"};
+                return MappedFile{readFile(filename)};
         }
 
         bool fileExists(std::string_view filename) const noexcept(false)
@@ -100,14 +151,91 @@ namespace ouzel::storage
         }
 
     private:
-        std::ifstream file;
+        struct Compression final
+        {
+            static constexpr std::uint16_t stored = 0;
+            static constexpr std::uint16_t deflated = 8;
+        };
 
         struct Entry final
         {
-            std::streamoff offset;
-            std::size_t size;
+            std::uint16_t flags = 0;
+            std::uint16_t compression = Compression::stored;
+            std::uint32_t crc = 0;
+            std::size_t compressedSize = 0;
+            std::size_t size = 0;
+            std::size_t headerOffset = 0;
         };
 
+        const Entry& getEntry(std::string_view filename) const
+        {
+            const auto i = entries.find(filename);
+            if (i == entries.end())
+                throw std::runtime_error{"File " + std::string{filename} + " does not exist"};
+
+            const auto& entry = i->second;
+
+            if (entry.flags & 0x01U)
+                throw std::runtime_error{"Encrypted files are not supported"};
+
+            if (entry.compression != Compression::stored &&
+                entry.compression != Compression::deflated)
+                throw std::runtime_error{"Unsupported compression"};
+
+            if (entry.compression == Compression::stored && entry.compressedSize != entry.size)
+                throw std::runtime_error{"Invalid file size"};
+
+            return entry;
+        }
+
+        // the data starts after the local header, whose extra field can differ from the central directory
+        const std::byte* getData(const Entry& entry) const
+        {
+            constexpr std::uint32_t localHeaderSignature = 0x04034B50U;
+            constexpr std::size_t localHeaderSize = 30;
+
+            const auto data = file->getData();
+            const auto size = file->getSize();
+
+            if (entry.headerOffset > size || size - entry.headerOffset < localHeaderSize)
+                throw std::runtime_error{"Invalid local header offset"};
+
+            const auto header = data + entry.headerOffset;
+            if (decodeLittleEndian<std::uint32_t>(header) != localHeaderSignature)
+                throw std::runtime_error{"Bad signature"};
+
+            const std::size_t fileNameLength = decodeLittleEndian<std::uint16_t>(header + 26);
+            const std::size_t extraFieldLength = decodeLittleEndian<std::uint16_t>(header + 28);
+            const auto dataOffset = entry.headerOffset + localHeaderSize + fileNameLength + extraFieldLength;
+
+            if (dataOffset > size || size - dataOffset < entry.compressedSize)
+                throw std::runtime_error{"File data out of bounds"};
+
+            return data + dataOffset;
+        }
+
+        static std::uint32_t calculateCrc(const std::byte* data, std::size_t size) noexcept
+        {
+            static const auto table = []() noexcept {
+                std::array<std::uint32_t, 256> result{};
+                for (std::uint32_t i = 0; i < 256; ++i)
+                {
+                    auto value = i;
+                    for (int bit = 0; bit < 8; ++bit)
+                        value = (value & 1U) ? (value >> 1) ^ 0xEDB88320U : value >> 1;
+                    result[i] = value;
+                }
+                return result;
+            }();
+
+            std::uint32_t crc = 0xFFFFFFFFU;
+            for (std::size_t i = 0; i < size; ++i)
+                crc = table[(crc ^ static_cast<std::uint8_t>(data[i])) & 0xFFU] ^ (crc >> 8);
+
+            return ~crc;
+        }
+
+        std::shared_ptr<const MappedFile> file;
         std::map<std::string, Entry, std::less<>> entries;
     };
 }
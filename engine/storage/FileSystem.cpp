@@ -376,6 +376,25 @@ namespace ouzel::storage
         return data;
     }
 
+    MappedFile FileSystem::mapFile(const Path& filename, const bool searchResources)
+    {
+        if (searchResources)
+        {
+            const auto& genericPath = filename.getGeneric();
+
+            for (auto& archive : archives)
+                if (archive.second.fileExists(genericPath))
+                    return archive.second.mapFile(genericPath);
+        }
+
+#ifdef __ANDROID__
+        if (!filename.isAbsolute())
+            return MappedFile{readFile(filename, searchResources)};
+#endif
+
+        return MappedFile{getPath(filename, searchResources)};
+    }
+
     bool FileSystem::resourceFileExists(const Path& filename) const
     {
         if (filename.isAbsolute())
@@ -31,6 +31,7 @@
 #  include <unistd.h>
 #endif
 #include "Archive.hpp"
+#include "MappedFile.hpp"
 #include "Path.hpp"
 
 namespace ouzel::core
@@ -249,6 +250,9 @@ namespace ouzel::storage
 
         std::vector<std::byte> readFile(const Path& filename, const bool searchResources = true);
 
+        // maps the file into memory, stored files in archives are views of the archive
+        MappedFile mapFile(const Path& filename, const bool searchResources = true);
+
         bool resourceFileExists(const Path& filename) const;
 
         Path getPath(const Path& filename, const bool searchResources = true) const
@@ -0,0 +1,382 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_STORAGE_INFLATE_HPP
+#define OUZEL_STORAGE_INFLATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace ouzel::storage
+{
+    class InflateError final: public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // Decoder of raw DEFLATE (RFC 1951) streams
+    class Inflater final
+    {
+    public:
+        // decompresses the whole stream, that must expand to exactly outputSize bytes
+        static void inflate(const std::byte* input, std::size_t inputSize,
+                            std::byte* output, std::size_t outputSize)
+        {
+            Inflater inflater{input, inputSize, output, outputSize};
+            inflater.run();
+        }
+
+    private:
+        static constexpr std::uint32_t maxBits = 15;
+        static constexpr std::uint32_t lookupBits = 9;
+
+        // canonical Huffman code with a lookup table for the codes of up to lookupBits bits
+        class Huffman final
+        {
+        public:
+            void init(const std::uint8_t* lengths, std::uint32_t symbolCount)
+            {
+                count.fill(0);
+                lookup.fill(0);
+
+                for (std::uint32_t symbol = 0; symbol < symbolCount; ++symbol)
+                    ++count[lengths[symbol]];
+
+                count[0] = 0;
+
+                std::int32_t left = 1;
+                for (std::uint32_t length = 1; length <= maxBits; ++length)
+                {
+                    left <<= 1;
+                    left -= count[length];
+                    if (left < 0)
+                        throw InflateError{"Over-subscribed Huffman code"};
+                }
+
+                std::array<std::uint16_t, maxBits + 2> offsets{};
+                for (std::uint32_t length = 1; length <= maxBits; ++length)
+                    offsets[length + 1] = static_cast<std::uint16_t>(offsets[length] + count[length]);
+
+                std::array<std::uint32_t, maxBits + 1> nextCode{};
+                std::uint32_t code = 0;
+                for (std::uint32_t length = 1; length <= maxBits; ++length)
+                {
+                    code = (code + count[length - 1]) << 1;
+                    nextCode[length] = code;
+                }
+
+                for (std::uint32_t symbol = 0; symbol < symbolCount; ++symbol)
+                {
+                    const std::uint32_t length = lengths[symbol];
+                    if (length == 0) continue;
+
+                    symbols[offsets[length]++] = static_cast<std::uint16_t>(symbol);
+
+                    if (length <= lookupBits)
+                    {
+                        // the codes are stored most significant bit first, but read least significant bit first
+                        std::uint32_t reversed = 0;
+                        for (std::uint32_t bit = 0, c = nextCode[length]; bit < length; ++bit, c >>= 1)
+                            reversed = (reversed << 1) | (c & 1U);
+
+                        for (std::uint32_t fill = reversed; fill < lookup.size(); fill += 1U << length)
+                            lookup[fill] = static_cast<std::uint16_t>((symbol << 4) | length);
+                    }
+
+                    ++nextCode[length];
+                }
+            }
+
+            std::array<std::uint16_t, maxBits + 1> count{};
+            std::array<std::uint16_t, 288> symbols{};
+            std::array<std::uint16_t, 1U << lookupBits> lookup{}; // symbol << 4 | length, 0 for longer codes
+        };
+
+        Inflater(const std::byte* initInput, std::size_t initInputSize,
+                 std::byte* initOutput, std::size_t initOutputSize) noexcept:
+            input{reinterpret_cast<const std::uint8_t*>(initInput)},
+            inputSize{initInputSize},
+            output{reinterpret_cast<std::uint8_t*>(initOutput)},
+            outputSize{initOutputSize}
+        {
+        }
+
+        void refill() noexcept
+        {
+            while (bitCount <= 56 && inputPosition < inputSize)
+            {
+                bitBuffer |= static_cast<std::uint64_t>(input[inputPosition++]) << bitCount;
+                bitCount += 8;
+            }
+        }
+
+        std::uint32_t bits(std::uint32_t count)
+        {
+            if (bitCount < count)
+            {
+                refill();
+                if (bitCount < count)
+                    throw InflateError{"Unexpected end of data"};
+            }
+
+            const auto result = static_cast<std::uint32_t>(bitBuffer & ((std::uint64_t{1} << count) - 1));
+            bitBuffer >>= count;
+            bitCount -= count;
+            return result;
+        }
+
+        std::uint32_t decode(const Huffman& huffman)
+        {
+            if (bitCount < maxBits) refill();
+
+            if (const auto entry = huffman.lookup[bitBuffer & ((1U << lookupBits) - 1)]; entry != 0)
+            {
+                const std::uint32_t length = entry & 0x0FU;
+                if (length > bitCount)
+                    throw InflateError{"Unexpected end of data"};
+
+                bitBuffer >>= length;
+                bitCount -= length;
+                return entry >> 4;
+            }
+
+            // the codes longer than the lookup table are decoded bit by bit
+            std::int32_t code = 0;
+            std::int32_t first = 0;
+            std::int32_t index = 0;
+            for (std::uint32_t length = 1; length <= maxBits; ++length)
+            {
+                code |= static_cast<std::int32_t>((bitBuffer >> (length - 1)) & 1U);
+                const std::int32_t count = huffman.count[length];
+                if (code - count < first)
+                {
+                    if (length > bitCount)
+                        throw InflateError{"Unexpected end of data"};
+
+                    bitBuffer >>= length;
+                    bitCount -= length;
+                    return huffman.symbols[static_cast<std::size_t>(index + (code - first))];
+                }
+
+                index += count;
+                first += count;
+                first <<= 1;
+                code <<= 1;
+            }
+
+            throw InflateError{"Invalid Huffman code"};
+        }
+
+        void run()
+        {
+            bool last = false;
+            while (!last)
+            {
+                last = bits(1) == 1;
+
+                switch (bits(2))
+                {
+                    case 0: stored(); break;
+                    case 1: compressed(getFixedCodes().first, getFixedCodes().second); break;
+                    case 2: dynamic(); break;
+                    default: throw InflateError{"Invalid block type"};
+                }
+            }
+
+            if (outputPosition != outputSize)
+                throw InflateError{"Unexpected end of data"};
+        }
+
+        void stored()
+        {
+            // stored blocks start at a byte boundary
+            bits(bitCount % 8);
+
+            const auto length = bits(16);
+            if (bits(16) != (~length & 0xFFFFU))
+                throw InflateError{"Invalid stored block length"};
+
+            if (length > outputSize - outputPosition)
+                throw InflateError{"Output overflow"};
+
+            auto remaining = length;
+            while (remaining > 0 && bitCount >= 8)
+            {
+                output[outputPosition++] = static_cast<std::uint8_t>(bits(8));
+                --remaining;
+            }
+
+            if (remaining > inputSize - inputPosition)
+                throw InflateError{"Unexpected end of data"};
+
+            std::memcpy(output + outputPosition, input + inputPosition, remaining);
+            inputPosition += remaining;
+            outputPosition += remaining;
+        }
+
+        void compressed(const Huffman& lengthCodes, const Huffman& distanceCodes)
+        {
+            static constexpr std::uint16_t lengthBase[] = {
+                3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+            };
+            static constexpr std::uint8_t lengthExtra[] = {
+                0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+            };
+            static constexpr std::uint16_t distanceBase[] = {
+                1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                8193, 12289, 16385, 24577
+            };
+            static constexpr std::uint8_t distanceExtra[] = {
+                0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+            };
+
+            for (;;)
+            {
+                const auto symbol = decode(lengthCodes);
+
+                if (symbol < 256)
+                {
+                    if (outputPosition == outputSize)
+                        throw InflateError{"Output overflow"};
+
+                    output[outputPosition++] = static_cast<std::uint8_t>(symbol);
+                }
+                else if (symbol == 256)
+                    return;
+                else
+                {
+                    const auto lengthIndex = symbol - 257;
+                    if (lengthIndex >= std::size(lengthBase))
+                        throw InflateError{"Invalid length code"};
+
+                    const std::size_t length = lengthBase[lengthIndex] + bits(lengthExtra[lengthIndex]);
+
+                    const auto distanceIndex = decode(distanceCodes);
+                    if (distanceIndex >= std::size(distanceBase))
+                        throw InflateError{"Invalid distance code"};
+
+                    const std::size_t distance = distanceBase[distanceIndex] + bits(distanceExtra[distanceIndex]);
+
+                    if (distance > outputPosition)
+                        throw InflateError{"Distance too far back"};
+
+                    if (length > outputSize - outputPosition)
+                        throw InflateError{"Output overflow"};
+
+                    // the source and the destination can overlap
+                    const auto* source = output + outputPosition - distance;
+                    auto* destination = output + outputPosition;
+                    for (std::size_t i = 0; i < length; ++i)
+                        destination[i] = source[i];
+
+                    outputPosition += length;
+                }
+            }
+        }
+
+        void dynamic()
+        {
+            static constexpr std::uint8_t order[19] = {
+                16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+            };
+
+            const auto lengthCount = bits(5) + 257;
+            const auto distanceCount = bits(5) + 1;
+            const auto codeCount = bits(4) + 4;
+
+            if (lengthCount > 286 || distanceCount > 30)
+                throw InflateError{"Invalid code counts"};
+
+            std::uint8_t lengths[286 + 30]{};
+
+            for (std::uint32_t i = 0; i < codeCount; ++i)
+                lengths[order[i]] = static_cast<std::uint8_t>(bits(3));
+
+            Huffman codeLengthCodes;
+            codeLengthCodes.init(lengths, 19);
+
+            for (std::uint32_t i = 0; i < lengthCount + distanceCount;)
+            {
+                const auto symbol = decode(codeLengthCodes);
+
+                if (symbol < 16)
+                    lengths[i++] = static_cast<std::uint8_t>(symbol);
+                else
+                {
+                    std::uint8_t length = 0;
+                    std::uint32_t repeat = 0;
+
+                    if (symbol == 16)
+                    {
+                        if (i == 0)
+                            throw InflateError{"Repeat without previous length"};
+
+                        length = lengths[i - 1];
+                        repeat = 3 + bits(2);
+                    }
+                    else if (symbol == 17)
+                        repeat = 3 + bits(3);
+                    else
+                        repeat = 11 + bits(7);
+
+                    if (i + repeat > lengthCount + distanceCount)
+                        throw InflateError{"Too many lengths"};
+
+                    while (repeat--) lengths[i++] = length;
+                }
+            }
+
+            if (lengths[256] == 0)
+                throw InflateError{"Missing end of block code"};
+
+            Huffman lengthCodes;
+            lengthCodes.init(lengths, lengthCount);
+
+            Huffman distanceCodes;
+            distanceCodes.init(lengths + lengthCount, distanceCount);
+
+            compressed(lengthCodes, distanceCodes);
+        }
+
+        static const std::pair<Huffman, Huffman>& getFixedCodes()
+        {
+            static const auto fixedCodes = []() {
+                std::pair<Huffman, Huffman> result;
+
+                std::uint8_t lengths[288];
+                for (std::uint32_t symbol = 0; symbol < 144; ++symbol) lengths[symbol] = 8;
+                for (std::uint32_t symbol = 144; symbol < 256; ++symbol) lengths[symbol] = 9;
+                for (std::uint32_t symbol = 256; symbol < 280; ++symbol) lengths[symbol] = 7;
+                for (std::uint32_t symbol = 280; symbol < 288; ++symbol) lengths[symbol] = 8;
+                result.first.init(lengths, 288);
+
+                for (std::uint32_t symbol = 0; symbol < 30; ++symbol) lengths[symbol] = 5;
+                result.second.init(lengths, 30);
+
+                return result;
+            }();
+
+            return fixedCodes;
+        }
+
+        const std::uint8_t* input;
+        std::size_t inputSize;
+        std::size_t inputPosition = 0;
+        std::uint64_t bitBuffer = 0;
+        std::uint32_t bitCount = 0;
+
+        std::uint8_t* output;
+        std::size_t outputSize;
+        std::size_t outputPosition = 0;
+    };
+}
+
+#endif // OUZEL_STORAGE_INFLATE_HPP
@@ -0,0 +1,193 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_STORAGE_MAPPEDFILE_HPP
+#define OUZEL_STORAGE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#  pragma push_macro("WIN32_LEAN_AND_MEAN")
+#  pragma push_macro("NOMINMAX")
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <Windows.h>
+#  pragma pop_macro("WIN32_LEAN_AND_MEAN")
+#  pragma pop_macro("NOMINMAX")
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+#include "Path.hpp"
+
+namespace ouzel::storage
+{
+    // Read-only contents of a file, memory-mapped if the file is on the file system
+    class MappedFile final
+    {
+    public:
+        MappedFile() noexcept = default;
+
+        explicit MappedFile(const Path& path)
+        {
+#ifdef _WIN32
+            const auto file = CreateFileW(path.getNative().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                          nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), "Failed to open file"};
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize))
+            {
+                const auto error = GetLastError();
+                CloseHandle(file);
+                throw std::system_error{static_cast<int>(error), std::system_category(), "Failed to get file size"};
+            }
+
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            if (size == 0)
+            {
+                CloseHandle(file);
+                return;
+            }
+
+            const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const auto mappingError = GetLastError();
+            CloseHandle(file);
+            if (!mapping)
+                throw std::system_error{static_cast<int>(mappingError), std::system_category(), "Failed to create file mapping"};
+
+            // the view keeps the mapping alive
+            const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            const auto viewError = GetLastError();
+            CloseHandle(mapping);
+            if (!view)
+                throw std::system_error{static_cast<int>(viewError), std::system_category(), "Failed to map file"};
+
+            data = static_cast<const std::byte*>(view);
+#elif defined(__unix__) || defined(__APPLE__)
+            auto fd = open(path.getNative().c_str(), O_RDONLY);
+            while (fd == -1 && errno == EINTR)
+                fd = open(path.getNative().c_str(), O_RDONLY);
+
+            if (fd == -1)
+                throw std::system_error{errno, std::system_category(), "Failed to open file"};
+
+            struct stat s;
+            if (fstat(fd, &s) == -1)
+            {
+                const auto error = errno;
+                close(fd);
+                throw std::system_error{error, std::system_category(), "Failed to get file status"};
+            }
+
+            size = static_cast<std::size_t>(s.st_size);
+            if (size == 0)
+            {
+                close(fd);
+                return;
+            }
+
+            // the mapping stays valid after the file is closed
+            const auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            const auto error = errno;
+            close(fd);
+            if (address == MAP_FAILED)
+                throw std::system_error{error, std::system_category(), "Failed to map file"};
+
+            data = static_cast<const std::byte*>(address);
+#else
+#  error "Unsupported platform"
+#endif
+            mapped = true;
+        }
+
+        // wraps data that can not be mapped, e.g. files in archives
+        explicit MappedFile(std::vector<std::byte> initBuffer) noexcept:
+            buffer{std::move(initBuffer)},
+            data{buffer.data()},
+            size{buffer.size()}
+        {
+        }
+
+        // part of another file, e.g. a stored file in a mapped archive, that is kept alive by the view
+        MappedFile(std::shared_ptr<const MappedFile> initParent,
+                   std::size_t offset, std::size_t initSize) noexcept:
+            parent{std::move(initParent)},
+            data{parent->data + offset},
+            size{initSize}
+        {
+        }
+
+        ~MappedFile()
+        {
+            unmap();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept:
+            buffer{std::move(other.buffer)},
+            parent{std::move(other.parent)},
+            data{other.data},
+            size{other.size},
+            mapped{other.mapped}
+        {
+            other.data = nullptr;
+            other.size = 0;
+            other.mapped = false;
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (&other == this) return *this;
+
+            unmap();
+            buffer = std::move(other.buffer);
+            parent = std::move(other.parent);
+            data = other.data;
+            size = other.size;
+            mapped = other.mapped;
+            other.data = nullptr;
+            other.size = 0;
+            other.mapped = false;
+
+            return *this;
+        }
+
+        auto getData() const noexcept { return data; }
+        auto getSize() const noexcept { return size; }
+        auto isMapped() const noexcept { return mapped; }
+
+    private:
+        void unmap() noexcept
+        {
+            if (!mapped) return;
+
+#ifdef _WIN32
+            UnmapViewOfFile(data);
+#elif defined(__unix__) || defined(__APPLE__)
+            munmap(const_cast<std::byte*>(data), size);
+#endif
+            mapped = false;
+        }
+
+        std::vector<std::byte> buffer;
+        std::shared_ptr<const MappedFile> parent;
+        const std::byte* data = nullptr;
+        std::size_t size = 0;
+        bool mapped = false;
+    };
+}
+
+#endif // OUZEL_STORAGE_MAPPEDFILE_HPP
@@ -102,6 +102,16 @@ namespace ouzel::thread
     private:
         std::thread t;
     };
+
+    inline namespace detail
+    {
+        inline thread_local bool workerThread = false;
+    }
+
+    // set on the threads of a worker pool, the tasks should not start threads of their own,
+    // because the workers already occupy the cores
+    inline bool isWorkerThread() noexcept { return workerThread; }
+    inline void setWorkerThread(bool newWorkerThread) noexcept { workerThread = newWorkerThread; }
 }
 
 #endif // OUZEL_THREAD_THREAD_HPP
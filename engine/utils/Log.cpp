@@ -27,10 +27,409 @@
 #  include <emscripten.h>
 #endif
 
+#include <algorithm>
+#include <cstdio>
 #include "Log.hpp"
+#include "Utils.hpp"
 
 namespace ouzel
 {
+    namespace
+    {
+        // magic and version of the binary log files
+        constexpr std::uint8_t logFileMagic[] = {'O', 'L', 'O', 'G'};
+        constexpr std::uint32_t logFileVersion = 1;
+    }
+
+    void Stream::format(std::string_view data, std::string& result)
+    {
+        const auto read = [&data](void* value, const std::size_t valueSize) noexcept {
+            if (data.size() < valueSize) return false;
+            std::memcpy(value, data.data(), valueSize);
+            data.remove_prefix(valueSize);
+            return true;
+        };
+
+        Type type;
+        while (read(&type, sizeof(type)))
+            switch (type)
+            {
+                case Type::text:
+                {
+                    std::uint32_t textSize;
+                    if (!read(&textSize, sizeof(textSize))) return;
+                    const auto text = data.substr(0, textSize);
+                    result += text;
+                    data.remove_prefix(text.size());
+                    break;
+                }
+                case Type::signedInteger:
+                {
+                    std::int64_t value;
+                    if (!read(&value, sizeof(value))) return;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Type::unsignedInteger:
+                {
+                    std::uint64_t value;
+                    if (!read(&value, sizeof(value))) return;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Type::floatingPoint:
+                {
+                    double value;
+                    if (!read(&value, sizeof(value))) return;
+                    result += std::to_string(value);
+                    break;
+                }
+                case Type::pointer:
+                {
+                    std::uint64_t value;
+                    if (!read(&value, sizeof(value))) return;
+
+                    constexpr char digits[] = "0123456789abcdef";
+                    for (std::size_t i = 0; i < sizeof(std::uintptr_t) * 2; ++i)
+                        result.push_back(digits[(value >> (sizeof(std::uintptr_t) * 2 - i - 1) * 4) & 0x0F]);
+                    break;
+                }
+                default: return;
+            }
+    }
+
+#ifndef __EMSCRIPTEN__
+    // single-producer single-consumer ring of the messages of a thread
+    class LogRing final
+    {
+    public:
+        struct Header final
+        {
+            std::int64_t time;
+            std::uint32_t size;
+            Log::Level level;
+        };
+
+        LogRing(const std::uint32_t initThreadId, const std::size_t initCapacity):
+            threadId{initThreadId},
+            capacity{initCapacity},
+            buffer{std::make_unique<char[]>(initCapacity)}
+        {
+        }
+
+        std::uint32_t getThreadId() const noexcept { return threadId; }
+
+        // the message is truncated to the capacity, returns false if the ring is full
+        bool push(const Log::Level level, const std::int64_t time, std::string_view str) noexcept
+        {
+            if (str.size() > capacity - sizeof(Header))
+                str = str.substr(0, capacity - sizeof(Header));
+
+            const auto head = writePosition.load(std::memory_order_relaxed);
+            const auto tail = readPosition.load(std::memory_order_acquire);
+            const auto size = getRecordSize(str.size());
+
+            if (capacity - (head - tail) < size)
+                return false;
+
+            const Header header{time, static_cast<std::uint32_t>(str.size()), level};
+            copyIn(head, &header, sizeof(header));
+            copyIn(head + sizeof(header), str.data(), str.size());
+
+            writePosition.store(head + size, std::memory_order_release);
+            return true;
+        }
+
+        // passes the header and the message of every queued record to the function
+        template <class Function>
+        void pop(std::string& message, Function function)
+        {
+            const auto head = writePosition.load(std::memory_order_acquire);
+            auto tail = readPosition.load(std::memory_order_relaxed);
+
+            while (tail != head)
+            {
+                Header header;
+                copyOut(tail, &header, sizeof(header));
+                message.resize(header.size);
+                copyOut(tail + sizeof(header), message.data(), header.size);
+
+                tail += getRecordSize(header.size);
+                readPosition.store(tail, std::memory_order_release);
+
+                function(header, message);
+            }
+        }
+
+        void close() noexcept { closed.store(true, std::memory_order_release); }
+        bool isClosed() const noexcept { return closed.load(std::memory_order_acquire); }
+
+    private:
+        static constexpr std::size_t getRecordSize(const std::size_t size) noexcept
+        {
+            return (sizeof(Header) + size + alignof(Header) - 1) / alignof(Header) * alignof(Header);
+        }
+
+        void copyIn(const std::size_t position, const void* data, const std::size_t size) noexcept
+        {
+            const auto offset = position % capacity;
+            const auto first = std::min(size, capacity - offset);
+            std::memcpy(buffer.get() + offset, data, first);
+            std::memcpy(buffer.get(), static_cast<const char*>(data) + first, size - first);
+        }
+
+        void copyOut(const std::size_t position, void* data, const std::size_t size) const noexcept
+        {
+            const auto offset = position % capacity;
+            const auto first = std::min(size, capacity - offset);
+            std::memcpy(data, buffer.get() + offset, first);
+            std::memcpy(static_cast<char*>(data) + first, buffer.get(), size - first);
+        }
+
+        const std::uint32_t threadId;
+        const std::size_t capacity;
+        std::unique_ptr<char[]> buffer;
+        alignas(64) std::atomic<std::size_t> writePosition{0};
+        alignas(64) std::atomic<std::size_t> readPosition{0};
+        std::atomic_bool closed{false};
+    };
+
+    namespace
+    {
+        constexpr std::size_t logRingCapacity = 128 * 1024;
+
+        std::atomic<std::uint64_t> nextLoggerId{1};
+
+        // the rings of the current thread, closed when the thread exits
+        class ThreadRings final
+        {
+        public:
+            ~ThreadRings()
+            {
+                for (const auto& [loggerId, ring] : rings)
+                    ring->close();
+            }
+
+            LogRing* find(const std::uint64_t loggerId) const noexcept
+            {
+                for (const auto& [id, ring] : rings)
+                    if (id == loggerId) return ring.get();
+                return nullptr;
+            }
+
+            void add(const std::uint64_t loggerId, const std::shared_ptr<LogRing>& ring)
+            {
+                rings.emplace_back(loggerId, ring);
+            }
+
+        private:
+            std::vector<std::pair<std::uint64_t, std::shared_ptr<LogRing>>> rings;
+        };
+    }
+
+    Logger::Logger(Log::Level initThreshold):
+        threshold{initThreshold},
+        id{nextLoggerId++},
+        thread{&Logger::run, this}
+    {
+    }
+
+    Logger::~Logger()
+    {
+        std::unique_lock lock{mutex};
+        running = false;
+        lock.unlock();
+        wakeCondition.notify_all();
+
+        thread.join();
+    }
+
+    void Logger::flush() const
+    {
+        std::unique_lock lock{mutex};
+        const auto request = ++flushRequest;
+        wake = true;
+        wakeCondition.notify_all();
+        flushCondition.wait(lock, [this, request]() noexcept { return flushed >= request || !running; });
+    }
+
+    void Logger::enqueue(const std::string_view str, const Log::Level level) const
+    {
+        thread_local ThreadRings threadRings;
+
+        auto ring = threadRings.find(id);
+        if (!ring)
+        {
+            const auto newRing = std::make_shared<LogRing>(nextThreadId++, logRingCapacity);
+            threadRings.add(id, newRing);
+
+            std::scoped_lock lock{ringMutex};
+            rings.push_back(newRing);
+            ring = newRing.get();
+        }
+
+        const auto time = getTime();
+
+        // the message is dropped if the ring is full, the logging thread never waits for the writer,
+        // which is only woken up if it is idle or the ring is full, it also wakes up periodically,
+        // so a lost notification only delays the output
+        if (!ring->push(level, time, str))
+        {
+            droppedMessages.fetch_add(1, std::memory_order_relaxed);
+            wake = true;
+            wakeCondition.notify_one();
+        }
+        else if (idle.load(std::memory_order_relaxed))
+        {
+            wake = true;
+            wakeCondition.notify_one();
+        }
+    }
+
+    void Logger::run()
+    {
+        struct Record final
+        {
+            std::int64_t time;
+            std::uint32_t threadId;
+            Log::Level level;
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        std::vector<std::shared_ptr<LogRing>> currentRings;
+        std::vector<Record> records;
+        std::string messages;
+        std::string message;
+
+        bool active = false;
+
+        for (;;)
+        {
+            std::unique_lock lock{mutex};
+
+            // the rings are polled while messages are being logged
+            if (active)
+                wakeCondition.wait_for(lock, std::chrono::milliseconds(10), [this]() noexcept {
+                    return wake.load() || !running;
+                });
+            else
+            {
+                idle = true;
+                wakeCondition.wait_for(lock, std::chrono::milliseconds(100), [this]() noexcept {
+                    return wake.load() || !running;
+                });
+                idle = false;
+            }
+
+            wake = false;
+            const auto request = flushRequest;
+            const auto stop = !running;
+            lock.unlock();
+
+            std::unique_lock ringLock{ringMutex};
+            currentRings = rings;
+
+            // the rings of the exited threads are removed once they are empty
+            rings.erase(std::remove_if(rings.begin(), rings.end(), [](const auto& ring) noexcept {
+                return ring->isClosed();
+            }), rings.end());
+            ringLock.unlock();
+
+            records.clear();
+            messages.clear();
+
+            // the values are formatted here instead of the logging threads
+            for (const auto& ring : currentRings)
+                ring->pop(message, [&records, &messages, &ring](const LogRing::Header& header, const std::string& data) {
+                    const auto offset = messages.size();
+                    Stream::format(data, messages);
+                    records.push_back(Record{header.time, ring->getThreadId(), header.level, offset, messages.size() - offset});
+                });
+
+            currentRings.clear();
+
+            // the messages of different threads are written in the order of their time
+            std::stable_sort(records.begin(), records.end(), [](const auto& a, const auto& b) noexcept {
+                return a.time < b.time;
+            });
+
+            active = !records.empty();
+
+            for (const auto& r : records)
+                output(std::string_view{messages}.substr(r.offset, r.size), r.level, r.time, r.threadId);
+
+            if (const auto dropped = droppedMessages.exchange(0, std::memory_order_relaxed); dropped > 0)
+                output(std::to_string(dropped) + " log messages were dropped because the log ring was full",
+                       Log::Level::warning, getTime(), 0);
+
+            lock.lock();
+            flushed = request;
+            lock.unlock();
+            flushCondition.notify_all();
+
+            if (stop) break;
+        }
+    }
+#else
+    Logger::Logger(Log::Level initThreshold):
+        threshold{initThreshold}
+    {
+    }
+
+    Logger::~Logger()
+    {
+    }
+
+    void Logger::flush() const
+    {
+    }
+#endif
+
+    void Logger::setLogFile(const storage::Path& path)
+    {
+        flush();
+
+        std::scoped_lock lock{fileMutex};
+
+        if (logFile.is_open()) logFile.close();
+        if (path.isEmpty()) return;
+
+        logFile.open(path, std::ios::binary | std::ios::trunc);
+        if (!logFile)
+            throw std::runtime_error{"Failed to open log file " + std::string(path)};
+
+        std::uint8_t header[sizeof(logFileMagic) + sizeof(std::uint32_t)];
+        std::copy(std::begin(logFileMagic), std::end(logFileMagic), header);
+        encodeLittleEndian<std::uint32_t>(header + sizeof(logFileMagic), logFileVersion);
+        logFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    void Logger::output(const std::string_view str, const Log::Level level,
+                        const std::int64_t time, const std::uint32_t threadId) const
+    {
+        char prefix[64];
+        const auto prefixLength = std::snprintf(prefix, sizeof(prefix), "%.3f [%u] ",
+                                                static_cast<double>(time) / 1000000000.0,
+                                                threadId);
+
+        line.assign(prefix, prefixLength > 0 ? static_cast<std::size_t>(prefixLength) : 0);
+        line += str;
+        logString(line, level);
+
+        std::scoped_lock lock{fileMutex};
+        if (!logFile.is_open()) return;
+
+        // level (1 byte), thread ID (4 bytes), time in nanoseconds (8 bytes), size (4 bytes), message
+        record.resize(1 + sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::uint32_t));
+        record[0] = static_cast<std::uint8_t>(level);
+        encodeLittleEndian<std::uint32_t>(record.data() + 1, threadId);
+        encodeLittleEndian<std::uint64_t>(record.data() + 1 + sizeof(std::uint32_t), static_cast<std::uint64_t>(time));
+        encodeLittleEndian<std::uint32_t>(record.data() + 1 + sizeof(std::uint32_t) + sizeof(std::uint64_t),
+                                          static_cast<std::uint32_t>(str.size()));
+        logFile.write(reinterpret_cast<const char*>(record.data()), static_cast<std::streamsize>(record.size()));
+        logFile.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
 #ifdef __ANDROID__
     constexpr int getPriority(Log::Level level) noexcept
     {
@@ -78,8 +477,8 @@ namespace ouzel
             case Log::Level::warning: return EM_LOG_CONSOLE | EM_LOG_WARN;
             case Log::Level::info:
             case Log::Level::all:
-                return EM_LOG_CONSOLE
-            default: return EM_LOG_CONSOLE
+                return EM_LOG_CONSOLE;
+            default: return EM_LOG_CONSOLE;
         }
     }
 #elif defined(_WIN32) && DEBUG
@@ -106,21 +505,26 @@ namespace ouzel
         syslog(getPriority(level), "%s", str.c_str());
 #elif TARGET_OS_MAC || defined(__linux__)
         const int fd = getFd(level);
-        std::vector<char> output(str.begin(), str.end());
-        output.push_back('\n');
 
-        std::size_t offset = 0;
-        while (offset < output.size())
-        {
-            auto written = write(fd, output.data() + offset, output.size() - offset);
-            while (written == -1 && errno == EINTR)
-                written = write(fd, output.data() + offset, output.size() - offset);
+        const auto writeAll = [fd](const char* data, const std::size_t size) noexcept {
+            std::size_t offset = 0;
+            while (offset < size)
+            {
+                auto written = write(fd, data + offset, size - offset);
+                while (written == -1 && errno == EINTR)
+                    written = write(fd, data + offset, size - offset);
 
-            if (written == -1)
-                return;
+                if (written == -1)
+                    return false;
 
-            offset += static_cast<std::size_t>(written);
-        }
+                offset += static_cast<std::size_t>(written);
+            }
+
+            return true;
+        };
+
+        if (writeAll(str.data(), str.size()))
+            writeAll("\n", 1);
 #elif defined(__EMSCRIPTEN__)
         emscripten_log(getFlags(level), "%s", str.c_str());
 #elif defined(_WIN32)
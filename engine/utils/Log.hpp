@@ -4,15 +4,23 @@
 #define OUZEL_UTILS_LOG_HPP
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
+#include <fstream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 #include "../math/Matrix.hpp"
 #include "../math/Quaternion.hpp"
 #include "../math/Size.hpp"
 #include "../math/Vector.hpp"
 #include "../storage/Path.hpp"
+#include "../thread/Thread.hpp"
 #include "Bit.hpp"
 
 namespace ouzel
@@ -30,60 +38,70 @@ namespace ouzel
     template<typename T>
     inline constexpr bool isContainer = IsContainer<T>::value;
 
+    // records the logged values, they are formatted to text by the writer thread
     class Stream final
     {
     public:
+        enum class Type: std::uint8_t
+        {
+            text,
+            signedInteger,
+            unsignedInteger,
+            floatingPoint,
+            pointer
+        };
+
         Stream& operator<<(const bool val)
         {
-            s += val ? "true" : "false";
+            appendText(val ? "true" : "false");
             return *this;
         }
 
         Stream& operator<<(char val)
         {
-            s += val;
+            appendText(std::string_view{&val, 1});
             return *this;
         }
 
         Stream& operator<<(const std::uint8_t val)
         {
             constexpr char digits[] = "0123456789abcdef";
-            s.push_back(digits[(val >> 4) & 0x0F]);
-            s.push_back(digits[(val >> 0) & 0x0F]);
+            const char text[] = {digits[(val >> 4) & 0x0F], digits[(val >> 0) & 0x0F]};
+            appendText(std::string_view{text, sizeof(text)});
             return *this;
         }
 
         template <typename T, std::enable_if_t<std::is_arithmetic_v<T> &&
             !std::is_same_v<T, bool> &&
+            !std::is_same_v<T, char> &&
             !std::is_same_v<T, std::uint8_t>>* = nullptr>
         Stream& operator<<(const T val)
         {
-            s += std::to_string(val);
+            if constexpr (std::is_floating_point_v<T>)
+                appendValue(Type::floatingPoint, static_cast<double>(val));
+            else if constexpr (std::is_signed_v<T>)
+                appendValue(Type::signedInteger, static_cast<std::int64_t>(val));
+            else
+                appendValue(Type::unsignedInteger, static_cast<std::uint64_t>(val));
             return *this;
         }
 
         Stream& operator<<(const std::string& val)
         {
-            s += val;
+            appendText(val);
             return *this;
         }
 
         Stream& operator<<(const char* val)
         {
-            s += val;
+            appendText(val);
             return *this;
         }
 
         template <typename T, std::enable_if_t<!std::is_same_v<T, char>>* = nullptr>
         Stream& operator<<(const T* val)
         {
-            constexpr char digits[] = "0123456789abcdef";
-
-            const auto ptrValue = bitCast<std::uintptr_t>(val);
-
-            for (std::size_t i = 0; i < sizeof(val) * 2; ++i)
-                s.push_back(digits[(ptrValue >> (sizeof(ptrValue) * 2 - i - 1) * 4) & 0x0F]);
-
+            appendValue(Type::pointer, static_cast<std::uint64_t>(bitCast<std::uintptr_t>(val)));
             return *this;
         }
 
@@ -93,7 +111,7 @@ namespace ouzel
             bool first = true;
             for (const auto& i : val)
             {
-                if (!first) s += ", ";
+                if (!first) appendText(", ");
                 first = false;
                 operator<<(i);
             }
@@ -101,10 +119,75 @@ namespace ouzel
             return *this;
         }
 
-        const auto& getString() noexcept { return s; }
+        // the recorded values, decoded by format
+        std::string_view getData() const noexcept
+        {
+            return heap.empty() ? std::string_view{buffer, size} : std::string_view{heap.data(), heap.size()};
+        }
+
+        std::string getString() const
+        {
+            std::string result;
+            format(getData(), result);
+            return result;
+        }
+
+        // appends the text of the recorded values to the result
+        static void format(std::string_view data, std::string& result);
 
     private:
-        std::string s;
+        void append(const void* data, const std::size_t dataSize)
+        {
+            const auto bytes = static_cast<const char*>(data);
+
+            if (heap.empty())
+            {
+                if (size + dataSize <= sizeof(buffer))
+                {
+                    std::memcpy(buffer + size, bytes, dataSize);
+                    size += dataSize;
+                    return;
+                }
+
+                heap.assign(buffer, buffer + size);
+            }
+
+            heap.insert(heap.end(), bytes, bytes + dataSize);
+            size += dataSize;
+        }
+
+        // consecutive texts are merged
+        void appendText(const std::string_view text)
+        {
+            if (size > 0 && lastText == size - textSize - sizeof(std::uint32_t) - 1)
+            {
+                textSize += static_cast<std::uint32_t>(text.size());
+                std::memcpy((heap.empty() ? buffer : heap.data()) + lastText + 1, &textSize, sizeof(textSize));
+            }
+            else
+            {
+                lastText = size;
+                textSize = static_cast<std::uint32_t>(text.size());
+                const auto type = Type::text;
+                append(&type, sizeof(type));
+                append(&textSize, sizeof(textSize));
+            }
+
+            append(text.data(), text.size());
+        }
+
+        template <typename T>
+        void appendValue(const Type type, const T val)
+        {
+            append(&type, sizeof(type));
+            append(&val, sizeof(val));
+        }
+
+        char buffer[256];
+        std::size_t size = 0;
+        std::vector<char> heap; // used if the values don't fit in the buffer
+        std::size_t lastText = 0;
+        std::uint32_t textSize = 0;
     };
 
     class Logger;
@@ -121,14 +204,12 @@ namespace ouzel
             all
         };
 
-        explicit Log(const Logger& initLogger, Level initLevel = Level::info):
-            logger{initLogger}, level{initLevel}
-        {
-        }
+        explicit Log(const Logger& initLogger, Level initLevel = Level::info);
 
         Log(const Log& other):
             logger{other.logger},
             level{other.level},
+            enabled{other.enabled},
             s{other.s}
         {
         }
@@ -136,9 +217,10 @@ namespace ouzel
         Log(Log&& other) noexcept:
             logger{other.logger},
             level{other.level},
+            enabled{other.enabled},
             s{std::move(other.s)}
         {
-            other.level = Level::info;
+            other.enabled = false;
         }
 
         Log& operator=(const Log& other)
@@ -146,6 +228,7 @@ namespace ouzel
             if (&other == this) return *this;
 
             level = other.level;
+            enabled = other.enabled;
             s = other.s;
 
             return *this;
@@ -156,7 +239,8 @@ namespace ouzel
             if (&other == this) return *this;
 
             level = other.level;
-            other.level = Level::info;
+            enabled = other.enabled;
+            other.enabled = false;
             s = std::move(other.s);
 
             return *this;
@@ -164,26 +248,40 @@ namespace ouzel
 
         ~Log();
 
+        // the values are not recorded if the level is disabled
         template <class T>
         Log& operator<<(T&& val)
         {
-            s << val;
+            if (enabled) s << val;
             return *this;
         }
 
     private:
         const Logger& logger;
         Level level = Level::info;
+        bool enabled = false;
         Stream s;
     };
 
+    // the messages with a higher level are removed at compile time
+#ifndef OUZEL_LOG_LEVEL
+#  ifdef DEBUG
+#    define OUZEL_LOG_LEVEL 4
+#  else
+#    define OUZEL_LOG_LEVEL 3
+#  endif
+#endif
+
+    inline constexpr Log::Level maxLogLevel = static_cast<Log::Level>(OUZEL_LOG_LEVEL);
+
+    class LogRing;
+
+    // the messages are queued to per-thread rings and written by a background thread
     class Logger final
     {
     public:
-        explicit Logger(Log::Level initThreshold = Log::Level::all):
-            threshold{initThreshold}
-        {
-        }
+        explicit Logger(Log::Level initThreshold = Log::Level::all);
+        ~Logger();
 
         Logger(const Logger&) = delete;
         Logger& operator=(const Logger&) = delete;
@@ -195,34 +293,104 @@ namespace ouzel
             return Log{*this, level};
         }
 
+        bool isEnabled(const Log::Level level) const noexcept
+        {
+            return level <= maxLogLevel && level <= threshold.load(std::memory_order_relaxed);
+        }
+
+        void setThreshold(const Log::Level newThreshold) noexcept
+        {
+            threshold = newThreshold;
+        }
+
         void log(const std::string& str, const Log::Level level = Log::Level::info) const
         {
-            if (level <= threshold && !str.empty())
+            if (isEnabled(level) && !str.empty())
             {
-#ifndef __EMSCRIPTEN__
-                std::scoped_lock lock{logMutex};
-#endif
-                logString(str, level);
+                Stream stream;
+                stream << str;
+                log(stream, level);
             }
         }
 
+        // the values of the stream are formatted by the writer thread
+        void log(const Stream& stream, const Log::Level level = Log::Level::info) const
+        {
+            if (stream.getData().empty()) return;
+#ifdef __EMSCRIPTEN__
+            std::string str;
+            Stream::format(stream.getData(), str);
+            output(str, level, getTime(), 1);
+#else
+            enqueue(stream.getData(), level);
+#endif
+        }
+
+        // blocks until all of the messages logged before the call are written
+        void flush() const;
+
+        // writes the messages also to a binary log file, an empty path closes the file
+        void setLogFile(const storage::Path& path);
+
     private:
         static void logString(const std::string& str, const Log::Level level = Log::Level::info);
 
+        // nanoseconds since the creation of the logger
+        std::int64_t getTime() const noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
+        // writes the message with the time and the thread ID to the system log and to the log file
+        void output(std::string_view str, Log::Level level, std::int64_t time, std::uint32_t threadId) const;
+
 #ifdef DEBUG
         std::atomic<Log::Level> threshold{Log::Level::all};
 #else
         std::atomic<Log::Level> threshold{Log::Level::info};
 #endif
 
+        const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        mutable std::mutex fileMutex;
+        mutable std::ofstream logFile;
+        mutable std::string line;
+        mutable std::vector<std::uint8_t> record;
+
 #ifndef __EMSCRIPTEN__
-        mutable std::mutex logMutex;
+        void enqueue(std::string_view str, Log::Level level) const;
+        void run();
+
+        const std::uint64_t id;
+
+        mutable std::mutex ringMutex;
+        mutable std::vector<std::shared_ptr<LogRing>> rings;
+        mutable std::atomic<std::uint32_t> nextThreadId{1};
+        mutable std::atomic<std::uint64_t> droppedMessages{0};
+
+        mutable std::mutex mutex;
+        mutable std::condition_variable wakeCondition;
+        mutable std::condition_variable flushCondition;
+        mutable std::atomic_bool wake{false};
+        std::atomic_bool idle{false};
+        mutable std::uint64_t flushRequest = 0;
+        std::uint64_t flushed = 0;
+        bool running = true;
+
+        thread::Thread thread;
 #endif
     };
 
+    inline Log::Log(const Logger& initLogger, Level initLevel):
+        logger{initLogger},
+        level{initLevel},
+        enabled{initLogger.isEnabled(initLevel)}
+    {
+    }
+
     inline Log::~Log()
     {
-        logger.log(s.getString(), level);
+        if (enabled) logger.log(s, level);
     }
 
     template <class T, std::size_t rows, std::size_t cols>
@@ -230,11 +398,11 @@ namespace ouzel
     {
         bool first = true;
 
-        for (const T c : val.m)
+        for (const T c : val.m.v)
         {
             if (!first) stream << ",";
             first = false;
-            log << c;
+            stream << c;
         }
 
         return stream;
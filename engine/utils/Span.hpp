@@ -0,0 +1,73 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_UTILS_SPAN_HPP
+#define OUZEL_UTILS_SPAN_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace ouzel
+{
+    // Non-owning view of a contiguous sequence, a subset of C++20 std::span
+    template <typename T>
+    class Span final
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+        using const_iterator = T*;
+
+        constexpr Span() noexcept = default;
+
+        constexpr Span(T* initData, std::size_t initSize) noexcept:
+            elements{initData}, elementCount{initSize}
+        {
+        }
+
+        template <typename Container, std::enable_if_t<
+            std::is_convertible_v<std::remove_pointer_t<decltype(std::data(std::declval<Container&>()))>(*)[], T(*)[]>
+        >* = nullptr>
+        constexpr Span(Container& container) noexcept:
+            elements{std::data(container)}, elementCount{std::size(container)}
+        {
+        }
+
+        template <typename U, std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>* = nullptr>
+        constexpr Span(const Span<U>& other) noexcept:
+            elements{other.data()}, elementCount{other.size()}
+        {
+        }
+
+        constexpr auto data() const noexcept { return elements; }
+        constexpr auto size() const noexcept { return elementCount; }
+        [[nodiscard]] constexpr bool empty() const noexcept { return elementCount == 0; }
+
+        constexpr iterator begin() const noexcept { return elements; }
+        constexpr iterator end() const noexcept { return elements + elementCount; }
+        constexpr const_iterator cbegin() const noexcept { return elements; }
+        constexpr const_iterator cend() const noexcept { return elements + elementCount; }
+
+        constexpr reference operator[](std::size_t index) const noexcept { return elements[index]; }
+
+        constexpr Span subspan(std::size_t offset, std::size_t count) const noexcept
+        {
+            return Span{elements + offset, count};
+        }
+
+        constexpr Span subspan(std::size_t offset) const noexcept
+        {
+            return Span{elements + offset, elementCount - offset};
+        }
+
+    private:
+        T* elements = nullptr;
+        std::size_t elementCount = 0;
+    };
+}
+
+#endif // OUZEL_UTILS_SPAN_HPP
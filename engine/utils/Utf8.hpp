@@ -14,49 +14,55 @@ namespace ouzel::utf8
         using std::logic_error::logic_error;
     };
 
+    // decodes the code point at the iterator and moves the iterator past it
     template <class Iterator>
-    std::u32string toUtf32(Iterator begin, Iterator end)
+    char32_t decode(Iterator& i, const Iterator end)
     {
-        std::u32string result;
+        char32_t cp = static_cast<char32_t>(*i) & 0xFF;
 
-        for (auto i = begin; i != end; ++i)
+        if (cp <= 0x7F) // length = 1
+        {
+            // do nothing
+        }
+        else if ((cp >> 5) == 0x6) // length = 2
+        {
+            if (++i == end)
+                throw ParseError{"Invalid UTF-8 string"};
+            cp = ((cp << 6) & 0x7FF) + (static_cast<char32_t>(*i) & 0x3F);
+        }
+        else if ((cp >> 4) == 0xE) // length = 3
         {
-            char32_t cp = static_cast<char32_t>(*i) & 0xFF;
+            if (++i == end)
+                throw ParseError{"Invalid UTF-8 string"};
+            cp = ((cp << 12) & 0xFFFF) + (((static_cast<char32_t>(*i) & 0xFF) << 6) & 0x0FFF);
+            if (++i == end)
+                throw ParseError{"Invalid UTF-8 string"};
+            cp += static_cast<char32_t>(*i) & 0x3F;
+        }
+        else if ((cp >> 3) == 0x1E) // length = 4
+        {
+            if (++i == end)
+                throw ParseError{"Invalid UTF-8 string"};
+            cp = ((cp << 18) & 0x1FFFFF) + (((static_cast<char32_t>(*i) & 0xFF) << 12) & 0x3FFFF);
+            if (++i == end)
+                throw ParseError{"Invalid UTF-8 string"};
+            cp += ((static_cast<char32_t>(*i) & 0xFF) << 6) & 0x0FFF;
+            if (++i == end)
+                throw ParseError{"Invalid UTF-8 string"};
+            cp += static_cast<char32_t>(*i) & 0x3F;
+        }
 
-            if (cp <= 0x7F) // length = 1
-            {
-                // do nothing
-            }
-            else if ((cp >> 5) == 0x6) // length = 2
-            {
-                if (++i == end)
-                    throw ParseError{"Invalid UTF-8 string"};
-                cp = ((cp << 6) & 0x7FF) + (static_cast<char32_t>(*i) & 0x3F);
-            }
-            else if ((cp >> 4) == 0xE) // length = 3
-            {
-                if (++i == end)
-                    throw ParseError{"Invalid UTF-8 string"};
-                cp = ((cp << 12) & 0xFFFF) + (((static_cast<char32_t>(*i) & 0xFF) << 6) & 0x0FFF);
-                if (++i == end)
-                    throw ParseError{"Invalid UTF-8 string"};
-                cp += static_cast<char32_t>(*i) & 0x3F;
-            }
-            else if ((cp >> 3) == 0x1E) // length = 4
-            {
-                if (++i == end)
-                    throw ParseError{"Invalid UTF-8 string"};
-                cp = ((cp << 18) & 0x1FFFFF) + (((static_cast<char32_t>(*i) & 0xFF) << 12) & 0x3FFFF);
-                if (++i == end)
-                    throw ParseError{"Invalid UTF-8 string"};
-                cp += ((static_cast<char32_t>(*i) & 0xFF) << 6) & 0x0FFF;
-                if (++i == end)
-                    throw ParseError{"Invalid UTF-8 string"};
-                cp += static_cast<char32_t>(*i) & 0x3F;
-            }
+        ++i;
+        return cp;
+    }
 
-            result.push_back(cp);
-        }
+    template <class Iterator>
+    std::u32string toUtf32(Iterator begin, Iterator end)
+    {
+        std::u32string result;
+
+        for (auto i = begin; i != end;)
+            result.push_back(decode(i, end));
 
         return result;
     }
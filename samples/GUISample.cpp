@@ -121,7 +121,7 @@ namespace samples
         engine->getLocalization().addLanguage("latvian", engine->getFileSystem().readFile("lv.mo"));
         engine->getLocalization().setLanguage("latvian");
 
-        label2.setText(engine->getLocalization().getString("Ouzel"));
+        label2.setText(std::string{engine->getLocalization().getString("Ouzel")});
 
         label2.setPosition(Vector<float, 2>{10.0F, 0.0F});
         layer.addChild(label2);
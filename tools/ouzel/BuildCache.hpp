@@ -0,0 +1,145 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_BUILDCACHE_HPP
+#define OUZEL_BUILDCACHE_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "formats/Json.hpp"
+#include "hash/Fnv1.hpp"
+#include "storage/FileSystem.hpp"
+#include "storage/MappedFile.hpp"
+#include "storage/Path.hpp"
+
+namespace ouzel
+{
+    // must be increased every time the exporters start to produce different output
+    constexpr std::uint32_t exporterVersion = 1;
+
+    // records the inputs of the exported resources, so that only the changed assets are exported again
+    class BuildCache final
+    {
+    public:
+        struct Entry final
+        {
+            std::string input;
+            std::string options;
+            std::uint64_t hash = 0;
+            std::uint64_t size = 0;
+            std::int64_t modifyTime = 0;
+        };
+
+        explicit BuildCache(const storage::Path& initPath):
+            path{initPath}
+        {
+            if (storage::FileSystem::getFileType(path) != storage::FileType::regular)
+                return;
+
+            try
+            {
+                std::ifstream file{path, std::ios::binary};
+                const std::vector<char> data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+                const auto j = json::parse(data);
+
+                // everything is exported again by a different version of the exporters
+                if (j["version"].as<std::uint32_t>() != exporterVersion)
+                    return;
+
+                for (const auto& entryObject : j["entries"])
+                {
+                    Entry entry;
+                    entry.input = entryObject["input"].as<std::string>();
+                    entry.options = entryObject["options"].as<std::string>();
+                    entry.hash = stringToHash(entryObject["hash"].as<std::string>());
+                    entry.size = entryObject["size"].as<std::uint64_t>();
+                    entry.modifyTime = entryObject["modifyTime"].as<std::int64_t>();
+
+                    entries[entryObject["output"].as<std::string>()] = entry;
+                }
+            }
+            catch (const std::exception&)
+            {
+                // a damaged cache only causes a full export
+                entries.clear();
+            }
+        }
+
+        const Entry* find(const std::string& output) const
+        {
+            const auto iterator = entries.find(output);
+            return iterator != entries.end() ? &iterator->second : nullptr;
+        }
+
+        void save(const std::map<std::string, Entry>& newEntries)
+        {
+            entries = newEntries;
+
+            json::Value j = json::Object{};
+            j["version"] = exporterVersion;
+            j["entries"] = json::Array{};
+
+            for (const auto& [output, entry] : entries)
+            {
+                json::Value entryObject = json::Object{};
+                entryObject["output"] = output;
+                entryObject["input"] = entry.input;
+                entryObject["options"] = entry.options;
+                entryObject["hash"] = hashToString(entry.hash);
+                entryObject["size"] = entry.size;
+                entryObject["modifyTime"] = entry.modifyTime;
+                j["entries"].pushBack(entryObject);
+            }
+
+            const auto data = json::encode(j, true);
+
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            if (!file)
+                throw std::runtime_error{"Failed to create " + std::string(path)};
+
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+    private:
+        static std::string hashToString(std::uint64_t hash)
+        {
+            char buffer[16];
+            const auto result = std::to_chars(std::begin(buffer), std::end(buffer), hash, 16);
+            return std::string(buffer, result.ptr);
+        }
+
+        static std::uint64_t stringToHash(const std::string& s)
+        {
+            std::uint64_t result = 0;
+            if (const auto [ptr, error] = std::from_chars(s.data(), s.data() + s.size(), result, 16);
+                error != std::errc{} || ptr != s.data() + s.size())
+                throw std::runtime_error{"Invalid hash"};
+            return result;
+        }
+
+        const storage::Path path;
+        std::map<std::string, Entry> entries;
+    };
+
+    inline std::uint64_t hashFile(const storage::Path& path)
+    {
+        const storage::MappedFile file{path};
+        return hash::fnv1::hashString<std::uint64_t>(std::string_view{
+            reinterpret_cast<const char*>(file.getData()),
+            file.getSize()
+        });
+    }
+
+    inline std::int64_t getModifyTime(const storage::Path& path)
+    {
+        const std::chrono::system_clock::time_point time = storage::FileSystem::getModifyTime(path);
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+}
+
+#endif // OUZEL_BUILDCACHE_HPP
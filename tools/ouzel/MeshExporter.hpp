@@ -0,0 +1,50 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_MESHEXPORTER_HPP
+#define OUZEL_MESHEXPORTER_HPP
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "formats/Obj.hpp"
+#include "formats/Omesh.hpp"
+#include "storage/Path.hpp"
+
+namespace ouzel
+{
+    // converts the OBJ meshes to precompiled meshes with 16-bit indices where they fit
+    inline void exportMesh(const storage::Path& inputPath,
+                           const storage::Path& outputPath)
+    {
+        std::ifstream inputFile{inputPath, std::ios::binary};
+        if (!inputFile)
+            throw std::runtime_error{"Failed to open " + std::string(inputPath)};
+
+        const std::vector<char> data{std::istreambuf_iterator<char>{inputFile}, std::istreambuf_iterator<char>{}};
+
+        auto content = obj::parse(reinterpret_cast<const std::byte*>(data.data()), data.size());
+
+        std::vector<omesh::Mesh> meshes;
+        meshes.reserve(content.meshes.size());
+
+        for (auto& mesh : content.meshes)
+            meshes.push_back(omesh::Mesh{
+                std::move(mesh.name),
+                std::move(mesh.material),
+                mesh.boundingBox,
+                std::move(mesh.vertices),
+                std::move(mesh.indices)
+            });
+
+        const auto result = omesh::encode(content.materialLibraries, meshes);
+
+        std::ofstream outputFile{outputPath, std::ios::binary | std::ios::trunc};
+        if (!outputFile)
+            throw std::runtime_error{"Failed to create " + std::string(outputPath)};
+
+        outputFile.write(reinterpret_cast<const char*>(result.data()), static_cast<std::streamsize>(result.size()));
+    }
+}
+
+#endif // OUZEL_MESHEXPORTER_HPP
@@ -3,11 +3,20 @@
 #ifndef OUZEL_OUZELPROJECT_HPP
 #define OUZEL_OUZELPROJECT_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <fstream>
+#include <map>
+#include <thread>
 #include "Asset.hpp"
+#include "BuildCache.hpp"
+#include "MeshExporter.hpp"
 #include "Target.hpp"
+#include "TextureExporter.hpp"
 #include "storage/FileSystem.hpp"
 #include "formats/Json.hpp"
+#include "thread/Thread.hpp"
 
 namespace ouzel
 {
@@ -58,7 +67,8 @@ namespace ouzel
             if (j.hasMember("assets"))
                 for (const auto& assetObject : j["assets"])
                 {
-                    const auto assetPath(assetsPath / assetObject["path"].as<std::string>());
+                    // relative to the assets directory
+                    const storage::Path assetPath{assetObject["path"].as<std::string>()};
                     const auto assetName = assetObject.hasMember("name") ?
                         assetObject["name"].as<std::string>() : std::string(assetPath.getStem());
 
@@ -83,29 +93,149 @@ namespace ouzel
 
         void exportAssets(const std::string& targetName) const
         {
+            const auto targetIterator = std::find_if(targets.begin(), targets.end(),
+                                                     [targetName](const auto& target) noexcept {
+                return target.name == targetName;
+            });
+
+            if (targetIterator == targets.end())
+                throw std::runtime_error{"Target not found"};
+
+            const auto directoryPath = path.getDirectory();
+            const auto resourcesPath = directoryPath / "Resources" / targetIterator->name;
+
+            // kept next to the resources of the target, so that it is not packaged with them
+            BuildCache buildCache{directoryPath / "Resources" / (targetIterator->name + ".cache")};
+
+            struct Job final
+            {
+                const Asset* asset;
+                storage::Path assetPath;
+                std::string resourceName;
+                storage::Path resourcePath;
+                BuildCache::Entry entry;
+                std::exception_ptr error;
+            };
+
+            std::vector<Job> jobs;
+
             for (const auto& asset : assets)
             {
-                const auto assetPath = assetsPath / asset.path;
+                // empty assets have no file
+                if (asset.type == Asset::Type::empty) continue;
+
+                const auto assetPath = directoryPath / assetsPath / asset.path;
 
+                if (storage::FileSystem::getFileType(assetPath) != storage::FileType::regular)
+                    throw std::runtime_error{"Asset " + std::string(assetPath) + " does not exist"};
+
+                // textures and meshes are precompiled, the other assets are loaded from their source format
                 auto resourceName = asset.path;
-                resourceName.replaceExtension("otexture");
-                const auto resourcePath = assetPath / resourceName;
+                if (asset.type == Asset::Type::texture)
+                    resourceName.replaceExtension("otexture");
+                else if (asset.type == Asset::Type::mesh)
+                    resourceName.replaceExtension("omesh");
+
+                for (const auto& job : jobs)
+                    if (job.resourceName == std::string(resourceName))
+                        throw ProjectError{"Assets " + std::string(job.asset->path) + " and " + std::string(asset.path) + " are exported to the same resource"};
+
+                BuildCache::Entry entry;
+                entry.input = std::string(asset.path);
+                entry.options = asset.type == Asset::Type::texture ? std::string("texture mipmaps=") + (asset.options.mipmaps ? "1" : "0") :
+                    asset.type == Asset::Type::mesh ? std::string("mesh") :
+                    std::string("copy");
+
+                jobs.push_back(Job{&asset, assetPath, std::string(resourceName), resourcesPath / resourceName, entry, nullptr});
+            }
 
-                const auto targetIterator = std::find_if(targets.begin(), targets.end(),
-                                                         [targetName](const auto& target) noexcept {
-                    return target.name == targetName;
-                });
+            // the unchanged files are recognized by their size and modification time, the others by their
+            // content hash, so only the assets that really changed are exported, in parallel
+            std::atomic<std::size_t> nextJob{0};
 
-                if (targetIterator == targets.end())
-                    throw std::runtime_error{"Target not found"};
+            const auto exportJobs = [&jobs, &nextJob, &buildCache]() {
+                for (auto i = nextJob++; i < jobs.size(); i = nextJob++)
+                {
+                    auto& job = jobs[i];
+
+                    try
+                    {
+                        job.entry.size = storage::FileSystem::getFileSize(job.assetPath);
+                        job.entry.modifyTime = getModifyTime(job.assetPath);
+
+                        const auto cached = buildCache.find(job.resourceName);
+                        const auto upToDate = cached &&
+                            cached->input == job.entry.input &&
+                            cached->options == job.entry.options &&
+                            storage::FileSystem::getFileType(job.resourcePath) == storage::FileType::regular;
+
+                        if (upToDate && cached->size == job.entry.size && cached->modifyTime == job.entry.modifyTime)
+                        {
+                            job.entry.hash = cached->hash;
+                            continue;
+                        }
+
+                        job.entry.hash = hashFile(job.assetPath);
+                        if (upToDate && cached->hash == job.entry.hash)
+                            continue;
+
+                        if (job.asset->type == Asset::Type::texture)
+                            exportTexture(job.assetPath, job.resourcePath, job.asset->options.mipmaps);
+                        else if (job.asset->type == Asset::Type::mesh)
+                            exportMesh(job.assetPath, job.resourcePath);
+                        else
+                            storage::FileSystem::copyFile(job.assetPath, job.resourcePath, true);
+                    }
+                    catch (...)
+                    {
+                        job.error = std::current_exception();
+                    }
+                }
+            };
+
+            // the directories are created before the workers start to write to them
+            for (const auto& job : jobs)
+                createDirectories(job.resourcePath.getDirectory());
 
-                // TODO: check if input file exists
-                // TODO: check if output file exists and is older than the input file
-                // TODO: export input file to output file
+            {
+                std::vector<thread::Thread> threads;
+                const auto threadCount = std::min(static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U)),
+                                                  jobs.size());
+
+                // the exporters do not start threads of their own while the assets are exported in parallel
+                for (std::size_t i = 1; i < threadCount; ++i)
+                    threads.emplace_back([&exportJobs]() {
+                        thread::setWorkerThread(true);
+                        exportJobs();
+                    });
+
+                thread::setWorkerThread(threadCount > 1);
+                exportJobs();
+                thread::setWorkerThread(false);
             }
+
+            // the successfully exported assets are recorded even if some of the others failed
+            std::map<std::string, BuildCache::Entry> entries;
+            for (const auto& job : jobs)
+                if (!job.error) entries[job.resourceName] = job.entry;
+
+            buildCache.save(entries);
+
+            for (const auto& job : jobs)
+                if (job.error) std::rethrow_exception(job.error);
         }
 
     private:
+        static void createDirectories(const storage::Path& directory)
+        {
+            if (directory.isEmpty() ||
+                storage::FileSystem::getFileType(directory) == storage::FileType::directory)
+                return;
+
+            createDirectories(directory.getDirectory());
+            storage::FileSystem::createDirectory(directory);
+        }
+
         const storage::Path path;
         std::string name;
         std::string identifier;
@@ -0,0 +1,64 @@
+// Ouzel by Elviss Strazdins
+
+#ifndef OUZEL_TEXTUREEXPORTER_HPP
+#define OUZEL_TEXTUREEXPORTER_HPP
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "formats/Otexture.hpp"
+#include "graphics/Mipmaps.hpp"
+#include "storage/Path.hpp"
+
+namespace ouzel
+{
+    // decodes the image and writes it with all of its mip levels as a precompiled texture
+    inline void exportTexture(const storage::Path& inputPath,
+                              const storage::Path& outputPath,
+                              bool mipmaps)
+    {
+        std::ifstream inputFile{inputPath, std::ios::binary};
+        if (!inputFile)
+            throw std::runtime_error{"Failed to open " + std::string(inputPath)};
+
+        const std::vector<char> data{std::istreambuf_iterator<char>{inputFile}, std::istreambuf_iterator<char>{}};
+
+        int width;
+        int height;
+        int comp;
+
+        // expanded to RGBA like the runtime image loader does
+        using ImageFreeFunction = void(*)(void*);
+        std::unique_ptr<stbi_uc, ImageFreeFunction> image{
+            stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data.data()),
+                                  static_cast<int>(data.size()),
+                                  &width, &height,
+                                  &comp, STBI_rgb_alpha),
+            &stbi_image_free
+        };
+
+        if (!image)
+            throw std::runtime_error{"Failed to load " + std::string(inputPath) + ", reason: " + std::string(stbi_failure_reason())};
+
+        const math::Size<std::uint32_t, 2> size{
+            static_cast<std::uint32_t>(width),
+            static_cast<std::uint32_t>(height)
+        };
+        const std::vector<std::uint8_t> pixels(image.get(), image.get() + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+
+        const auto levels = graphics::generateMipmaps(size, pixels, mipmaps ? 0 : 1,
+                                                      graphics::PixelFormat::rgba8UnsignedNorm);
+        const auto texture = otexture::encode(graphics::PixelFormat::rgba8UnsignedNorm, levels);
+
+        std::ofstream outputFile{outputPath, std::ios::binary | std::ios::trunc};
+        if (!outputFile)
+            throw std::runtime_error{"Failed to create " + std::string(outputPath)};
+
+        outputFile.write(reinterpret_cast<const char*>(texture.data()), static_cast<std::streamsize>(texture.size()));
+    }
+}
+
+#endif // OUZEL_TEXTUREEXPORTER_HPP
@@ -10,6 +10,38 @@
 #include "visualstudio/BuildSystem.hpp"
 #include "xcode/BuildSystem.hpp"
 
+#ifdef _MSC_VER
+#  pragma warning( push )
+#  pragma warning( disable : 4100 )
+#  pragma warning( disable : 4505 )
+#elif defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wconversion"
+#  pragma GCC diagnostic ignored "-Wdouble-promotion"
+#  pragma GCC diagnostic ignored "-Wold-style-cast"
+#  pragma GCC diagnostic ignored "-Wsign-conversion"
+#  pragma GCC diagnostic ignored "-Wunused-function"
+#  pragma GCC diagnostic ignored "-Wunused-parameter"
+#  ifdef __clang__
+#    pragma GCC diagnostic ignored "-Wcomma"
+#    pragma GCC diagnostic ignored "-Wmissing-prototypes"
+#  endif
+#endif
+
+#define STBI_NO_PSD
+#define STBI_NO_HDR
+#define STBI_NO_PIC
+#define STBI_NO_GIF
+#define STBI_NO_PNM
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#ifdef _MSC_VER
+#  pragma warning( pop )
+#elif defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
 enum class ProjectType
 {
     makefile,